@@ -0,0 +1,129 @@
+/*
+* File: Arena.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the pieces of the bot arena: the list of bots
+* that can play, a runner that plays one headless game to the end, and the
+* statistics gathered over a batch of games.
+*/
+
+//Redundancy safety check
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+#include "Engine.hpp"
+#include "Bot.hpp"
+#include "Autopilot.hpp"
+#include "Mcts.hpp"
+
+using namespace std;
+
+//Names accepted by makeBot
+const vector<string> BOT_NAMES = {"straight", "greedy", "autopilot", "mcts"};
+
+/*
+Creates a bot by name
+
+Params: 1 string, 1 bool
+string, name: One of BOT_NAMES
+bool, realtime: True when the bot steers a live game. Searching bots then use every core and a time budget per tick,
+                otherwise (in the arena, which already runs a game per core) one thread and a fixed amount of work per tick
+
+Returns: The bot, throws invalid_argument for unknown names
+*/
+unique_ptr<Bot> makeBot(const string &name, bool realtime=false)
+{
+  if (name == "straight") return unique_ptr<Bot>(new StraightBot);
+  if (name == "greedy") return unique_ptr<Bot>(new GreedyBot);
+  if (name == "autopilot") return unique_ptr<Bot>(new Autopilot);
+  if (name == "mcts") return unique_ptr<Bot>(realtime ? new MctsBot(0, 0.5) : new MctsBot(1, 0.5, 200));
+  throw invalid_argument("Unknown bot: " + name);
+}
+
+/*
+The ArenaResult struct holds the outcome of a single arena game
+*/
+struct ArenaResult
+{
+  size_t config_index = 0; //Which of the swept configs the game was played with
+  uint64_t seed = 0;
+  int score = 0;
+  size_t length = 0; //Length of the snake when the game ended
+  uint64_t ticks = 0; //Ticks survived
+  uint64_t game_time = 0; //Game time survived, in milliseconds
+  bool won = false;
+  bool timed_out = false; //Still alive when the tick limit was reached
+};
+
+/*
+Plays one game to the end without any display
+
+Params: 1 GameConfig, 1 Bot reference, 1 uint64_t
+GameConfig, config: The config (including the seed) of the game
+Bot, bot: The bot steering the snake
+uint64_t, max_ticks: The game is stopped after this many ticks (0 for no limit)
+
+Returns: The outcome of the game
+*/
+ArenaResult runArenaGame(const GameConfig &config, Bot &bot, uint64_t max_ticks)
+{
+  GameState game(config);
+  while (game.isAlive() && (max_ticks == 0 || game.getTick() < max_ticks)) game.step(bot.decide(game));
+
+  ArenaResult result;
+  result.seed = config.seed;
+  result.score = game.getScore();
+  result.length = game.getBody().size();
+  result.ticks = game.getTick();
+  result.game_time = game.getGameTime();
+  result.won = game.isWon();
+  result.timed_out = game.isAlive();
+  return result;
+}
+
+/*
+The Distribution struct summarizes a list of samples
+*/
+struct Distribution
+{
+  double mean = 0;
+  double min = 0;
+  double p10 = 0;
+  double median = 0;
+  double p90 = 0;
+  double max = 0;
+};
+
+/*
+Summarizes a list of samples
+
+Params: 1 double vector
+vector<double>, samples: The samples, sorted in place
+
+Returns: The mean, extremes and percentiles (nearest rank) of the samples
+*/
+Distribution summarize(vector<double> &samples)
+{
+  Distribution d;
+  if (samples.empty()) return d;
+  sort(samples.begin(), samples.end());
+  double total = 0;
+  for (double s:samples) total += s;
+  auto percentile = [&](double p) {return samples[size_t(p * (samples.size() - 1) + 0.5)];};
+  d.mean = total / samples.size();
+  d.min = samples.front();
+  d.p10 = percentile(0.1);
+  d.median = percentile(0.5);
+  d.p90 = percentile(0.9);
+  d.max = samples.back();
+  return d;
+}
+
+#endif
@@ -0,0 +1,418 @@
+/*
+* File: Autopilot.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the Autopilot bot, a planner that steers the
+* snake on its own. It follows the shortest path to the food as long as the
+* snake could still reach its own tail once it got there, chases its tail
+* when it could not, and on tight boards follows a Hamiltonian cycle (with
+* safe shortcuts) that is guaranteed to fill the whole board.
+*/
+
+//Redundancy safety check
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "Engine.hpp"
+#include "Bot.hpp"
+#include "Bitboard.hpp"
+
+using namespace std;
+
+/*
+Autopilot Class:
+  Plans on the board's cells by index (row * columns + column). Every buffer is sized once per board size and reused,
+  searches mark visited cells with a generation number instead of clearing, so deciding a move never allocates.
+
+  A planned path stays valid until the food is eaten: the snake only moves along it, so the cells ahead can't fill up.
+  The breadth-first search to the food therefore runs once per food rather than once per tick, and the ticks in between
+  only check the next cell of the path, which keeps boards of a million cells at many thousands of ticks per second.
+*/
+class Autopilot : public Bot
+{
+  public:
+    /*
+    Constructor for Autopilot
+
+    Params: 1 size_t
+    size_t, tight_cells: Boards with at most this many cells inside the border follow the Hamiltonian cycle
+    */
+    Autopilot(size_t tight_cells=4096) : tight_board_cells(tight_cells) {};
+
+    /*
+    Picks the direction for the next tick
+
+    Params: 1 GameState
+    GameState, game: The game, before the tick is run
+
+    Returns: 'w', 'a', 's' or 'd', or 0 if every move is fatal
+    */
+    char decide(const GameState &game) override
+    {
+      if (game.getRows() != rows || game.getColumns() != columns || game.getLevel().getChecksum() != level_checksum) configure(game);
+      //Nothing planned for the last game carries over into a new one
+      if (game.getTick() == 0) {
+        path_length = path_pos = 0;
+        chase_ticks = 0;
+      }
+      if (!cycle_order.empty()) return followCycle(game);
+
+      int head = cellOf(game.getBody().front());
+      //Keep following the planned path while it still leads to the current food
+      if (path_pos < path_length && game.getFood() == path_food && isNeighbor(head, path[path_pos]) && !game.occupies(pairOf(path[path_pos]))) {
+        return directionTo(head, path[path_pos++]);
+      }
+
+      path_pos = path_length = 0;
+      //After chasing its tail for as many ticks as there are cells, the board won't open up on its own, take the food regardless
+      bool require_safe = chase_ticks <= (rows - 2) * (columns - 2);
+      if (game.getFood().first >= 0 && planFoodPath(game, require_safe)) {
+        chase_ticks = 0;
+        return directionTo(head, path[path_pos++]);
+      }
+      chase_ticks++;
+      char move = chaseTail(game);
+      if (move) return move;
+      return anySafeMove(game);
+    }
+
+    //Whether the autopilot follows the Hamiltonian cycle on the board it last played
+    bool usesCycle() const {return !cycle_order.empty();}
+
+  private:
+    const size_t tight_board_cells;
+    int rows = 0;
+    int columns = 0;
+    uint32_t level_checksum = 0; //Checksum of the level the buffers were set up for
+    int offsets[4] = {0, 0, 0, 0}; //Cell index offsets of the neighbors above, left, below, right
+    const char offset_directions[4] = {'w', 'a', 's', 'd'};
+
+    vector<uint8_t> wall; //1 for cells the head can't end a tick on (border, walls and portals of the level)
+    vector<int> cycle_order; //Position of each inside cell along the Hamiltonian cycle, empty when not following it
+    int cycle_length = 0;
+
+    //Search buffers
+    vector<uint32_t> seen; //Cell was reached by the current search when equal to seen_stamp
+    uint32_t seen_stamp = 0;
+    vector<uint32_t> blocked; //Cell holds a segment of the simulated snake when equal to blocked_stamp
+    uint32_t blocked_stamp = 0;
+    vector<int> parent;
+    vector<int> distance;
+    vector<int> queue;
+    FloodFill flood; //Trap checks of the last resort moves
+
+    //The planned path to the food, path[path_pos] is the next cell to move to
+    vector<int> path;
+    size_t path_length = 0;
+    size_t path_pos = 0;
+    ipair path_food = {-1, -1};
+    int chase_ticks = 0; //Ticks in a row spent chasing the tail because no safe path to the food was found
+
+    int cellOf(ipair cell) const {return cell.first * columns + cell.second;}
+    ipair pairOf(int cell) const {return {cell / columns, cell % columns};}
+    bool isNeighbor(int a, int b) const {return b == a - columns || b == a + columns || b == a - 1 || b == a + 1;}
+
+    char directionTo(int from, int to) const
+    {
+      if (to == from - columns) return 'w';
+      if (to == from + columns) return 's';
+      if (to == from - 1) return 'a';
+      return 'd';
+    }
+
+    //Starts a new generation of marks, clearing the marks only when the generation number wraps around
+    static uint32_t nextStamp(vector<uint32_t> &marks, uint32_t &stamp)
+    {
+      if (++stamp == 0) {
+        fill(marks.begin(), marks.end(), 0);
+        stamp = 1;
+      }
+      return stamp;
+    }
+
+    //Returns true if the head can move onto the cell this tick
+    bool canEnter(const GameState &game, int cell, int moving_tail) const
+    {
+      return !wall[cell] && (cell == moving_tail || !game.occupies(pairOf(cell)));
+    }
+
+    //The tail cell if the tail moves out of it on the next tick, -1 otherwise
+    int movingTail(const GameState &game) const
+    {
+      const SnakeBody &body = game.getBody();
+      return body.size() > 1 && game.getPendingGrowth() == 0 ? cellOf(body.back()) : -1;
+    }
+
+    //Sizes the buffers for the board of a game and builds its Hamiltonian cycle if the board is tight and has no walls inside
+    void configure(const GameState &game)
+    {
+      rows = game.getRows();
+      columns = game.getColumns();
+      level_checksum = game.getLevel().getChecksum();
+      size_t cells = size_t(rows) * columns;
+      int neighbor_offsets[4] = {-columns, -1, columns, 1};
+      for (int i = 0; i < 4; i++) offsets[i] = neighbor_offsets[i];
+
+      wall.assign(cells, 0);
+      bool inner_walls = false;
+      for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < columns; c++) {
+          if (!game.isBlocked({r, c})) continue;
+          wall[r * columns + c] = 1;
+          inner_walls |= r != 0 && c != 0 && r != rows - 1 && c != columns - 1;
+        }
+      }
+      seen.assign(cells, 0);
+      blocked.assign(cells, 0);
+      seen_stamp = blocked_stamp = 0;
+      parent.assign(cells, 0);
+      distance.assign(cells, 0);
+      queue.assign(cells, 0);
+      path.assign(cells, 0);
+      path_length = path_pos = 0;
+      chase_ticks = 0;
+
+      cycle_order.clear();
+      int inside_rows = rows - 2, inside_columns = columns - 2;
+      if (!inner_walls && inside_rows >= 2 && inside_columns >= 2 && size_t(inside_rows) * inside_columns <= tight_board_cells) buildCycle(inside_rows, inside_columns);
+      return;
+    }
+
+    /*
+    Builds a Hamiltonian cycle over the cells inside the border. With an even number of rows, the rows are swept back and forth
+    leaving out the first column, which is then used to return to the start. With an odd number of rows and an even number of
+    columns the same is done with rows and columns swapped. A board with an odd number of both has no such cycle.
+    */
+    void buildCycle(int inside_rows, int inside_columns)
+    {
+      bool by_rows = inside_rows % 2 == 0;
+      if (!by_rows && inside_columns % 2 != 0) return;
+
+      cycle_order.assign(size_t(rows) * columns, -1);
+      int position = 0;
+      //Lines are the rows when sweeping by rows, the columns otherwise
+      int lines = by_rows ? inside_rows : inside_columns;
+      int line_length = by_rows ? inside_columns : inside_rows;
+      auto place = [&](int line, int along) {
+        int r = (by_rows ? line : along) + 1, c = (by_rows ? along : line) + 1;
+        cycle_order[r * columns + c] = position++;
+      };
+      for (int line = 0; line < lines; line++) {
+        if (line % 2 == 0) for (int along = 1; along < line_length; along++) place(line, along);
+        else for (int along = line_length - 1; along >= 1; along--) place(line, along);
+      }
+      for (int line = lines - 1; line >= 0; line--) place(line, 0);
+      cycle_length = position;
+      return;
+    }
+
+    /*
+    Follows the Hamiltonian cycle, taking shortcuts towards the food while the snake is short. The body always lies along the
+    cycle between the tail and the head, so any cell ahead of the head and before the tail is free: a shortcut may skip ahead
+    as long as it lands short of the food and leaves room before the tail for the growth still to come. Once the snake covers
+    half of the board it stops cutting corners and simply follows the cycle, which can never run into the body.
+    */
+    char followCycle(const GameState &game)
+    {
+      const SnakeBody &body = game.getBody();
+      int head = cellOf(body.front());
+      if (cycle_order[head] < 0) return anySafeMove(game);
+      int tail = cellOf(body.back());
+      int moving_tail = movingTail(game);
+      auto ahead = [&](int cell) {return (cycle_order[cell] - cycle_order[head] + cycle_length) % cycle_length;};
+
+      int available = body.size() == 1 ? cycle_length : ahead(tail) - game.getPendingGrowth() - 3;
+      if (body.size() * 2 > size_t(cycle_length)) available = 0;
+      ipair food = game.getFood();
+      if (food.first >= 0) available = min(available, ahead(cellOf(food)));
+
+      //The farthest cell along the cycle within reach, or failing that the nearest (the next cell of the cycle)
+      int best = -1, best_ahead = 0, nearest = -1, nearest_ahead = 0;
+      for (int i = 0; i < 4; i++) {
+        int next = head + offsets[i];
+        if (isReverseDirection(offset_directions[i], game.getDirection()) || !canEnter(game, next, moving_tail)) continue;
+        int distance_ahead = ahead(next);
+        if (distance_ahead <= available && distance_ahead > best_ahead) {
+          best = next;
+          best_ahead = distance_ahead;
+        }
+        if (nearest < 0 || distance_ahead < nearest_ahead) {
+          nearest = next;
+          nearest_ahead = distance_ahead;
+        }
+      }
+      if (best >= 0) return directionTo(head, best);
+      if (nearest >= 0) return directionTo(head, nearest);
+      return 0;
+    }
+
+    /*
+    Finds the shortest path from the head to the food with a breadth-first search, treating the body as walls except for a
+    tail that moves away. Unless require_safe is false, the path is only kept if the snake could still reach its tail after eating at the end of it.
+    */
+    bool planFoodPath(const GameState &game, bool require_safe)
+    {
+      int start = cellOf(game.getBody().front());
+      int target = cellOf(game.getFood());
+      int moving_tail = movingTail(game);
+      uint32_t stamp = nextStamp(seen, seen_stamp);
+
+      size_t front = 0, back = 0;
+      queue[back++] = start;
+      seen[start] = stamp;
+      bool found = false;
+      while (front < back && !found) {
+        int cell = queue[front++];
+        for (int i = 0; i < 4; i++) {
+          int next = cell + offsets[i];
+          if (seen[next] == stamp || !canEnter(game, next, moving_tail)) continue;
+          //The snake can't turn back on itself, even when it is a single segment long
+          if (cell == start && isReverseDirection(offset_directions[i], game.getDirection())) continue;
+          seen[next] = stamp;
+          parent[next] = cell;
+          if (next == target) {
+            found = true;
+            break;
+          }
+          queue[back++] = next;
+        }
+      }
+      if (!found) return false;
+
+      //Walk back from the food to lay the path out front to back
+      size_t length = 0;
+      for (int cell = target; cell != start; cell = parent[cell]) length++;
+      size_t i = length;
+      for (int cell = target; cell != start; cell = parent[cell]) path[--i] = cell;
+
+      if (require_safe && !tailReachableAfter(game, length)) return false;
+      path_length = length;
+      path_pos = 0;
+      path_food = game.getFood();
+      return true;
+    }
+
+    /*
+    Simulates the snake following the first steps cells of the planned path and checks that its head could then still reach
+    its tail. A snake that can reach its tail can always follow it around, so it never traps itself.
+    */
+    bool tailReachableAfter(const GameState &game, size_t steps)
+    {
+      const SnakeBody &body = game.getBody();
+      //The snake keeps its tail in place while it has growth pending, then grows by one more for the food it just ate
+      size_t length = body.size() + min(steps, size_t(game.getPendingGrowth()));
+      if (length <= 1) return true;
+
+      uint32_t mark = nextStamp(blocked, blocked_stamp);
+      //The simulated body: the path back to front, then the front of the current body
+      int tail;
+      size_t from_path = min(length, steps);
+      for (size_t i = 0; i < from_path; i++) blocked[path[steps - 1 - i]] = mark;
+      if (length > steps) {
+        size_t kept = length - steps;
+        for (size_t i = 0; i < kept; i++) blocked[cellOf(body[i])] = mark;
+        tail = cellOf(body[kept - 1]);
+      }
+      else tail = path[steps - length];
+      blocked[tail] = 0;
+
+      //Search from the simulated head, the tail stays put for the next move (it just grew) so it has to be at least 2 moves away
+      int start = path[steps - 1];
+      uint32_t stamp = nextStamp(seen, seen_stamp);
+      size_t front = 0, back = 0;
+      queue[back++] = start;
+      seen[start] = stamp;
+      while (front < back) {
+        int cell = queue[front++];
+        for (int i = 0; i < 4; i++) {
+          int next = cell + offsets[i];
+          if (seen[next] == stamp || wall[next] || blocked[next] == mark) continue;
+          if (next == tail) {
+            if (cell == start) continue;
+            return true;
+          }
+          seen[next] = stamp;
+          queue[back++] = next;
+        }
+      }
+      return false;
+    }
+
+    /*
+    Picks the move that keeps the tail reachable for the longest, used when the food can't be reached safely. Searches out
+    from the tail until every cell next to the head has been found, then moves to the one farthest from the tail.
+    */
+    char chaseTail(const GameState &game)
+    {
+      const SnakeBody &body = game.getBody();
+      if (body.size() < 2) return 0;
+      int head = cellOf(body.front());
+      int tail = cellOf(body.back());
+      int moving_tail = movingTail(game);
+
+      //Cells next to the head the snake could move to
+      int targets[4];
+      int target_count = 0;
+      for (int i = 0; i < 4; i++) {
+        int next = head + offsets[i];
+        if (!isReverseDirection(offset_directions[i], game.getDirection()) && canEnter(game, next, moving_tail)) targets[target_count++] = next;
+      }
+      if (target_count == 0) return 0;
+
+      uint32_t stamp = nextStamp(seen, seen_stamp);
+      size_t front = 0, back = 0;
+      queue[back++] = tail;
+      seen[tail] = stamp;
+      distance[tail] = 0;
+      int remaining = target_count;
+      for (int i = 0; i < target_count; i++) if (targets[i] == tail) remaining--;
+      while (front < back && remaining > 0) {
+        int cell = queue[front++];
+        for (int i = 0; i < 4; i++) {
+          int next = cell + offsets[i];
+          if (seen[next] == stamp || wall[next] || game.occupies(pairOf(next))) continue;
+          seen[next] = stamp;
+          distance[next] = distance[cell] + 1;
+          queue[back++] = next;
+          for (int j = 0; j < target_count; j++) if (targets[j] == next) remaining--;
+        }
+      }
+
+      int best = -1;
+      for (int i = 0; i < target_count; i++) {
+        if (seen[targets[i]] != stamp) continue;
+        if (best < 0 || distance[targets[i]] > distance[best]) best = targets[i];
+      }
+      return best < 0 ? 0 : directionTo(head, best);
+    }
+
+    //Any move that doesn't end the game on this tick, used when there is no better option. Moves that leave less room
+    //than the snake's length (a bitboard flood fill) are only taken if every other move does too
+    char anySafeMove(const GameState &game)
+    {
+      int head = cellOf(game.getBody().front());
+      int moving_tail = movingTail(game);
+      char fallback = 0;
+      //Keep going straight when that is safe
+      int straight = head;
+      for (int i = 0; i < 4; i++) if (offset_directions[i] == game.getDirection()) straight = head + offsets[i];
+      if (canEnter(game, straight, moving_tail)) {
+        if (!flood.isTrap(game, game.getDirection())) return game.getDirection();
+        fallback = game.getDirection();
+      }
+
+      for (int i = 0; i < 4; i++) {
+        int next = head + offsets[i];
+        if (isReverseDirection(offset_directions[i], game.getDirection()) || !canEnter(game, next, moving_tail)) continue;
+        if (!flood.isTrap(game, offset_directions[i])) return offset_directions[i];
+        if (!fallback) fallback = offset_directions[i];
+      }
+      return fallback;
+    }
+};
+
+#endif
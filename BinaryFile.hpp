@@ -0,0 +1,237 @@
+/*
+* File: BinaryFile.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the helpers shared by every binary file the
+* game reads and writes (settings, replays, ...): little-endian byte
+* buffers, a checksum, and atomic whole-file writes.
+*/
+
+//Redundancy safety check
+#ifndef BINARYFILE_H
+#define BINARYFILE_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdio.h>
+
+using namespace std;
+
+/*
+The ByteWriter struct appends fixed width little-endian values to a byte buffer
+*/
+struct ByteWriter
+{
+  vector<uint8_t> bytes;
+
+  void put8(uint8_t v) {bytes.push_back(v);}
+  void put16(uint16_t v) {put8(v & 0xFF); put8(v >> 8);}
+  void put32(uint32_t v) {put16(v & 0xFFFF); put16(v >> 16);}
+  void put64(uint64_t v) {put32(v & 0xFFFFFFFF); put32(v >> 32);}
+  //Variable length value, 7 bits per byte with the high bit marking that more bytes follow (small values take 1 byte)
+  void putVar(uint64_t v)
+  {
+    while (v >= 0x80) {
+      put8((v & 0x7F) | 0x80);
+      v >>= 7;
+    }
+    put8(v);
+  }
+  void putBytes(const void* data, size_t size)
+  {
+    const uint8_t* p = (const uint8_t*)data;
+    bytes.insert(bytes.end(), p, p+size);
+  }
+};
+
+/*
+The ByteReader struct reads back the values written by a ByteWriter, throwing if it runs past the end of the buffer
+*/
+struct ByteReader
+{
+  const uint8_t* data;
+  size_t size;
+  size_t pos = 0;
+
+  ByteReader(const uint8_t* d, size_t s) : data(d), size(s) {};
+  ByteReader(const vector<uint8_t>& v) : data(v.data()), size(v.size()) {};
+
+  uint8_t get8()
+  {
+    if (pos >= size) throw out_of_range("Attempted to read past the end of a binary file.");
+    return data[pos++];
+  }
+  uint16_t get16() {uint16_t lo = get8(); return lo | (uint16_t(get8()) << 8);}
+  uint32_t get32() {uint32_t lo = get16(); return lo | (uint32_t(get16()) << 16);}
+  uint64_t get64() {uint64_t lo = get32(); return lo | (uint64_t(get32()) << 32);}
+  uint64_t getVar()
+  {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t b = get8();
+      v |= uint64_t(b & 0x7F) << shift;
+      if (!(b & 0x80)) return v;
+    }
+    throw out_of_range("Malformed variable length value in a binary file.");
+  }
+  void getBytes(void* out, size_t count)
+  {
+    if (count > size - pos) throw out_of_range("Attempted to read past the end of a binary file.");
+    for (size_t i = 0; i < count; i++) ((uint8_t*)out)[i] = data[pos+i];
+    pos += count;
+  }
+  bool atEnd() const {return pos >= size;}
+};
+
+/*
+Returns the 32 bit FNV-1a hash of a range of bytes, used as a checksum for the game's binary files
+
+Params: 1 pointer, 1 size_t
+const uint8_t*, data: The first byte to hash
+size_t, size: The amount of bytes to hash
+
+Returns: The checksum
+*/
+uint32_t checksumBytes(const uint8_t* data, size_t size)
+{
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/*
+Writes a file atomically, the data goes to a temporary file that is flushed to disk and then renamed over the
+target, so a crash mid-write never leaves a half written file behind. Every write gets a temporary file of its own
+(made unique by mkstemp, next to the target so the rename stays on one file system), so processes writing the same file
+at once never write into each other's, the last rename wins with a whole file.
+
+Params: 1 string, 1 byte vector
+string, path: The file to write
+vector<uint8_t>, bytes: The full contents of the file
+
+Returns: True if the file was written
+*/
+bool atomicWriteFile(const string& path, const vector<uint8_t>& bytes)
+{
+  string temp_path = path + ".XXXXXX";
+  int fd = mkstemp(&temp_path[0]);
+  if (fd < 0) return false;
+  //mkstemp creates the file readable by its owner only, give it the permissions open() would have (0644 less the umask)
+  mode_t mask = umask(0);
+  umask(mask);
+  fchmod(fd, 0644 & ~mask);
+
+  size_t written = 0;
+  while (written < bytes.size()) {
+    ssize_t result = write(fd, bytes.data()+written, bytes.size()-written);
+    if (result <= 0) {
+      close(fd);
+      unlink(temp_path.c_str());
+      return false;
+    }
+    written += result;
+  }
+
+  //Make sure the contents are on disk before the rename makes them visible
+  if (fsync(fd) != 0) {
+    close(fd);
+    unlink(temp_path.c_str());
+    return false;
+  }
+  close(fd);
+  if (rename(temp_path.c_str(), path.c_str()) != 0) {
+    unlink(temp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+/*
+Reads a whole file into a byte vector
+
+Params: 1 string, 1 byte vector reference
+string, path: The file to read
+vector<uint8_t>, bytes: Receives the contents of the file
+
+Returns: True if the file could be read
+*/
+bool readFile(const string& path, vector<uint8_t>& bytes)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+
+  bytes.clear();
+  uint8_t chunk[4096];
+  ssize_t result;
+  while ((result = read(fd, chunk, sizeof(chunk))) > 0) bytes.insert(bytes.end(), chunk, chunk+result);
+  close(fd);
+  return result == 0;
+}
+
+/*
+Writes a file with the standard layout: 4 byte magic | version (1 byte) | payload size (4 bytes) | payload | FNV-1a checksum of the payload (4 bytes)
+
+Params: 2 string, 1 uint8_t, 1 byte vector
+string, path: The file to write
+string, magic: The 4 character file type tag
+uint8_t, version: The version of the payload layout
+vector<uint8_t>, payload: The contents
+
+Returns: True if the file was written
+*/
+bool writeFramedFile(const string& path, const string& magic, uint8_t version, const vector<uint8_t>& payload)
+{
+  ByteWriter file;
+  file.putBytes(magic.data(), 4);
+  file.put8(version);
+  file.put32(payload.size());
+  file.putBytes(payload.data(), payload.size());
+  file.put32(checksumBytes(payload.data(), payload.size()));
+  return atomicWriteFile(path, file.bytes);
+}
+
+/*
+Reads a file written by writeFramedFile, checking its magic, version, size and checksum
+
+Params: 2 string, 1 uint8_t, 1 byte vector reference
+string, path: The file to read
+string, magic: The expected 4 character file type tag
+uint8_t, version: The expected payload version
+vector<uint8_t>, payload: Receives the payload
+
+Returns: Void, throws runtime_error with the reason if the file is missing or not intact
+*/
+void readFramedFile(const string& path, const string& magic, uint8_t version, vector<uint8_t>& payload)
+{
+  vector<uint8_t> bytes;
+  if (!readFile(path, bytes)) throw runtime_error("Could not read " + path);
+
+  ByteReader file(bytes);
+  try {
+    char tag[4];
+    file.getBytes(tag, 4);
+    if (string(tag, 4) != magic) throw runtime_error(path + " is not a " + magic + " file");
+    if (file.get8() != version) throw runtime_error(path + " was written by an unsupported version");
+    uint32_t size = file.get32();
+    //Added up in 64 bits, a size field close to 4 GB must not wrap around to match a short file
+    if (bytes.size() - file.pos != uint64_t(size) + 4) throw runtime_error(path + " is truncated");
+    payload.assign(bytes.begin() + file.pos, bytes.begin() + file.pos + size);
+    file.pos += size;
+    if (file.get32() != checksumBytes(payload.data(), payload.size())) throw runtime_error(path + " is damaged");
+  } catch (const out_of_range&) {
+    throw runtime_error(path + " is truncated");
+  }
+  return;
+}
+
+#endif
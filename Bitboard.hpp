@@ -0,0 +1,427 @@
+/*
+* File: Bitboard.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the Bitboard, the board stored as one row of
+* 64-bit words per board row, and FloodFill, which answers reachability
+* questions on it a whole word (64 cells) at a time: the area reachable from
+* a cell, breadth-first distance maps and whether a move walks into a trap.
+* The word kernels run 4 words per instruction with AVX2, 2 with SSE2 and
+* fall back to plain 64-bit operations everywhere else.
+*/
+
+//Redundancy safety check
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "Engine.hpp"
+#include "Bot.hpp"
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+/*
+Bitboard Class:
+  One bit per cell, cell (row, column) is bit column % 64 of word column / 64 of the row. Every row is padded with a
+  zero word on both ends and the board with a zero row above and below, so the kernels can always read the neighbours
+  of a word or a row without bounds checks. The padding is never written.
+*/
+class Bitboard
+{
+  public:
+    /*
+    Constructor for Bitboard, every cell starts clear
+
+    Params: 2 integer
+    int, rows, columns: Size of the board
+    */
+    Bitboard(int rows=0, int columns=0) {resize(rows, columns);}
+
+    //Changes the size of the board and clears every cell
+    void resize(int new_rows, int new_columns)
+    {
+      rows = new_rows;
+      columns = new_columns;
+      words = size_t(columns + 63) / 64;
+      stride = words + 2;
+      bits.assign(size_t(rows + 2) * stride, 0);
+      return;
+    }
+
+    //Clears every cell
+    void clear() {fill(bits.begin(), bits.end(), 0);}
+
+    //Clears every cell of rows first to last (inclusive)
+    void clearRows(int first, int last)
+    {
+      for (int r = max(first, 0); r <= min(last, rows - 1); r++) fill(row(r), row(r) + words, 0);
+      return;
+    }
+
+    void set(ipair cell) {row(cell.first)[cell.second >> 6] |= uint64_t(1) << (cell.second & 63);}
+    void reset(ipair cell) {row(cell.first)[cell.second >> 6] &= ~(uint64_t(1) << (cell.second & 63));}
+    bool test(ipair cell) const {return (row(cell.first)[cell.second >> 6] >> (cell.second & 63)) & 1;}
+
+    //Returns true if the cell is on the board
+    bool contains(ipair cell) const {return cell.first >= 0 && cell.first < rows && cell.second >= 0 && cell.second < columns;}
+
+    //Returns the number of set cells
+    size_t count() const
+    {
+      size_t total = 0;
+      for (uint64_t word:bits) total += __builtin_popcountll(word);
+      return total;
+    }
+
+    //Returns the words of a row, rows -1 and getRows() are the zero padding
+    uint64_t* row(int r) {return &bits[size_t(r + 1) * stride + 1];}
+    const uint64_t* row(int r) const {return &bits[size_t(r + 1) * stride + 1];}
+
+    /*
+    Get respective private values (in function name)
+
+    Params: None
+
+    Returns: The respective value
+    */
+    int getRows() const {return rows;}
+    int getColumns() const {return columns;}
+    size_t rowWords() const {return words;}
+    size_t rowStride() const {return stride;} //Distance between the same word of two rows, padding included
+
+  private:
+    int rows = 0;
+    int columns = 0;
+    size_t words = 0; //Words per row holding cells
+    size_t stride = 0; //Words per row including the padding
+    vector<uint64_t> bits;
+};
+
+/*
+Sets every cell of a game's board the snake could move through: not a wall of the level (or the border) and not under the body
+
+Params: 1 GameState, 1 Bitboard reference
+GameState, game: The game
+Bitboard, open: Resized to the game's board and filled
+
+Returns: Void
+*/
+void loadOpenCells(const GameState &game, Bitboard &open)
+{
+  if (open.getRows() != game.getRows() || open.getColumns() != game.getColumns()) open.resize(game.getRows(), game.getColumns());
+  //The complement of the level's wall bitmap, which has the same words per row, a word at a time
+  const Level &level = game.getLevel();
+  const size_t last_word = open.rowWords() - 1;
+  const uint64_t last_mask = game.getColumns() % 64 ? (uint64_t(1) << (game.getColumns() % 64)) - 1 : ~uint64_t(0);
+  for (int r = 0; r < game.getRows(); r++) {
+    uint64_t *words = open.row(r);
+    const uint64_t *walls = level.wallRow(r);
+    for (size_t w = 0; w <= last_word; w++) words[w] = ~walls[w];
+    words[last_word] &= last_mask;
+  }
+  for (const ipair &segment:game.getBody()) if (open.contains(segment)) open.reset(segment);
+  return;
+}
+
+/*
+FloodFill Class:
+  Reachability on Bitboards. Filling the reachable area sweeps the rows down and up: each row takes in what the rows
+  next to it reached, then spreads along its own open runs, which a Kogge-Stone fill does for 64 cells in 6 shifts.
+  Updated rows feed the next row of the same sweep, so a board with no winding walls settles in a couple of sweeps
+  instead of one pass per cell of path length, and only rows next to a row that changed are visited again. Distance
+  maps need the true breadth-first order, so they advance a wavefront one step per pass instead, still 64 cells at a time.
+
+  The scratch boards are kept between calls, so queries don't allocate once the board size is known.
+*/
+class FloodFill
+{
+  public:
+    /*
+    Fills the area reachable from a cell
+
+    Params: 1 Bitboard, 1 ipair, 1 Bitboard reference
+    Bitboard, open: The cells that can be moved through
+    ipair, start: Where to start, it does not have to be open itself (e.g. the snake's head)
+    Bitboard, reached: Resized to the board and set to every cell reached, including the start
+
+    Returns: The number of open cells reached
+    */
+    size_t reach(const Bitboard &open, ipair start, Bitboard &reached)
+    {
+      const int rows = open.getRows();
+      const size_t words = open.rowWords();
+      if (reached.getRows() != rows || reached.getColumns() != open.getColumns()) reached.resize(rows, open.getColumns());
+      else reached.clear();
+      if (!open.contains(start)) return 0;
+      reached.set(start);
+
+      //Rows that have reached cells, and the rows whose neighbours changed since they were last brought up to date
+      int low = start.first, high = start.first;
+      dirty.assign(rows + 2, 0);
+      dirty[start.first + 1] = 1;
+      bool pending = true, first = true;
+      for (bool downwards = true; pending; downwards = !downwards) {
+        pending = false;
+        //The range grows as rows change, a sweep carries on into the rows it just made dirty
+        for (int r = downwards ? low - 1 : high + 1; downwards ? r <= high + 1 : r >= low - 1; r += downwards ? 1 : -1) {
+          if (r < 0 || r >= rows || !dirty[r + 1]) continue;
+          dirty[r + 1] = 0;
+          if (!updateRow(open, reached, r, words, first)) continue;
+          first = false;
+          //The rows next to it have to take in what it gained
+          dirty[r] = dirty[r + 2] = 1;
+          pending = true;
+          low = min(low, r);
+          high = max(high, r);
+        }
+      }
+
+      size_t area = 0;
+      for (int r = low; r <= high; r++) {
+        const uint64_t *cells = reached.row(r), *mask = open.row(r);
+        for (size_t w = 0; w < words; w++) area += __builtin_popcountll(cells[w] & mask[w]);
+      }
+      return area;
+    }
+
+    //Returns the number of open cells reachable from a cell
+    size_t reachableArea(const Bitboard &open, ipair start) {return reach(open, start, area_scratch);}
+
+    /*
+    Computes the breadth-first distance from a cell to every cell reachable from it
+
+    Params: 1 Bitboard, 1 ipair, 1 int32_t vector reference
+    Bitboard, open: The cells that can be moved through
+    ipair, start: Where to start, it does not have to be open itself
+    vector<int32_t>, distance: Set to one entry per cell (row * columns + column), the number of moves from the start or -1 if unreachable
+
+    Returns: The number of open cells reached
+    */
+    size_t distances(const Bitboard &open, ipair start, vector<int32_t> &distance)
+    {
+      const int rows = open.getRows(), columns = open.getColumns();
+      distance.assign(size_t(rows) * columns, -1);
+      if (!open.contains(start)) return 0;
+      for (Bitboard *board : {&seen, &frontier, &next}) {
+        if (board->getRows() != rows || board->getColumns() != columns) board->resize(rows, columns);
+        else board->clear();
+      }
+
+      seen.set(start);
+      frontier.set(start);
+      distance[size_t(start.first) * columns + start.second] = 0;
+      int low = start.first, high = start.first;
+      size_t area = open.test(start);
+      const size_t stride = open.rowStride();
+      for (int32_t step = 1; low <= high; step++) {
+        //Rows next to the wavefront are stepped as one stretch of memory, padding words included (they stay zero)
+        int first = max(low - 1, 0), last = min(high + 1, rows - 1);
+        size_t count = size_t(last - first + 1) * stride;
+        uint64_t *cells = next.row(first) - 1;
+        const uint64_t *current = frontier.row(first) - 1;
+        expandWords(cells, current - stride, current, current + stride, open.row(first) - 1, seen.row(first) - 1, count);
+
+        //Record the distance of every cell the wavefront reached on this step
+        uint64_t *visited = seen.row(first) - 1;
+        int next_low = rows, next_high = -1;
+        for (size_t i = 0; i < count; i++) {
+          uint64_t word = cells[i];
+          if (!word) continue;
+          visited[i] |= word;
+          area += __builtin_popcountll(word);
+          int r = first + int(i / stride);
+          next_low = min(next_low, r);
+          next_high = max(next_high, r);
+          int32_t *out = &distance[size_t(r) * columns + (i % stride - 1) * 64];
+          for (; word; word &= word - 1) out[__builtin_ctzll(word)] = step;
+        }
+        frontier.clearRows(low, high);
+        swap(frontier, next);
+        low = next_low;
+        high = next_high;
+      }
+      return area;
+    }
+
+    /*
+    Checks whether moving in a direction leaves the snake less room than its own length, a sign it would trap itself
+
+    Params: 1 GameState, 1 char
+    GameState, game: The game, before the tick is run
+    char, direction: The move to check
+
+    Returns: True if the move is fatal right away or the area reachable after it is smaller than the snake
+    */
+    bool isTrap(const GameState &game, char direction)
+    {
+      loadOpenCells(game, trap_open);
+      //The tail moves out of the way unless the snake is growing
+      const SnakeBody &body = game.getBody();
+      if (game.getPendingGrowth() == 0 && body.size() > 1) trap_open.set(body.back());
+
+      ipair cell = stepCell(body.front(), direction);
+      if (!trap_open.contains(cell) || !trap_open.test(cell)) return true;
+      trap_open.reset(cell);
+      size_t needed = body.size() + game.getPendingGrowth();
+      return reach(trap_open, cell, area_scratch) + 1 < needed;
+    }
+
+    /*
+    Counts the open cells the snake could still reach, the room it had left (shown when a game ends). The search starts
+    from the last cell the head was safely on, the neck, since a head that crashed sits on the border or the body.
+
+    Params: 1 GameState
+    GameState, game: The game
+
+    Returns: The number of open cells reachable from the neck (from the head for a snake of length 1)
+    */
+    size_t spaceRemaining(const GameState &game)
+    {
+      loadOpenCells(game, trap_open);
+      const SnakeBody &body = game.getBody();
+      return reach(trap_open, body.size() > 1 ? body[1] : body.front(), area_scratch);
+    }
+
+  private:
+    Bitboard seen, frontier, next; //Scratch for distances
+    Bitboard trap_open, area_scratch; //Scratch for the other queries
+    vector<uint8_t> dirty; //Rows of a fill to bring up to date, offset by one for the padding rows
+
+    //Spreads set cells along their open run within each word, both ways (occluded Kogge-Stone fill)
+    static uint64_t fillWord(uint64_t cells, uint64_t open)
+    {
+      uint64_t up = cells, up_open = open, down = cells, down_open = open;
+      for (int shift = 1; shift < 64; shift *= 2) {
+        up |= up_open & (up << shift);
+        up_open &= up_open << shift;
+        down |= down_open & (down >> shift);
+        down_open &= down_open >> shift;
+      }
+      return up | down;
+    }
+
+    /*
+    Brings one row of a reachability fill up to date: takes in the cells reached in the rows above and below, then
+    spreads along the row's open runs, across word boundaries as well. A row that gained nothing from its neighbours is
+    already spread, so the spreading is skipped unless seeded is set (the start row). Returns true if the row changed.
+    */
+    static bool updateRow(const Bitboard &open, Bitboard &reached, int r, size_t words, bool seeded)
+    {
+      uint64_t *cells = reached.row(r);
+      const uint64_t *mask = open.row(r), *above = reached.row(r - 1), *below = reached.row(r + 1);
+      uint64_t gained = 0;
+      size_t w = 0;
+
+      //Take in the neighbouring rows
+#if defined(__AVX2__)
+      __m256i gained_lanes = _mm256_setzero_si256();
+      for (; w + 4 <= words; w += 4) {
+        __m256i old = _mm256_loadu_si256((const __m256i*)(cells + w));
+        __m256i from = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(above + w)), _mm256_loadu_si256((const __m256i*)(below + w)));
+        __m256i added = _mm256_andnot_si256(old, _mm256_and_si256(from, _mm256_loadu_si256((const __m256i*)(mask + w))));
+        _mm256_storeu_si256((__m256i*)(cells + w), _mm256_or_si256(old, added));
+        gained_lanes = _mm256_or_si256(gained_lanes, added);
+      }
+      gained |= !_mm256_testz_si256(gained_lanes, gained_lanes);
+#elif defined(__SSE2__)
+      __m128i gained_lanes = _mm_setzero_si128();
+      for (; w + 2 <= words; w += 2) {
+        __m128i old = _mm_loadu_si128((const __m128i*)(cells + w));
+        __m128i from = _mm_or_si128(_mm_loadu_si128((const __m128i*)(above + w)), _mm_loadu_si128((const __m128i*)(below + w)));
+        __m128i added = _mm_andnot_si128(old, _mm_and_si128(from, _mm_loadu_si128((const __m128i*)(mask + w))));
+        _mm_storeu_si128((__m128i*)(cells + w), _mm_or_si128(old, added));
+        gained_lanes = _mm_or_si128(gained_lanes, added);
+      }
+      gained |= _mm_movemask_epi8(_mm_cmpeq_epi8(gained_lanes, _mm_setzero_si128())) != 0xFFFF;
+#endif
+      for (; w < words; w++) {
+        uint64_t added = mask[w] & (above[w] | below[w]) & ~cells[w];
+        cells[w] |= added;
+        gained |= added;
+      }
+      if (!gained && !seeded) return false;
+
+      //Spread along the open runs within every word
+      w = 0;
+#if defined(__AVX2__)
+      for (; w + 4 <= words; w += 4) {
+        __m256i up = _mm256_loadu_si256((const __m256i*)(cells + w)), down = up;
+        __m256i up_open = _mm256_loadu_si256((const __m256i*)(mask + w)), down_open = up_open;
+        for (int shift = 1; shift < 64; shift *= 2) {
+          up = _mm256_or_si256(up, _mm256_and_si256(up_open, _mm256_slli_epi64(up, shift)));
+          up_open = _mm256_and_si256(up_open, _mm256_slli_epi64(up_open, shift));
+          down = _mm256_or_si256(down, _mm256_and_si256(down_open, _mm256_srli_epi64(down, shift)));
+          down_open = _mm256_and_si256(down_open, _mm256_srli_epi64(down_open, shift));
+        }
+        _mm256_storeu_si256((__m256i*)(cells + w), _mm256_or_si256(up, down));
+      }
+#elif defined(__SSE2__)
+      for (; w + 2 <= words; w += 2) {
+        __m128i up = _mm_loadu_si128((const __m128i*)(cells + w)), down = up;
+        __m128i up_open = _mm_loadu_si128((const __m128i*)(mask + w)), down_open = up_open;
+        for (int shift = 1; shift < 64; shift *= 2) {
+          up = _mm_or_si128(up, _mm_and_si128(up_open, _mm_slli_epi64(up, shift)));
+          up_open = _mm_and_si128(up_open, _mm_slli_epi64(up_open, shift));
+          down = _mm_or_si128(down, _mm_and_si128(down_open, _mm_srli_epi64(down, shift)));
+          down_open = _mm_and_si128(down_open, _mm_srli_epi64(down_open, shift));
+        }
+        _mm_storeu_si128((__m128i*)(cells + w), _mm_or_si128(up, down));
+      }
+#endif
+      for (; w < words; w++) cells[w] = fillWord(cells[w], mask[w]);
+
+      //Runs that cross into the next word carry on there, to the right and then to the left
+      for (w = 1; w < words; w++) {
+        if ((cells[w - 1] >> 63) & mask[w] & ~cells[w] & 1) cells[w] = fillWord(cells[w] | 1, mask[w]);
+      }
+      for (w = words - 1; w-- > 0;) {
+        if ((cells[w + 1] & 1) & (mask[w] >> 63) & ~(cells[w] >> 63)) cells[w] = fillWord(cells[w] | (uint64_t(1) << 63), mask[w]);
+      }
+      return true;
+    }
+
+    /*
+    Advances a wavefront by one step over a stretch of words: every open, not yet seen cell next to a frontier cell
+    (left and right, across word boundaries, or in the rows above and below). Reads current[-1] and current[count].
+    */
+    static void expandWords(uint64_t *out, const uint64_t *above, const uint64_t *current, const uint64_t *below,
+                            const uint64_t *open, const uint64_t *seen, size_t count)
+    {
+      size_t w = 0;
+#if defined(__AVX2__)
+      for (; w + 4 <= count; w += 4) {
+        __m256i c = _mm256_loadu_si256((const __m256i*)(current + w));
+        __m256i left = _mm256_srli_epi64(_mm256_loadu_si256((const __m256i*)(current + w - 1)), 63);
+        __m256i right = _mm256_slli_epi64(_mm256_loadu_si256((const __m256i*)(current + w + 1)), 63);
+        __m256i spread = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi64(c, 1), _mm256_srli_epi64(c, 1)), _mm256_or_si256(left, right));
+        spread = _mm256_or_si256(spread, _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(above + w)), _mm256_loadu_si256((const __m256i*)(below + w))));
+        spread = _mm256_andnot_si256(_mm256_loadu_si256((const __m256i*)(seen + w)), _mm256_and_si256(spread, _mm256_loadu_si256((const __m256i*)(open + w))));
+        _mm256_storeu_si256((__m256i*)(out + w), spread);
+      }
+#elif defined(__SSE2__)
+      for (; w + 2 <= count; w += 2) {
+        __m128i c = _mm_loadu_si128((const __m128i*)(current + w));
+        __m128i left = _mm_srli_epi64(_mm_loadu_si128((const __m128i*)(current + w - 1)), 63);
+        __m128i right = _mm_slli_epi64(_mm_loadu_si128((const __m128i*)(current + w + 1)), 63);
+        __m128i spread = _mm_or_si128(_mm_or_si128(_mm_slli_epi64(c, 1), _mm_srli_epi64(c, 1)), _mm_or_si128(left, right));
+        spread = _mm_or_si128(spread, _mm_or_si128(_mm_loadu_si128((const __m128i*)(above + w)), _mm_loadu_si128((const __m128i*)(below + w))));
+        spread = _mm_andnot_si128(_mm_loadu_si128((const __m128i*)(seen + w)), _mm_and_si128(spread, _mm_loadu_si128((const __m128i*)(open + w))));
+        _mm_storeu_si128((__m128i*)(out + w), spread);
+      }
+#endif
+      for (; w < count; w++) {
+        uint64_t c = current[w];
+        uint64_t spread = (c << 1) | (c >> 1) | (current[w - 1] >> 63) | (current[w + 1] << 63) | above[w] | below[w];
+        out[w] = spread & open[w] & ~seen[w];
+      }
+      return;
+    }
+};
+
+#endif
@@ -0,0 +1,446 @@
+/*
+* File: Board.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the data structures used to keep track of
+* what is on the board. RingBuffer stores the snake's body so that the
+* snake can move and grow in constant time at any length, OccupancyGrid
+* keeps one bit per cell so collision queries are a single bit test, and
+* FreeCellIndex keeps the list of empty cells so spawning is a single pick.
+* ChunkedGrid is the sparse counterpart of OccupancyGrid for worlds far
+* larger than the screen, it only allocates the parts of the board in use.
+*/
+
+//Redundancy safety check
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
+#include <memory>
+
+/*
+RingBuffer Class:
+  A growable double-ended ring buffer. Elements are pushed onto the front and popped off the back,
+  with index 0 always being the front. The capacity is kept a power of two so wrapping an index is a single mask,
+  and it doubles whenever the buffer fills up, so pushing is amortized O(1) and popping is always O(1).
+*/
+template <typename T>
+class RingBuffer
+{
+  public:
+    /*
+    Constructor for RingBuffer
+
+    Params: 1 size_t
+    size_t, initial_capacity: Rounded up to the next power of two
+    */
+    RingBuffer(size_t initial_capacity=16)
+    {
+      size_t capacity = 1;
+      while (capacity < initial_capacity) capacity <<= 1;
+      items.resize(capacity);
+    }
+
+    /*
+    Adds an element to the front of the buffer, growing the buffer if it is full
+
+    Params: 1 T
+    T, value: The element to add
+
+    Returns: Void
+    */
+    void pushFront(const T& value)
+    {
+      if (count == items.size()) grow();
+      head = (head - 1) & mask();
+      items[head] = value;
+      count++;
+      return;
+    }
+
+    /*
+    Adds an element to the back of the buffer, growing the buffer if it is full
+
+    Params: 1 T
+    T, value: The element to add
+
+    Returns: Void
+    */
+    void pushBack(const T& value)
+    {
+      if (count == items.size()) grow();
+      items[(head + count) & mask()] = value;
+      count++;
+      return;
+    }
+
+    /*
+    Removes and returns the element at the back of the buffer, the buffer must not be empty
+
+    Params: None
+
+    Returns: The removed element
+    */
+    T popBack()
+    {
+      count--;
+      return items[(head + count) & mask()];
+    }
+
+    /*
+    Removes and returns the element at the front of the buffer, the buffer must not be empty
+
+    Params: None
+
+    Returns: The removed element
+    */
+    T popFront()
+    {
+      T value = items[head];
+      head = (head + 1) & mask();
+      count--;
+      return value;
+    }
+
+    //Element access, index 0 is the front
+    T& operator[](size_t index) {return items[(head + index) & mask()];}
+    const T& operator[](size_t index) const {return items[(head + index) & mask()];}
+    T& front() {return items[head];}
+    const T& front() const {return items[head];}
+    T& back() {return items[(head + count - 1) & mask()];}
+    const T& back() const {return items[(head + count - 1) & mask()];}
+
+    size_t size() const {return count;}
+    bool empty() const {return count == 0;}
+    void clear() {head = 0; count = 0;}
+
+    //Iterator used for range-based for-loops, walks from the front to the back
+    class const_iterator
+    {
+      public:
+        const_iterator(const RingBuffer* b, size_t i) : buffer(b), index(i) {};
+        const T& operator*() const {return (*buffer)[index];}
+        const T* operator->() const {return &(*buffer)[index];}
+        const_iterator& operator++() {index++; return *this;}
+        const_iterator operator++(int) {const_iterator old = *this; index++; return old;}
+        const_iterator operator+(size_t n) const {return const_iterator(buffer, index+n);}
+        bool operator==(const const_iterator& other) const {return index == other.index;}
+        bool operator!=(const const_iterator& other) const {return index != other.index;}
+      private:
+        const RingBuffer* buffer;
+        size_t index;
+    };
+    const_iterator begin() const {return const_iterator(this, 0);}
+    const_iterator end() const {return const_iterator(this, count);}
+
+  private:
+    std::vector<T> items;
+    size_t head = 0; //Slot of the front element
+    size_t count = 0; //Number of elements stored
+
+    size_t mask() const {return items.size() - 1;}
+
+    //Doubles the capacity, unwrapping the elements so the front lands back at slot 0
+    void grow()
+    {
+      std::vector<T> larger(items.size() * 2);
+      for (size_t i = 0; i < count; i++) larger[i] = (*this)[i];
+      items.swap(larger);
+      head = 0;
+      return;
+    }
+};
+
+/*
+OccupancyGrid Class:
+  A bitmap with one bit per board cell, set while a snake segment sits on the cell. It is updated incrementally as
+  segments are pushed and popped, so checking whether a cell is occupied is a single bit test regardless of the snake's length.
+  Cells are addressed with the same (row, column) coordinates as the Terminal, starting at a given top row.
+
+  A cell can briefly hold more than one segment when self collision is off. Those extra segments are counted in a small
+  side table so that popping one of them does not clear a cell that is still occupied.
+*/
+class OccupancyGrid
+{
+  public:
+    /*
+    Constructor for OccupancyGrid
+
+    Params: 3 integer
+    int, top: The first row covered by the grid
+    int, bottom: The last row covered by the grid
+    int, right: The last column covered by the grid (columns start at 0)
+    */
+    OccupancyGrid(int top, int bottom, int right) :
+     top_row(top), rows(bottom - top + 1), columns(right + 1), bits((size_t(rows) * columns + 63) / 64, 0) {};
+
+    //Marks a cell as occupied by one more segment
+    void set(std::pair<int, int> cell)
+    {
+      size_t i = index(cell);
+      uint64_t bit = uint64_t(1) << (i & 63);
+      if (bits[i >> 6] & bit) overlaps[i]++;
+      else bits[i >> 6] |= bit;
+      return;
+    }
+
+    //Marks a cell as occupied by one less segment
+    void clear(std::pair<int, int> cell)
+    {
+      size_t i = index(cell);
+      if (!overlaps.empty()) {
+        auto extra = overlaps.find(i);
+        if (extra != overlaps.end()) {
+          if (--extra->second == 0) overlaps.erase(extra);
+          return;
+        }
+      }
+      bits[i >> 6] &= ~(uint64_t(1) << (i & 63));
+      return;
+    }
+
+    //Returns true if any segment sits on the cell, cells outside the grid are never occupied
+    bool test(std::pair<int, int> cell) const
+    {
+      if (!contains(cell)) return false;
+      size_t i = index(cell);
+      return (bits[i >> 6] >> (i & 63)) & 1;
+    }
+
+    //Returns true if the cell is inside the grid
+    bool contains(std::pair<int, int> cell) const
+    {
+      return cell.first >= top_row && cell.first < top_row + rows && cell.second >= 0 && cell.second < columns;
+    }
+
+  private:
+    int top_row;
+    int rows;
+    int columns;
+    std::vector<uint64_t> bits;
+    //Number of segments beyond the first on each overlapped cell
+    std::unordered_map<size_t, int> overlaps;
+
+    size_t index(std::pair<int, int> cell) const {return size_t(cell.first - top_row) * columns + cell.second;}
+};
+
+/*
+FreeCellIndex Class:
+  Keeps every empty cell of a rectangular field in a dense array, along with a map from each cell to its position in
+  that array. Taking a cell swaps it with the last free cell and shrinks the array, releasing a cell appends it, so both
+  are O(1). Picking a uniformly random empty cell is a single index into the array, however full the board is.
+*/
+class FreeCellIndex
+{
+  public:
+    /*
+    Constructor for FreeCellIndex, every cell of the field starts out free
+
+    Params: 4 integer
+    int, top, left: The first row and column of the field
+    int, bottom, right: The last row and column of the field (inclusive)
+    */
+    FreeCellIndex(int top, int left, int bottom, int right) :
+     top_row(top), left_column(left), rows(bottom - top + 1), columns(right - left + 1)
+    {
+      if (rows < 0) rows = 0;
+      if (columns < 0) columns = 0;
+      free_cells.resize(size_t(rows) * columns);
+      position.resize(free_cells.size());
+      for (size_t i = 0; i < free_cells.size(); i++) {
+        free_cells[i] = i;
+        position[i] = i;
+      }
+    }
+
+    //Marks a cell as no longer free, cells outside the field or already taken are ignored
+    void take(std::pair<int, int> cell)
+    {
+      if (!contains(cell)) return;
+      int id = index(cell);
+      int at = position[id];
+      if (at < 0) return;
+
+      //Move the last free cell into the hole left by this one
+      int last = free_cells.back();
+      free_cells[at] = last;
+      position[last] = at;
+      free_cells.pop_back();
+      position[id] = -1;
+      return;
+    }
+
+    //Marks a cell as free again, cells outside the field or already free are ignored
+    void release(std::pair<int, int> cell)
+    {
+      if (!contains(cell)) return;
+      int id = index(cell);
+      if (position[id] >= 0) return;
+      position[id] = free_cells.size();
+      free_cells.push_back(id);
+      return;
+    }
+
+    //Returns the free cell at a position in the dense array (0 <= i < size())
+    std::pair<int, int> at(size_t i) const
+    {
+      int id = free_cells[i];
+      return {top_row + id / columns, left_column + id % columns};
+    }
+
+    bool isFree(std::pair<int, int> cell) const {return contains(cell) && position[index(cell)] >= 0;}
+    size_t size() const {return free_cells.size();}
+
+    //The dense array of free cells as ids (row-major positions inside the field), in the order at() picks them from
+    const std::vector<int>& getIds() const {return free_cells;}
+
+    /*
+    Puts the free cells back in a saved order, so a restored game picks the same random cells as the saved one
+
+    Params: 1 pointer, 1 size_t
+    const int32_t*, ids: The free cells as returned by getIds()
+    size_t, count: Number of ids
+
+    Returns: True if the ids are exactly the cells free now, in any order. The index is left in an undefined state
+             otherwise and should be thrown away
+    */
+    bool reorder(const int32_t* ids, size_t count)
+    {
+      if (count != free_cells.size()) return false;
+      //Each id must be free and appear once, its position is cleared the first time it is seen
+      for (size_t i = 0; i < count; i++) {
+        if (ids[i] < 0 || size_t(ids[i]) >= position.size() || position[ids[i]] < 0) return false;
+        position[ids[i]] = -1;
+      }
+      for (size_t i = 0; i < count; i++) {
+        free_cells[i] = ids[i];
+        position[ids[i]] = i;
+      }
+      return true;
+    }
+
+  private:
+    int top_row;
+    int left_column;
+    int rows;
+    int columns;
+    //Dense array of free cell ids
+    std::vector<int> free_cells;
+    //Position of each cell id in free_cells, -1 when the cell is taken
+    std::vector<int> position;
+
+    bool contains(std::pair<int, int> cell) const
+    {
+      return cell.first >= top_row && cell.first < top_row + rows && cell.second >= left_column && cell.second < left_column + columns;
+    }
+    int index(std::pair<int, int> cell) const {return (cell.first - top_row) * columns + (cell.second - left_column);}
+};
+
+/*
+ChunkedGrid Class:
+  An occupancy grid for very large boards that only allocates memory where segments are. The board is split into
+  chunks of 64x64 cells, each chunk being 64 words of 64 bits (one word per row), and a dense directory holds a pointer
+  per chunk, null while no segment is inside it. Testing a cell is a directory lookup and a bit test, with no hashing,
+  and a chunk is handed back (kept as a spare for the next allocation) once its last segment leaves, so memory follows
+  the area the snake covers rather than the size of the board. The directory itself costs one pointer per 4096 cells.
+
+  Cells are addressed with (row, column) coordinates starting at 0. Overlapping segments (while self collision is off)
+  are counted in a side table like in OccupancyGrid.
+*/
+class ChunkedGrid
+{
+  public:
+    static const int CHUNK_BITS = 6;
+    static const int CHUNK_SIZE = 1 << CHUNK_BITS; //Rows and columns of a chunk
+
+    /*
+    Constructor for ChunkedGrid, no chunk is allocated until a cell is set
+
+    Params: 2 integer
+    int, rows, columns: The size of the board
+    */
+    ChunkedGrid(int rows, int columns) :
+     board_rows(rows), board_columns(columns), chunk_columns((columns + CHUNK_SIZE - 1) >> CHUNK_BITS),
+     directory(size_t((rows + CHUNK_SIZE - 1) >> CHUNK_BITS) * chunk_columns) {};
+
+    //Marks a cell as occupied by one more segment, allocating its chunk if needed
+    void set(std::pair<int, int> cell)
+    {
+      std::unique_ptr<Chunk> &chunk = directory[chunkIndex(cell)];
+      if (!chunk) {
+        chunk = spare ? std::move(spare) : std::unique_ptr<Chunk>(new Chunk());
+        allocated++;
+      }
+      uint64_t bit = uint64_t(1) << (cell.second & (CHUNK_SIZE - 1));
+      uint64_t &word = chunk->rows[cell.first & (CHUNK_SIZE - 1)];
+      if (word & bit) overlaps[cellIndex(cell)]++;
+      else {
+        word |= bit;
+        chunk->count++;
+      }
+      return;
+    }
+
+    //Marks a cell as occupied by one less segment, releasing its chunk once it is empty
+    void clear(std::pair<int, int> cell)
+    {
+      std::unique_ptr<Chunk> &chunk = directory[chunkIndex(cell)];
+      if (!chunk) return;
+      if (!overlaps.empty()) {
+        auto extra = overlaps.find(cellIndex(cell));
+        if (extra != overlaps.end()) {
+          if (--extra->second == 0) overlaps.erase(extra);
+          return;
+        }
+      }
+      uint64_t bit = uint64_t(1) << (cell.second & (CHUNK_SIZE - 1));
+      uint64_t &word = chunk->rows[cell.first & (CHUNK_SIZE - 1)];
+      if (!(word & bit)) return;
+      word &= ~bit;
+      if (--chunk->count == 0) {
+        //Every word is 0 again, so the chunk can be reused as it is
+        spare = std::move(chunk);
+        allocated--;
+      }
+      return;
+    }
+
+    //Returns true if any segment sits on the cell, cells outside the board are never occupied
+    bool test(std::pair<int, int> cell) const
+    {
+      if (cell.first < 0 || cell.second < 0 || cell.first >= board_rows || cell.second >= board_columns) return false;
+      const Chunk *chunk = directory[chunkIndex(cell)].get();
+      return chunk && ((chunk->rows[cell.first & (CHUNK_SIZE - 1)] >> (cell.second & (CHUNK_SIZE - 1))) & 1);
+    }
+
+    //Number of chunks currently allocated
+    size_t getChunkCount() const {return allocated;}
+    //Bytes used by the allocated chunks and the directory
+    size_t getMemoryUsage() const {return allocated * sizeof(Chunk) + directory.size() * sizeof(directory[0]);}
+
+  private:
+    struct Chunk
+    {
+      uint64_t rows[CHUNK_SIZE] = {}; //Bit c of word r is set when cell (r, c) of the chunk is occupied
+      uint32_t count = 0; //Occupied cells in the chunk
+    };
+
+    int board_rows;
+    int board_columns;
+    size_t chunk_columns;
+    std::vector<std::unique_ptr<Chunk>> directory;
+    std::unique_ptr<Chunk> spare; //An empty chunk kept back so a snake crossing chunk borders doesn't allocate every time
+    size_t allocated = 0;
+    //Number of segments beyond the first on each overlapped cell
+    std::unordered_map<uint64_t, int> overlaps;
+
+    size_t chunkIndex(std::pair<int, int> cell) const {return size_t(cell.first >> CHUNK_BITS) * chunk_columns + (cell.second >> CHUNK_BITS);}
+    uint64_t cellIndex(std::pair<int, int> cell) const {return uint64_t(cell.first) * board_columns + cell.second;}
+};
+
+#endif
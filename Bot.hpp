@@ -0,0 +1,96 @@
+/*
+* File: Bot.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the Bot interface used to steer a game without
+* a keyboard (the arena, the autopilot demo), and the simple bots every
+* smarter bot is measured against.
+*/
+
+//Redundancy safety check
+#ifndef BOT_H
+#define BOT_H
+
+#include <string>
+#include <cstdlib>
+#include "Engine.hpp"
+
+using namespace std;
+
+//Returns true if turning from one direction to the other would reverse the snake onto itself
+bool isReverseDirection(char a, char b)
+{
+  return isReverse(directionOf(a), directionOf(b));
+}
+
+//Returns the cell one step from a cell in a direction
+ipair stepCell(ipair cell, char direction)
+{
+  const Direction heading = directionOf(direction);
+  return {cell.first + DIRECTION_ROW_STEP[heading], cell.second + DIRECTION_COLUMN_STEP[heading]};
+}
+
+/*
+Bot Class:
+  Steers a game. The arena gives every worker thread its own bot, so a bot may keep scratch buffers between calls
+  without any locking, but it must not carry anything from one game into the next that changes its decisions.
+*/
+class Bot
+{
+  public:
+    virtual ~Bot() {};
+
+    /*
+    Picks the direction for the next tick
+
+    Params: 1 GameState
+    GameState, game: The game, before the tick is run
+
+    Returns: 'w', 'a', 's' or 'd', or 0 to keep going straight
+    */
+    virtual char decide(const GameState &game) = 0;
+};
+
+/*
+StraightBot Class:
+  Never turns, the baseline every other bot has to beat.
+*/
+class StraightBot : public Bot
+{
+  public:
+    char decide(const GameState &) override {return 0;}
+};
+
+/*
+GreedyBot Class:
+  Takes the step that brings the head closest to the food, skipping steps into a wall or the body.
+  Looks only one cell ahead, so it easily traps itself once the snake is long.
+*/
+class GreedyBot : public Bot
+{
+  public:
+    char decide(const GameState &game) override
+    {
+      const ipair head = game.getBody().front();
+      const ipair food = game.getFood();
+      char best = 0;
+      int best_distance = 0;
+      for (char direction:string("wasd")) {
+        if (isReverseDirection(direction, game.getDirection())) continue;
+        ipair next = stepCell(head, direction);
+        if (game.isBlocked(next)) continue;
+        //The tail moves out of the way unless the snake is growing, stepping onto it is rarely fatal
+        if (game.occupies(next) && next != game.getBody().back()) continue;
+        //Before the first tick there is no food yet, any safe step will do
+        int distance = food.first < 0 ? 0 : abs(next.first - food.first) + abs(next.second - food.second);
+        if (best == 0 || distance < best_distance) {
+          best = direction;
+          best_distance = distance;
+        }
+      }
+      return best;
+    }
+};
+
+#endif
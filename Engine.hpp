@@ -0,0 +1,710 @@
+/*
+* File: Engine.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the game engine: GameState holds everything about
+* a single game and advances it one tick at a time with step(). The engine
+* does no input or output and reads no global settings, every rule comes from
+* the GameConfig snapshot it was created with, so any number of games can run
+* side by side in one process and a display is just an observer of the state.
+*/
+
+//Redundancy safety check
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <stdexcept>
+#include <cstring>
+#include "Board.hpp"
+#include "GameTimer.hpp"
+#include "Random.hpp"
+#include "GameConfig.hpp"
+#include "Items.hpp"
+#include "Level.hpp"
+#include "Rules.hpp"
+
+using ipair = std::pair<int, int>; //Type alias for integer pairs
+using SnakeBody = RingBuffer<std::pair<int, int>>; //Type alias for the ring buffer holding the snake's body, front is the head
+
+//Number of display rows above the board (the scoreboard and its margin)
+const int BOARD_TOP_ROW = 3;
+
+/*
+The StepResult struct describes what changed during a single tick, so observers only have to look at what changed
+*/
+struct StepResult
+{
+  bool tail_moved = false; //The tail left prev_tail (false while the snake grows)
+  ipair prev_tail = {-1, -1};
+  bool ate_food = false;
+  bool food_spawned = false; //At least one food item appeared, GameState::getSpawnedItems lists every new item
+  bool powerup_spawned = false;
+  bool powerup_eaten = false;
+  bool shrunk = false; //Tail segments were cut off, GameState::getShrunkCells lists them
+  bool powerup_expired = false;
+  bool speed_changed = false;
+  bool died = false;
+  bool won = false; //The snake filled the whole board
+};
+
+/*
+Phases of a tick in the order step() runs them, reported to the probe of step(input, probe) so a tick can be timed in parts:
+  STEP_MOVE: turning, moving the snake and eating whatever lies under the head
+  STEP_SPAWN: spawning food, checking for a win and firing the timed events (powerups appearing and running out)
+  STEP_COLLISION: checking whether the head crashed
+*/
+enum StepPhase : uint8_t
+{
+  STEP_MOVE,
+  STEP_SPAWN,
+  STEP_COLLISION
+};
+
+//Probe for step() that measures nothing, its calls compile away
+struct NoStepProbe
+{
+  void phaseDone(StepPhase) {}
+};
+
+/*
+The SaveHeader struct starts a saved game (see GameState::writeSave). It is followed by (every part starting on an 8
+byte boundary): the body from head to tail as LevelCells, the items in the order of the ItemIndex as SaveItems, the free
+cells in the order of the FreeCellIndex as 32-bit ids, and the timers still waiting in firing order as SaveTimers.
+Like a level, a save is used in place and is in the byte order of the machine that wrote it, so restoring a game walks
+the arrays where they lie instead of parsing them, however long the snake.
+*/
+struct SaveHeader
+{
+  uint64_t tick;
+  uint64_t game_time;
+  uint64_t timer_time; //Time of the timer wheel, the game time of the last tick
+  uint64_t rng_state[4];
+  uint64_t state_hash; //getStateHash() of the saved game, the restored game has to hash the same
+  uint32_t body_length;
+  uint32_t item_count;
+  uint32_t free_count;
+  uint32_t timer_count;
+  int32_t pending_growth;
+  int32_t score;
+  int32_t base_speed;
+  int32_t game_speed;
+  int32_t slow_stacks;
+  int32_t ghost_stacks;
+  int32_t double_stacks;
+  uint8_t direction;
+  uint8_t flags; //Bit 0 alive, bit 1 won, bit 2 died
+  uint8_t reserved[2];
+};
+
+//An item of a saved game
+struct SaveItem
+{
+  LevelCell cell;
+  uint32_t type;
+};
+
+//A timer of a saved game
+struct SaveTimer
+{
+  uint64_t expiry; //Wheel time it fires at
+  int32_t type;
+  int32_t data;
+};
+
+static_assert(sizeof(SaveHeader) == 112 && sizeof(SaveItem) == 8 && sizeof(SaveTimer) == 16, "Saved game structs must match the file layout");
+
+/*
+The SaveLayout struct holds where each part of a saved game lies, counted in bytes from the start of its header
+*/
+struct SaveLayout
+{
+  uint64_t body, items, free_cells, timers, size;
+
+  SaveLayout(uint64_t body_length, uint64_t item_count, uint64_t free_count, uint64_t timer_count)
+  {
+    body = sizeof(SaveHeader);
+    items = LevelLayout::align(body + body_length * sizeof(LevelCell));
+    free_cells = LevelLayout::align(items + item_count * sizeof(SaveItem));
+    timers = LevelLayout::align(free_cells + free_count * sizeof(int32_t));
+    size = timers + timer_count * sizeof(SaveTimer);
+  }
+};
+
+/*
+GameState Class:
+  The complete state of one game of snake, and the rules to advance it. The board is addressed with (row, column)
+  coordinates starting at 0, with the border on the outermost rows and columns. All randomness comes from the game's
+  own generator and all timed effects run on its own timer wheel against game time, which advances by the game speed
+  every tick, so a game is fully determined by its config and the inputs passed to step().
+
+  Food and powerups are items in an ItemIndex, any number of them can lie on the board. Whatever the head lands on goes
+  through eat(), which applies the ItemKind of its type: lasting effects are counted as stacks and undone one stack at a
+  time when their timers expire, and the game speed and self collision rule are worked out again from the stacks.
+
+  The board is a Level: a wall bitmap covering the border and any walls and portals, so whether the head crashed is a
+  single bit test however the board is laid out. Without a level pack the Level holds just the border.
+
+  The game keeps a Zobrist hash of the board, the XOR of a key per segment and per item (see zobristKey), updated with
+  one XOR whenever a segment or item comes or goes, so getStateHash costs the same at any length. Two games with the
+  same hash are the same game, which lets a replay or another player check it is still in step without comparing
+  whole boards.
+
+  A game in progress can be saved with writeSave and picked up again with restore, which brings back everything down to
+  the order of the free cells and the generator state, so the restored game plays on exactly as the saved one would have.
+*/
+class GameState
+{
+  public:
+    /*
+    Constructor for GameState, places the snake at a random starting position drawn from the seed (on one of the spawn
+    cells of a level)
+
+    Params: 1 GameConfig, 1 Level
+    GameConfig, game_config: The settings, board size and seed of the game, kept unchanged for the whole game
+    Level, board_level: The level to play on (optional), it must be the size of the board
+
+    Throws invalid_argument if the level is not the size of the board
+    */
+    GameState(const GameConfig& game_config, const Level& board_level=Level()) : GameState(game_config, board_level, EmptyBoard())
+    {
+      ipair start;
+      if (level.getSpawnCount() > 0) {
+        //A random spawn cell, heading the first way that isn't straight into a wall
+        start = level.getSpawn(rng.range(level.getSpawnCount()));
+        for (char heading:{'d', 's', 'a', 'w'}) {
+          ipair next = {start.first + (heading == 's') - (heading == 'w'), start.second + (heading == 'd') - (heading == 'a')};
+          if (!level.isSolid(next)) {
+            direction = heading;
+            break;
+          }
+        }
+      }
+      else if (!board_level.isEmpty()) start = free_cells.at(rng.range(free_cells.size()));
+      else {
+        //Starting position, kept at least 2 cells from the top border, 5 from the left border and 3 from the bottom/right border
+        start.first = rng.range(board_rows - 6) + 2;
+        start.second = rng.range(board_columns - 9) + 5;
+      }
+      body.pushBack(start);
+      occupancy.set(start);
+      free_cells.take(start);
+      board_hash ^= segmentKey(start);
+
+      //The first powerup spawns on the second tick, the timer wheel raises a delay of 0 to 1 ms and the first tick runs at 0 ms
+      if (config.enable_powerups && (config.powerup_types & POWERUP_TYPE_MASK)) timers.schedule(0, POWERUP_SPAWN_EVENT);
+    }
+
+    /*
+    Appends the complete state of the game to a byte buffer in the layout of SaveHeader, the config is not included
+
+    Params: 1 ByteWriter reference
+    ByteWriter, out: The buffer to write to, its size must be a multiple of 8 so the save starts on an 8 byte boundary
+
+    Returns: Void
+    */
+    void writeSave(ByteWriter& out) const
+    {
+      std::vector<std::pair<uint64_t, TimerEvent>> pending = timers.getPendingTimers();
+      const std::vector<int> &free_ids = free_cells.getIds();
+
+      SaveHeader header = {};
+      header.tick = tick;
+      header.game_time = game_time;
+      header.timer_time = timers.getTime();
+      for (int i = 0; i < 4; i++) header.rng_state[i] = rng.getState()[i];
+      header.state_hash = getStateHash();
+      header.body_length = body.size();
+      header.item_count = items.getItems().size();
+      header.free_count = free_ids.size();
+      header.timer_count = pending.size();
+      header.pending_growth = pending_growth;
+      header.score = score;
+      header.base_speed = base_speed;
+      header.game_speed = game_speed;
+      header.slow_stacks = slow_stacks;
+      header.ghost_stacks = ghost_stacks;
+      header.double_stacks = double_stacks;
+      header.direction = direction;
+      header.flags = alive | (won << 1) | (died << 2);
+
+      //Every part is written straight into place, the padding between them stays zero
+      SaveLayout layout(header.body_length, header.item_count, header.free_count, header.timer_count);
+      size_t start = out.bytes.size();
+      out.bytes.resize(start + layout.size, 0);
+      uint8_t *save = out.bytes.data() + start;
+      memcpy(save, &header, sizeof(header));
+      LevelCell *cells = (LevelCell*)(save + layout.body);
+      for (size_t i = 0; i < body.size(); i++) cells[i] = {uint16_t(body[i].first), uint16_t(body[i].second)};
+      SaveItem *saved_items = (SaveItem*)(save + layout.items);
+      for (size_t i = 0; i < items.getItems().size(); i++) {
+        const Item &item = items.getItems()[i];
+        saved_items[i] = {{uint16_t(item.cell.first), uint16_t(item.cell.second)}, uint32_t(item.type)};
+      }
+      for (size_t i = 0; i < free_ids.size(); i++) ((int32_t*)(save + layout.free_cells))[i] = free_ids[i];
+      SaveTimer *saved_timers = (SaveTimer*)(save + layout.timers);
+      for (size_t i = 0; i < pending.size(); i++) saved_timers[i] = {pending[i].first, pending[i].second.type, pending[i].second.data};
+      return;
+    }
+
+    /*
+    Restores a game saved with writeSave, reading the saved arrays in place
+
+    Params: 1 GameConfig, 1 Level, 1 pointer, 1 size_t
+    GameConfig, game_config: The config of the saved game
+    Level, board_level: The level of the saved game (optional), as for the constructor
+    const uint8_t*, save: The start of the saved state, on an 8 byte boundary
+    size_t, size: Bytes from save to the end of the saved state
+
+    Returns: The game as it was saved, throws runtime_error if the save is damaged or doesn't belong to the config
+    */
+    static GameState restore(const GameConfig& game_config, const Level& board_level, const uint8_t* save, size_t size)
+    {
+      const std::runtime_error damaged("The saved game is damaged");
+      GameState game(game_config, board_level, EmptyBoard());
+      if (size < sizeof(SaveHeader)) throw damaged;
+      SaveHeader header;
+      memcpy(&header, save, sizeof(header));
+      SaveLayout layout(header.body_length, header.item_count, header.free_count, header.timer_count);
+      if (layout.size > size || header.body_length == 0 || directionOf(header.direction) == NO_DIRECTION) throw damaged;
+
+      //Segments and items can only lie on the floor inside the border
+      auto onFloor = [&](const LevelCell &cell) {
+        return cell.row > 0 && cell.column > 0 && cell.row < game.board_rows - 1 && cell.column < game.board_columns - 1 && !game.isBlocked({cell.row, cell.column});
+      };
+      const LevelCell *cells = (const LevelCell*)(save + layout.body);
+      for (uint32_t i = 0; i < header.body_length; i++) {
+        if (!onFloor(cells[i])) throw damaged;
+        ipair cell = {cells[i].row, cells[i].column};
+        game.body.pushBack(cell);
+        game.occupancy.set(cell);
+        game.free_cells.take(cell);
+        game.board_hash ^= game.segmentKey(cell);
+      }
+      const SaveItem *saved_items = (const SaveItem*)(save + layout.items);
+      for (uint32_t i = 0; i < header.item_count; i++) {
+        const SaveItem &item = saved_items[i];
+        if (!onFloor(item.cell) || item.type >= uint32_t(ITEM_TYPES) || !game.items.add({item.cell.row, item.cell.column}, item.type)) throw damaged;
+        game.free_cells.take({item.cell.row, item.cell.column});
+        game.board_hash ^= game.itemKey(game.items.getItems().back());
+      }
+      if (!game.free_cells.reorder((const int32_t*)(save + layout.free_cells), header.free_count)) throw damaged;
+
+      game.timers.restart(header.timer_time);
+      const SaveTimer *saved_timers = (const SaveTimer*)(save + layout.timers);
+      for (uint32_t i = 0; i < header.timer_count; i++) {
+        const SaveTimer &timer = saved_timers[i];
+        if (timer.expiry <= header.timer_time || (timer.type != POWERUP_SPAWN_EVENT && timer.type != POWERUP_EXPIRE_EVENT)) throw damaged;
+        if (timer.data < 0 || timer.data >= ITEM_TYPES) throw damaged;
+        game.timers.schedule(timer.expiry - header.timer_time, timer.type, timer.data);
+      }
+
+      game.rng.setState(header.rng_state);
+      game.tick = header.tick;
+      game.game_time = header.game_time;
+      game.direction = header.direction;
+      game.pending_growth = header.pending_growth;
+      game.score = header.score;
+      game.base_speed = header.base_speed;
+      game.game_speed = header.game_speed;
+      game.slow_stacks = header.slow_stacks;
+      game.ghost_stacks = header.ghost_stacks;
+      game.double_stacks = header.double_stacks;
+      game.self_collision = game_config.self_collision && game.ghost_stacks == 0;
+      game.alive = header.flags & 1;
+      game.won = header.flags & 2;
+      game.died = header.flags & 4;
+
+      //Anything that got past the checks above but isn't the saved game (or a save from different rules) shows up here
+      if (game.getStateHash() != header.state_hash) throw damaged;
+      return game;
+    }
+
+    /*
+    Advances the game by one tick: moves the snake, eats and spawns food and powerups, fires timed effects and
+    checks for collisions. Does nothing once the game is over.
+
+    Params: 1 char
+    char, input: A new direction ('w', 'a', 's', 'd') to turn to before moving, ignored if it would reverse the snake (0 keeps going straight)
+
+    Returns: A StepResult describing what changed
+    */
+    StepResult step(char input=0)
+    {
+      NoStepProbe probe;
+      return step(input, probe);
+    }
+
+    /*
+    Advances the game by one tick like step(input), telling a probe each time a phase of the tick is done (see StepPhase).
+    The engine reads no clock itself, a profiler passed as the probe times the phases. The probe is a template parameter
+    so the plain step() pays nothing for it.
+
+    Params: 1 char, 1 Probe reference
+    char, input: A new direction, as for step(input)
+    Probe, probe: Any object with a phaseDone(StepPhase) method
+
+    Returns: A StepResult describing what changed
+    */
+    template <class Probe>
+    StepResult step(char input, Probe &probe)
+    {
+      StepResult result;
+      if (!alive) return result;
+      spawned_items.clear();
+      shrunk_cells.clear();
+      if (input) changeDirection(input);
+
+      move(result);
+
+      //Eat whatever lies under the head, a single lookup however many items are out
+      int item = items.find(body.front());
+      if (item >= 0) {
+        Item eaten = items.remove(item);
+        board_hash ^= itemKey(eaten);
+        eat(eaten.type, result);
+      }
+      probe.phaseDone(STEP_MOVE);
+
+      //Food spawns on the first tick, is replaced as soon as it is eaten, and retries every tick while it found no room
+      while (items.count(FOOD_ITEM) < config.food_count && spawnItem(FOOD_ITEM)) result.food_spawned = true;
+
+      //The snake covers every cell inside the border, the game is won (items only ever lie on cells the body doesn't cover)
+      if (free_cells.size() == 0 && items.getItems().empty())
+      {
+        won = true;
+        alive = false;
+        result.won = true;
+      }
+
+      //Fire the timed events that came due by the time of this tick
+      timers.advance(game_time, [&](const TimerEvent &event){
+        switch (event.type)
+        {
+        case POWERUP_SPAWN_EVENT:
+          if (items.getItems().size() - items.count(FOOD_ITEM) < size_t(config.max_powerups)) result.powerup_spawned |= spawnItem(randomPowerUpType());
+          timers.schedule(uint64_t(config.powerup_spawn_time)*1000, POWERUP_SPAWN_EVENT);
+          break;
+        case POWERUP_EXPIRE_EVENT:
+          stack(ITEM_KINDS[event.data], -1, result);
+          result.powerup_expired = true;
+          break;
+        }
+      });
+      probe.phaseDone(STEP_SPAWN);
+
+      //Check for collisions after the snake has moved
+      if (!won && ((head_overlap && self_collision) || isBlocked(body.front())))
+      {
+        alive = false;
+        died = true;
+        result.died = true;
+      }
+      probe.phaseDone(STEP_COLLISION);
+
+      game_time += game_speed;
+      tick++;
+      return result;
+    }
+
+    /*
+    Changes the direction of the snake, unless the new direction is opposite to the current one
+
+    Params: 1 char
+    char, new_direction: 'w', 'a', 's' or 'd'
+
+    Returns: Void
+    */
+    void changeDirection(char new_direction)
+    {
+      //Only change direction if it is not opposite to the current direction
+      if (isReverse(directionOf(new_direction), directionOf(direction))) return;
+      direction = new_direction;
+      return;
+    }
+
+    //Sets the direction without any checks, used to play back recorded directions
+    void setDirection(char new_direction) {direction = new_direction;}
+
+    /*
+    Replaces the game's generator with a fresh sequence, used by bots on copies of the game so their simulations
+    sample future spawns instead of foreseeing the real ones
+
+    Params: 1 uint64_t
+    uint64_t, seed: The new seed
+
+    Returns: Void
+    */
+    void reseedRandom(uint64_t seed)
+    {
+      rng.reseed(seed);
+      return;
+    }
+
+    /*
+    Ends the game early (e.g. quit from the pause menu)
+
+    Params: None
+
+    Returns: Void
+    */
+    void end()
+    {
+      alive = false;
+      return;
+    }
+
+    /*
+    Get respective private values (in function name)
+
+    Params: None
+
+    Returns: The respective value
+    */
+    const GameConfig& getConfig() const {return config;}
+    int getRows() const {return board_rows;}
+    int getColumns() const {return board_columns;}
+    const SnakeBody& getBody() const {return body;}
+    char getDirection() const {return direction;}
+    int getPendingGrowth() const {return pending_growth;}
+    const std::vector<Item>& getItems() const {return items.getItems();}
+    const std::vector<Item>& getSpawnedItems() const {return spawned_items;} //Items that appeared during the last tick
+    const std::vector<ipair>& getShrunkCells() const {return shrunk_cells;} //Cells cut off the tail during the last tick
+    //Number of active stacks of a lasting effect, summed over the item types that have it
+    int getSlowMoStacks() const {return slow_stacks;}
+    int getGhostStacks() const {return ghost_stacks;}
+    int getDoubleScoreStacks() const {return double_stacks;}
+    int getScore() const {return score;}
+    int getSpeed() const {return game_speed;}
+    uint64_t getTick() const {return tick;}
+    uint64_t getGameTime() const {return game_time;}
+    bool isAlive() const {return alive;}
+    bool isWon() const {return won;}
+    bool hasDied() const {return died;} //Ended by a collision, rather than by winning or quitting
+    const FreeCellIndex& getFreeCells() const {return free_cells;}
+    const Level& getLevel() const {return level;}
+
+    //Returns the position of a food item (the first one on the board), {-1, -1} if there is none
+    ipair getFood() const
+    {
+      for (const Item &item:items.getItems()) if (item.type == FOOD_ITEM) return item.cell;
+      return {-1, -1};
+    }
+
+    //Returns true if any segment of the snake is on the given cell, a single bit test
+    bool occupies(ipair cell) const {return occupancy.test(cell);}
+
+    //Returns true if an item lies on the given cell, a single lookup
+    bool hasItem(ipair cell) const {return items.find(cell) >= 0;}
+
+    //Returns true if the head crashes when it ends a tick on the cell (the border, a wall or a portal), a single bit test
+    bool isBlocked(ipair cell) const {return level.isSolid(cell);}
+
+    /*
+    Returns a 64 bit hash of the whole game: the Zobrist hash of the segments and items, with the head, length,
+    direction, score, speed, effect stacks, clock and generator state folded in. O(1), whatever the length of the snake.
+    Two segments on one cell (while ghosting) cancel out in the XOR, the length still tells such boards apart.
+
+    Params: None
+
+    Returns: The hash, equal for two games in the same state
+    */
+    uint64_t getStateHash() const
+    {
+      uint64_t hash = board_hash;
+      hash = mixHash(hash, cellIndex(body.front()) | uint64_t(body.size()) << 32);
+      hash = mixHash(hash, uint64_t(direction) | uint64_t(alive) << 8 | uint64_t(won) << 9 | uint64_t(died) << 10);
+      hash = mixHash(hash, uint64_t(uint32_t(score)) | uint64_t(uint32_t(pending_growth)) << 32);
+      hash = mixHash(hash, uint64_t(uint32_t(base_speed)) | uint64_t(uint32_t(game_speed)) << 32);
+      hash = mixHash(hash, uint64_t(slow_stacks) | uint64_t(ghost_stacks) << 16 | uint64_t(double_stacks) << 32);
+      hash = mixHash(hash, tick);
+      hash = mixHash(hash, game_time);
+      for (int i = 0; i < 4; i++) hash = mixHash(hash, rng.getState()[i]);
+      return hash;
+    }
+
+  private:
+    //The settings of this game, never changed once the game has started (not const so a whole GameState can be copied over another)
+    GameConfig config;
+    int board_rows;
+    int board_columns;
+    Level level; //The walls, portals and spawn cells of the board
+
+    SnakeBody body; //Ring buffer of the snake's body segments, front is the head
+    char direction = 'd'; //Current direction of the snake ('a' for left, 'd' for right, 'w' for up, 's' for down)
+    int pending_growth = 0; //Number of upcoming moves that will keep the tail in place
+    bool head_overlap = false; //Whether the head moved onto a cell that was already occupied by the body
+    OccupancyGrid occupancy; //One bit per cell, set where the body is
+    FreeCellIndex free_cells; //Every cell inside the border not covered by the body or an item
+
+    ItemIndex items; //Food and powerups lying on the board
+    std::vector<Item> spawned_items; //Items that appeared during the current tick
+    std::vector<ipair> shrunk_cells; //Cells cut off the tail during the current tick
+
+    Random rng;
+    TimerWheel timers;
+
+    //Active stacks of each lasting effect
+    int slow_stacks = 0;
+    int ghost_stacks = 0;
+    int double_stacks = 0;
+
+    int base_speed; //Milliseconds of game time per tick from eating alone, before slow-mo
+    int game_speed; //Milliseconds of game time per tick
+    bool self_collision; //Self collision rule, turned off while a ghost effect is active
+    int score = 0;
+    uint64_t tick = 0;
+    uint64_t game_time = 0; //Milliseconds of game time, advanced by game_speed every tick
+    bool alive = true;
+    bool won = false;
+    bool died = false;
+    uint64_t board_hash = 0; //XOR of the Zobrist keys of every segment and item on the board
+
+    //Selects the constructor that only sets up the board, for restore to fill in
+    struct EmptyBoard {};
+
+    //Sets up the board and level of a game without placing the snake or scheduling anything
+    GameState(const GameConfig& game_config, const Level& board_level, EmptyBoard) :
+     config(game_config), board_rows(game_config.rows - BOARD_TOP_ROW), board_columns(game_config.columns),
+     occupancy(0, board_rows - 1, board_columns - 1), free_cells(1, 1, board_rows - 2, board_columns - 2),
+     items(board_rows, board_columns), rng(game_config.seed), base_speed(game_config.initial_speed),
+     game_speed(game_config.initial_speed), self_collision(game_config.self_collision)
+    {
+      if (board_level.isEmpty()) level = Level::bordered(board_rows, board_columns);
+      else {
+        if (board_level.getRows() != board_rows || board_level.getColumns() != board_columns) throw std::invalid_argument("The level is not the size of the board");
+        level = board_level;
+        //Walls and portals are never free
+        for (int r = 1; r < board_rows - 1; r++) {
+          for (int c = 1; c < board_columns - 1; c++) if (level.isSolid({r, c})) free_cells.take({r, c});
+        }
+      }
+    }
+
+    //Kinds of Zobrist keys, items take HASH_ITEM + their type
+    static const uint64_t HASH_SEGMENT = 1;
+    static const uint64_t HASH_ITEM = 2;
+
+    size_t cellIndex(ipair cell) const {return size_t(cell.first) * board_columns + cell.second;}
+    uint64_t segmentKey(ipair cell) const {return zobristKey(HASH_SEGMENT, cellIndex(cell));}
+    uint64_t itemKey(const Item &item) const {return zobristKey(HASH_ITEM + item.type, cellIndex(item.cell));}
+
+    //Moves the snake one cell: pops the tail (unless growing) and pushes the new head
+    void move(StepResult &result)
+    {
+      //The offset for the new head position, looked up from the current direction
+      const Direction heading = directionOf(direction);
+      const int row_offset = DIRECTION_ROW_STEP[heading], column_offset = DIRECTION_COLUMN_STEP[heading];
+      ipair head = {body.front().first + row_offset, body.front().second + column_offset};
+      //Stepping into a portal comes out of the other side, moving on in the same direction. An exit leading straight into
+      //another portal is a crash, so no cell of a portal ever holds a segment
+      if (level.isPortal(head))
+      {
+        ipair exit = level.portalExit(head);
+        head = {exit.first + row_offset, exit.second + column_offset};
+      }
+
+      //Pop the tail first so the head may follow right behind it
+      if (pending_growth > 0) pending_growth--;
+      else {
+        result.prev_tail = body.popBack();
+        result.tail_moved = true;
+        board_hash ^= segmentKey(result.prev_tail);
+        occupancy.clear(result.prev_tail);
+        //The cell only becomes free if no other segment still overlaps it
+        if (!occupancy.test(result.prev_tail)) free_cells.release(result.prev_tail);
+      }
+
+      //Push the new head, noting whether it landed on the body
+      head_overlap = occupancy.test(head);
+      body.pushFront(head);
+      board_hash ^= segmentKey(head);
+      occupancy.set(head);
+      free_cells.take(head);
+      return;
+    }
+
+    //Bits of config.powerup_types that stand for powerup types (food is not a powerup)
+    static const int POWERUP_TYPE_MASK = ((1 << ITEM_TYPES) - 1) & ~(1 << FOOD_ITEM);
+
+    //Applies the ItemKind of an eaten item: score, growth and shrinking happen now, lasting effects are stacked
+    void eat(int type, StepResult &result)
+    {
+      const ItemKind &kind = ITEM_KINDS[type];
+      if (type == FOOD_ITEM) result.ate_food = true;
+      else result.powerup_eaten = true;
+
+      score += kind.points << (double_stacks < 16 ? double_stacks : 16);
+      pending_growth += kind.growth;
+      for (int i = 0; i < kind.shrink && body.size() > 1; i++)
+      {
+        ipair tail = body.popBack();
+        board_hash ^= segmentKey(tail);
+        occupancy.clear(tail);
+        if (!occupancy.test(tail)) free_cells.release(tail);
+        shrunk_cells.push_back(tail);
+        result.shrunk = true;
+      }
+      if (kind.speeds_up)
+      {
+        if (base_speed > config.max_speed) base_speed = int(base_speed*(float(config.speed_multiplier)/100.0));
+        else base_speed = config.max_speed;
+        result.speed_changed = true;
+      }
+      stack(kind, 1, result);
+      if (kind.timed) timers.schedule(uint64_t(config.powerup_time)*1000, POWERUP_EXPIRE_EVENT, type);
+      return;
+    }
+
+    //Adds (count 1) or removes (count -1) one stack of the lasting effects of an item kind, then updates the speed and rules
+    void stack(const ItemKind &kind, int count, StepResult &result)
+    {
+      if (!kind.timed) count = 0;
+      slow_stacks += kind.slows * count;
+      ghost_stacks += kind.ghost * count;
+      double_stacks += kind.doubles_score * count;
+      self_collision = config.self_collision && ghost_stacks == 0;
+
+      //Every slow-mo stack multiplies the time per tick, capped at a minute
+      int speed = base_speed;
+      for (int i = 0; i < slow_stacks && speed < 60000; i++) speed *= (config.slow_mo_increment > 1 ? config.slow_mo_increment : 1);
+      if (speed != game_speed)
+      {
+        game_speed = speed;
+        result.speed_changed = true;
+      }
+      return;
+    }
+
+    //Draws one of the powerup types enabled in the config
+    int randomPowerUpType()
+    {
+      int enabled = config.powerup_types & POWERUP_TYPE_MASK, count = 0;
+      for (int type = 0; type < ITEM_TYPES; type++) count += (enabled >> type) & 1;
+      int pick = rng.range(count);
+      for (int type = 0; type < ITEM_TYPES; type++)
+      {
+        if (!((enabled >> type) & 1)) continue;
+        if (pick-- == 0) return type;
+      }
+      return FOOD_ITEM;
+    }
+
+    //Places an item on a random free cell, returns false if there is none
+    bool spawnItem(int type)
+    {
+      if (free_cells.size() == 0) return false;
+      //Item cells are taken out of the index, so one draw always lands on an empty cell
+      ipair cell = free_cells.at(rng.range(free_cells.size()));
+      if (!items.add(cell, type)) return false;
+      free_cells.take(cell);
+      spawned_items.push_back({cell, type});
+      board_hash ^= itemKey(spawned_items.back());
+      return true;
+    }
+};
+
+#endif
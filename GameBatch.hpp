@@ -0,0 +1,404 @@
+/*
+* File: GameBatch.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the GameBatch, a vectorized environment for bot
+* training that steps thousands of games of the same size in lockstep with a
+* single call. The state is kept as structure of arrays (heads, directions,
+* lengths and food of every game in contiguous arrays) so the per-tick checks
+* run as SIMD kernels across the whole batch, and every board is a bit-packed
+* occupancy plane that doubles as the observation. The batch is a template
+* on the rule policies of Rules.hpp, so each combination of wall and
+* collision mode gets its own step loop with no rule checks left in it.
+*/
+
+//Redundancy safety check
+#ifndef GAMEBATCH_H
+#define GAMEBATCH_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "Random.hpp"
+#include "GameConfig.hpp"
+#include "Engine.hpp"
+#include "Rules.hpp"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+/*
+BasicGameBatch Class:
+  Plays the GameState rules on many boards at once, without powerups or game speed, which only matter to a player
+  watching the clock. The wall policy (SolidWalls or WrapWalls) and the collision policy (SelfCollision or
+  NoSelfCollision) are template parameters, GameBatch is the normal rules. Finished games (dead or won) are reset with a fresh seed inside
+  the same step() call, so the batch never has to be drained.
+
+  A board is addressed like the GameState board, (row, column) with the border on the outermost rows and columns, and
+  cell = row * columns + column. Every game owns planeWords() 64-bit words of the occupancy array (one bit per cell,
+  set under the body) and a ring of cells holding its body. Food is placed by drawing random cells until a free one is
+  hit, which costs about one draw until the board is nearly full, after which it falls back to counting free cells.
+  Without self collision the body can lie on a cell more than once, so each game also counts the segments on every
+  cell and its bit stays set until the last one leaves; a snake as long as the board has won.
+*/
+template <class Walls = SolidWalls, class Collision = SelfCollision>
+class BasicGameBatch
+{
+  public:
+    //Observation planes written per game by writeObservations, in this order
+    static const int BODY_PLANE = 0;
+    static const int HEAD_PLANE = 1;
+    static const int FOOD_PLANE = 2;
+    static const int OBSERVATION_PLANES = 3;
+
+    /*
+    Constructor for BasicGameBatch, starts every game
+
+    Params: 1 GameConfig, 1 size_t
+    GameConfig, config: Display size of every board (rows and columns as in GameState), its seed seeds game i with seed + i
+    size_t, games: Number of games in the batch
+
+    Throws invalid_argument if the board is too small for the starting position or has more than 65536 cells
+    */
+    BasicGameBatch(const GameConfig &config, size_t games) :
+     count(games), board_rows(config.rows - BOARD_TOP_ROW), board_columns(config.columns),
+     cells(size_t(board_rows) * board_columns), plane_words((cells + 63) / 64),
+     interior(size_t(board_rows - 2) * (board_columns - 2)), ring_size(1)
+    {
+      //Checked before anything is sized from the board, interior wraps around on a board without an inside
+      if (board_rows < 9 || board_columns < 12) throw invalid_argument("GameBatch boards must be at least 12x12 display cells");
+      //Cells are stored in 16 bits to keep every game's body ring small enough to stay in cache
+      if (cells > 65536) throw invalid_argument("GameBatch boards must have at most 65536 cells");
+      while (ring_size < interior) ring_size *= 2;
+
+      head_row.resize(count);
+      head_column.resize(count);
+      row_step.resize(count);
+      column_step.resize(count);
+      food_row.resize(count);
+      food_column.resize(count);
+      length.resize(count);
+      pending_growth.resize(count);
+      score.resize(count);
+      ticks.resize(count);
+      ring_head.resize(count);
+      hit_wall.resize(count);
+      hit_food.resize(count);
+      occupancy.assign(count * plane_words, 0);
+      body.resize(count * ring_size);
+      rng.resize(count);
+      if (!Collision::ENABLED) {
+        segments.assign(count * cells, 0);
+        covered.assign(count, 0);
+      }
+
+      for (size_t i = 0; i < count; i++) {
+        rng[i].reseed(config.seed + i);
+        reset(i);
+      }
+    }
+
+    /*
+    Advances every game by one tick and resets the ones that ended
+
+    Params: 1 const char*, 1 float*, 1 uint8_t*
+    const char*, actions: One direction per game ('w', 'a', 's', 'd', or 0 to keep going), reversing is ignored like in GameState
+    float*, rewards: Filled with 1 per food eaten, -1 for dying and 0 otherwise (may be null)
+    uint8_t*, done: Filled with 1 for games that ended on this tick and were reset, 0 otherwise (may be null)
+
+    Returns: Void
+    */
+    void step(const char *actions, float *rewards, uint8_t *done)
+    {
+      //Turning is two table lookups per game with no branches, reversing into the neck (or no action) keeps the direction
+      if (actions) {
+        int32_t *rows = row_step.data(), *columns = column_step.data();
+        for (size_t i = 0; i < count; i++) {
+          Direction action = directionOf(actions[i]);
+          int32_t r = DIRECTION_ROW_STEP[action];
+          int32_t c = DIRECTION_COLUMN_STEP[action];
+          bool turn = ((r | c) != 0) & ((r != -rows[i]) | (c != -columns[i]));
+          rows[i] = turn ? r : rows[i];
+          columns[i] = turn ? c : columns[i];
+        }
+      }
+
+      //Move every head and check the border (or wrap around it) and the food across the whole batch
+      moveHeads();
+
+      //The rest depends on each game's own body, so it is done per game
+      for (size_t i = 0; i < count; i++) {
+        float reward = 0;
+        bool ended = false;
+        ticks[i]++;
+
+        if (hit_wall[i]) ended = true;
+        else {
+          uint16_t *ring = &body[i * ring_size];
+
+          //Pop the tail first so the head may follow right behind it
+          if (pending_growth[i] > 0) pending_growth[i]--;
+          else {
+            leave(i, ring[(ring_head[i] - length[i] + 1) & (ring_size - 1)]);
+            length[i]--;
+          }
+
+          uint32_t head = uint32_t(head_row[i]) * board_columns + head_column[i];
+          if (Collision::ENABLED && isCovered(i, head)) ended = true;
+          else {
+            cover(i, head);
+            ring_head[i] = (ring_head[i] + 1) & (ring_size - 1);
+            ring[ring_head[i]] = head;
+            length[i]++;
+
+            if (hit_food[i]) {
+              reward = 1;
+              score[i]++;
+              pending_growth[i]++;
+              //Winning is filling the board, there is nowhere left to put the food (or, when the body may overlap,
+              //growing as long as the board, which also keeps the body inside its ring)
+              if (!Collision::ENABLED && length[i] + pending_growth[i] >= interior) ended = true;
+              else if (!spawnFood(i)) ended = true;
+            }
+          }
+        }
+
+        if (ended) {
+          if (!reward) reward = -1;
+          reset(i);
+        }
+        if (rewards) rewards[i] = reward;
+        if (done) done[i] = ended;
+      }
+      return;
+    }
+
+    /*
+    Writes the bit-packed observation of every game
+
+    Params: 1 uint64_t*
+    uint64_t*, out: count * OBSERVATION_PLANES * planeWords() words, game i starts at i * OBSERVATION_PLANES * planeWords()
+                    with the body, head and food planes one after another
+
+    Returns: Void
+    */
+    void writeObservations(uint64_t *out) const
+    {
+      for (size_t i = 0; i < count; i++) {
+        uint64_t *planes = out + i * OBSERVATION_PLANES * plane_words;
+        memcpy(planes + BODY_PLANE * plane_words, &occupancy[i * plane_words], plane_words * sizeof(uint64_t));
+        memset(planes + HEAD_PLANE * plane_words, 0, 2 * plane_words * sizeof(uint64_t));
+        size_t head = size_t(head_row[i]) * board_columns + head_column[i];
+        size_t food = size_t(food_row[i]) * board_columns + food_column[i];
+        planes[HEAD_PLANE * plane_words + (head >> 6)] |= uint64_t(1) << (head & 63);
+        planes[FOOD_PLANE * plane_words + (food >> 6)] |= uint64_t(1) << (food & 63);
+      }
+      return;
+    }
+
+    /*
+    Get respective private values (in function name), arrays hold one entry per game
+
+    Params: None
+
+    Returns: The respective value
+    */
+    size_t size() const {return count;}
+    int getRows() const {return board_rows;}
+    int getColumns() const {return board_columns;}
+    size_t planeWords() const {return plane_words;}
+    const uint64_t* getOccupancy() const {return occupancy.data();}
+    const int32_t* getHeadRows() const {return head_row.data();}
+    const int32_t* getHeadColumns() const {return head_column.data();}
+    const int32_t* getFoodRows() const {return food_row.data();}
+    const int32_t* getFoodColumns() const {return food_column.data();}
+    const uint32_t* getLengths() const {return length.data();}
+    const uint32_t* getScores() const {return score.data();}
+    const uint32_t* getTicks() const {return ticks.data();}
+
+    //Returns the direction ('w', 'a', 's' or 'd') game i is moving in
+    char getDirection(size_t i) const
+    {
+      if (row_step[i]) return row_step[i] < 0 ? 'w' : 's';
+      return column_step[i] < 0 ? 'a' : 'd';
+    }
+
+  private:
+    size_t count;
+    int board_rows;
+    int board_columns;
+    size_t cells;
+    size_t plane_words;
+    size_t interior; //Cells inside the border, the longest a snake can get
+    size_t ring_size; //Body ring entries per game, interior rounded up to a power of two so wrapping is a mask
+
+    //Structure of arrays, entry i belongs to game i
+    vector<int32_t> head_row, head_column;
+    vector<int32_t> row_step, column_step; //Offset of the head per tick, from the direction
+    vector<int32_t> food_row, food_column;
+    vector<uint32_t> length;
+    vector<uint32_t> pending_growth;
+    vector<uint32_t> score;
+    vector<uint32_t> ticks; //Ticks since the game started
+    vector<uint32_t> ring_head; //Position of the head in the game's body ring
+    vector<uint8_t> hit_wall, hit_food; //Written by moveHeads for this tick
+    vector<uint64_t> occupancy; //plane_words per game
+    vector<uint16_t> body; //ring_size cells per game, a ring with the head at ring_head
+    vector<uint16_t> segments; //Without self collision only, cells per game, the segments lying on each cell
+    vector<uint32_t> covered; //Without self collision only, cells of each game with a segment on them
+    vector<Random> rng;
+
+    /*
+    Moves every head one cell and flags the games whose head hit the border or the food, with wrapping walls the heads
+    that crossed the border come back in on the other side instead. This is the hot loop over the whole batch, so it is
+    written over the plain arrays with no branches, 8 games per AVX2 instruction when available.
+    */
+    void moveHeads()
+    {
+      //Local pointers, through the members every flag byte written could alias the vectors' own pointers
+      int32_t *rows = head_row.data(), *columns = head_column.data();
+      const int32_t *row_steps = row_step.data(), *column_steps = column_step.data();
+      const int32_t *food_rows = food_row.data(), *food_columns = food_column.data();
+      uint8_t *walls = hit_wall.data(), *foods = hit_food.data();
+      size_t i = 0;
+#if defined(__AVX2__)
+      const __m256i one = _mm256_set1_epi32(1);
+      const __m256i inner_rows = _mm256_set1_epi32(board_rows - 2);
+      const __m256i inner_columns = _mm256_set1_epi32(board_columns - 2);
+      for (; i + 8 <= count; i += 8) {
+        __m256i r = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(rows + i)), _mm256_loadu_si256((const __m256i*)(row_steps + i)));
+        __m256i c = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(columns + i)), _mm256_loadu_si256((const __m256i*)(column_steps + i)));
+        if (Walls::WRAPS) {
+          //Lanes past the border take the first or last inner row or column, the same selects as WrapWalls::wrap
+          r = _mm256_blendv_epi8(r, inner_rows, _mm256_cmpgt_epi32(one, r));
+          r = _mm256_blendv_epi8(r, one, _mm256_cmpgt_epi32(r, inner_rows));
+          c = _mm256_blendv_epi8(c, inner_columns, _mm256_cmpgt_epi32(one, c));
+          c = _mm256_blendv_epi8(c, one, _mm256_cmpgt_epi32(c, inner_columns));
+        }
+        _mm256_storeu_si256((__m256i*)(rows + i), r);
+        _mm256_storeu_si256((__m256i*)(columns + i), c);
+
+        //Lanes are all ones where row < 1, row > rows-2, column < 1 or column > columns-2, never after wrapping
+        __m256i wall = _mm256_or_si256(_mm256_or_si256(_mm256_cmpgt_epi32(one, r), _mm256_cmpgt_epi32(r, inner_rows)),
+                                       _mm256_or_si256(_mm256_cmpgt_epi32(one, c), _mm256_cmpgt_epi32(c, inner_columns)));
+        __m256i food = _mm256_and_si256(_mm256_cmpeq_epi32(r, _mm256_loadu_si256((const __m256i*)(food_rows + i))),
+                                        _mm256_cmpeq_epi32(c, _mm256_loadu_si256((const __m256i*)(food_columns + i))));
+
+        //One bit per lane, then one flag byte per game
+        int wall_mask = _mm256_movemask_ps(_mm256_castsi256_ps(wall));
+        int food_mask = _mm256_movemask_ps(_mm256_castsi256_ps(food));
+        for (int lane = 0; lane < 8; lane++) {
+          walls[i + lane] = (wall_mask >> lane) & 1;
+          foods[i + lane] = (food_mask >> lane) & 1;
+        }
+      }
+#endif
+      //Scalar kernel for the remainder (and everything without AVX2), simple enough for the compiler to vectorize itself
+      const int32_t last_row = board_rows - 1, last_column = board_columns - 1;
+      for (; i < count; i++) {
+        int32_t r = Walls::wrap(rows[i] + row_steps[i], last_row);
+        int32_t c = Walls::wrap(columns[i] + column_steps[i], last_column);
+        rows[i] = r;
+        columns[i] = c;
+        walls[i] = (!Walls::WRAPS) & ((r <= 0) | (r >= last_row) | (c <= 0) | (c >= last_column));
+        foods[i] = (r == food_rows[i]) & (c == food_columns[i]);
+      }
+      return;
+    }
+
+    //Starts game i over: a one cell snake at a random position heading right, with food on the board
+    void reset(size_t i)
+    {
+      //A new seed for every game played in this slot, drawn from the slot's own generator
+      rng[i].reseed(rng[i].next());
+      memset(&occupancy[i * plane_words], 0, plane_words * sizeof(uint64_t));
+      if (!Collision::ENABLED) {
+        //Only the cells of the last body can hold segments
+        for (uint32_t n = 0; n < length[i]; n++) segments[i * cells + body[i * ring_size + ((ring_head[i] - n) & (ring_size - 1))]] = 0;
+        covered[i] = 0;
+      }
+
+      //Same starting position rule as GameState
+      head_row[i] = rng[i].range(board_rows - 6) + 2;
+      head_column[i] = rng[i].range(board_columns - 9) + 5;
+      row_step[i] = 0;
+      column_step[i] = 1;
+      length[i] = 1;
+      pending_growth[i] = 0;
+      score[i] = 0;
+      ticks[i] = 0;
+      ring_head[i] = 0;
+
+      uint32_t head = uint32_t(head_row[i]) * board_columns + head_column[i];
+      body[i * ring_size] = head;
+      cover(i, head);
+      spawnFood(i);
+      return;
+    }
+
+    //Returns true if a segment of game i lies on a cell
+    bool isCovered(size_t i, uint32_t cell) const {return (occupancy[i * plane_words + (cell >> 6)] >> (cell & 63)) & 1;}
+
+    //Puts a segment of game i on a cell
+    void cover(size_t i, uint32_t cell)
+    {
+      if (!Collision::ENABLED && segments[i * cells + cell]++) return;
+      occupancy[i * plane_words + (cell >> 6)] |= uint64_t(1) << (cell & 63);
+      if (!Collision::ENABLED) covered[i]++;
+      return;
+    }
+
+    //Takes a segment of game i off a cell, the cell is free once none are left on it
+    void leave(size_t i, uint32_t cell)
+    {
+      if (!Collision::ENABLED && --segments[i * cells + cell]) return;
+      occupancy[i * plane_words + (cell >> 6)] &= ~(uint64_t(1) << (cell & 63));
+      if (!Collision::ENABLED) covered[i]--;
+      return;
+    }
+
+    //Places the food of game i on a uniformly random free cell, returns false if there is none left
+    bool spawnFood(size_t i)
+    {
+      const uint64_t *plane = &occupancy[i * plane_words];
+      size_t free_cells = interior - (Collision::ENABLED ? length[i] : covered[i]);
+      if (free_cells == 0) return false;
+
+      //Draw random interior cells until a free one comes up, a few tries are enough unless the board is nearly full
+      for (int attempt = 0; attempt < 32; attempt++) {
+        uint32_t pick = rng[i].range(uint32_t(interior));
+        int r = int(pick / (board_columns - 2)) + 1;
+        int c = int(pick % (board_columns - 2)) + 1;
+        size_t cell = size_t(r) * board_columns + c;
+        if (!((plane[cell >> 6] >> (cell & 63)) & 1)) {
+          food_row[i] = r;
+          food_column[i] = c;
+          return true;
+        }
+      }
+
+      //Nearly full board: pick the n-th free cell
+      size_t n = rng[i].range(uint32_t(free_cells));
+      for (int r = 1; r < board_rows - 1; r++) {
+        for (int c = 1; c < board_columns - 1; c++) {
+          size_t cell = size_t(r) * board_columns + c;
+          if ((plane[cell >> 6] >> (cell & 63)) & 1) continue;
+          if (n-- == 0) {
+            food_row[i] = r;
+            food_column[i] = c;
+            return true;
+          }
+        }
+      }
+      return false;
+    }
+};
+
+//The normal rules: solid walls and self collision
+using GameBatch = BasicGameBatch<>;
+
+#endif
@@ -18,7 +18,21 @@
 #include <unistd.h>
 #include <exception>
 #include <random>
+#include <cstdlib>
+#include <sstream>
+#include <iomanip>
 #include "TControl.hpp"
+#include "GameTimer.hpp"
+#include "Engine.hpp"
+#include "Arena.hpp"
+#include "Bitboard.hpp"
+#include "MultiGame.hpp"
+#include "World.hpp"
+#include "Replay.hpp"
+#include "Rewind.hpp"
+#include "Netplay.hpp"
+#include "SaveGame.hpp"
+#include "Profiler.hpp"
 
 using namespace std;
 using ipair = pair<int, int>; //Type alias for integer pairs
@@ -36,8 +50,12 @@ char SNAKE_BODY_CHAR = '*';
 char GRID_BORDER = '#';
 char CURSOR_CHAR = '>';
 char PAUSE_KEY = 'p';
+char REWIND_KEY = 'r'; //Held down during a game to scrub back through the last REWIND_SECONDS
+char OVERLAY_KEY = 'o'; //Shows or hides the frame timing overlay during a game
 char POWERUP_1_CHAR = '+';
 char POWERUP_2_CHAR = 'x';
+char POWERUP_3_CHAR = '-';
+char POWERUP_4_CHAR = '$';
 
 //Gameplay defaults
 int INITIAL_SPEED = 200;
@@ -49,6 +67,46 @@ bool ENABLE_POWERUPS = true;
 int POWERUP_TIME = 10;
 int POWERUP_SPAWN_TIME = 15;
 int SLOW_MO_POWERUP_INCREMENT = 2;
+int FOOD_COUNT = 1; //Food items on the board at once
+int MAX_POWERUPS = 1; //Most powerups on the board at once
+bool ENABLE_SHRINK_POWERUP = true;
+bool ENABLE_DOUBLE_SCORE_POWERUP = true;
+
+//Runtime flags
+bool HEADLESS = false; //Set by --headless, games run without reading input or waiting between frames
+int TICK_RATE = 0; //Set by --tick-rate, simulation ticks per second overriding the game speed (0 uses the game speed)
+int RENDER_RATE = 60; //Set by --render-rate, frames drawn to console per second
+bool FIXED_SEED = false; //Set by --seed or --daily, every game starts from GAME_SEED instead of a fresh random seed
+uint64_t GAME_SEED = 0;
+string RECORD_PATH = ""; //Set by --record, every game is saved as a replay to this file
+string AUTOPILOT_BOT = ""; //Set by --autopilot or --bot, this bot (one of BOT_NAMES) steers the snake instead of the keyboard
+int MULTI_PLAYERS = 2; //Set by --players, local players in a multi-snake game (at most one per entry of PLAYER_KEYS)
+int MULTI_BOTS = 4; //Set by --bots, bot snakes in a multi-snake game
+string NET_ADDRESS = ""; //Set by --host or --join, where a networked game is hosted
+int NET_PLAYERS = 2; //Set by --net-players, players a hosted networked game waits for (the host included)
+int INPUT_DELAY = 2; //Set by --input-delay, ticks between a key press and its turn in a hosted networked game
+int WORLD_ROWS = 1000; //Set by --world-rows, rows of the world in world mode (at least the size of the board on screen)
+int WORLD_COLUMNS = 3000; //Set by --world-cols, columns of the world in world mode
+const int MAX_REWIND_SECONDS = 3600; //Most seconds --rewind-seconds keeps, an hour of play
+int REWIND_SECONDS = 10; //Set by --rewind-seconds, seconds of game time kept to rewind and watch again (0 turns rewinding off)
+string LEVEL_PACK_PATH = ""; //Set by --levels, games are played on a level of this level pack instead of the plain board
+int LEVEL_NUMBER = 0; //Set by --level, the level of the pack to play, counting from 0
+string SAVE_PATH = string(getenv("HOME") ? getenv("HOME") : ".") + "/.ascii_snake_save"; //Set by --save, where SAVE AND QUIT leaves the game to resume
+bool PROFILE = false; //Set by --profile, headless games are timed too and the timings are printed on exit
+bool PROFILE_OVERLAY = false; //Set by --profile and toggled with OVERLAY_KEY, the frame timings are shown next to the scoreboard
+FrameProfiler FRAME_PROFILE; //Timings of every game played this session (see playGame)
+
+//Keys of each local player in a multi-snake game, in up, left, down, right order
+const vector<string> PLAYER_KEYS = {"wasd", "ijkl", "tfgh", "8456"};
+//Foreground colors of the snakes in a multi-snake game, snake i takes color i (wrapping around), players come first
+const vector<int> SNAKE_COLORS = {231, 46, 33, 226, 196, 201, 51, 208};
+
+//Returns the head character of a snake going in a direction, indexed by its Direction (the head faces right if it has none)
+char headCharOf(char direction)
+{
+  const char heads[5] = {SNAKE_HEAD_UP, SNAKE_HEAD_LEFT, SNAKE_HEAD_DOWN, SNAKE_HEAD_RIGHT, SNAKE_HEAD_RIGHT};
+  return heads[directionOf(direction)];
+}
 /*
 The CharStyle struct presents a cleaner way to store format presets
 */
@@ -79,7 +137,10 @@ CharStyle SNAKE_FOOD(false, false, false, false, 231, 233);
 CharStyle BARRIER(false, false, false, false, 231, 23);
 CharStyle POWERUP1(false, false, false, false, 231, 232);
 CharStyle POWERUP2(false, false, false, false, 231, 232);
+CharStyle POWERUP3(false, false, false, false, 231, 232);
+CharStyle POWERUP4(false, false, false, false, 231, 232);
 CharStyle BACKGROUND(false, false, false, false, 231, 232);
+CharStyle GHOST_SNAKE(false, false, false, false, 242, 232); //The ghost of a recorded game in a ghost race, faint on the background
 //************************************************************************************//
 
 /*
@@ -237,7 +298,10 @@ void intInputMenu(string text, Terminal& t, int& to_set);
 void boolInputMenu(string text, Terminal& t, bool& to_set);
 void charInputMenu(string text, Terminal& t, char& to_set);
 void styleInputMenu(string text, Terminal& t, CharStyle& to_edit);
-void pauseMenu(string text, Terminal& t, bool& game_state);
+void pauseMenu(string text, Terminal& t, bool& game_state, bool* save=nullptr);
+void winMenu(Terminal& t, int score);
+bool gameOverMenu(Terminal& t, int score, size_t space, size_t free_cells, bool can_rewind=false);
+void messageMenu(Terminal& t, const vector<string>& text);
 void styleEditorMenu(Terminal &t);
 void settingsEditorMenu(Terminal &t);
 
@@ -276,6 +340,20 @@ class ScoreBoard
       return;
     }
 
+    /*
+    Sets the current score, for games where eating can be worth more than one point
+
+    Params: 1 integer
+    int, score: The score to show
+
+    Returns: Void
+    */
+    void setScore(int score){
+      current_score = score;
+      if (current_score>high_score) {high_score = current_score;}
+      return;
+    }
+
     /*
     Sets the current speed to be displayed under the current speed section
 
@@ -288,9 +366,28 @@ class ScoreBoard
       return;
     }
 
+    /*
+    Sets the lines shown at the right end of the scoreboard rows (at most 2, an empty list hides them), used for the
+    frame timing overlay
+
+    Params: 1 string vector
+    vector<string>, lines: The lines to show
+
+    Returns: Void
+    */
+    void setOverlay(const vector<string>& lines){
+      overlay = lines;
+      return;
+    }
+
+    //Returns the current score
+    int getScore() const {return current_score;}
+
   private:
     int current_score = 0;
     int current_speed = 0;
+    vector<string> overlay;
+    size_t overlay_width[2] = {0, 0}; //Width of the overlay lines last drawn, blanked before drawing new ones
     int& high_score;
     Terminal& t;
 
@@ -326,416 +423,353 @@ class ScoreBoard
         current_column++;
       }
 
+      //The overlay lines end one column short of the right edge, whatever was there before is blanked first
+      for (int row = 0; row < 2; row++){
+        string line = row < int(overlay.size()) ? overlay[row] : "";
+        size_t width = max(line.size(), overlay_width[row]);
+        line.insert(0, width - line.size(), ' ');
+        current_column = t.getColumns() - 1 - int(width);
+        for (char c:line){
+          t.setChar(row, current_column, c, SCOREBOARD.bold, SCOREBOARD.italic, SCOREBOARD.underline, SCOREBOARD.blinking, SCOREBOARD.fg_color, SCOREBOARD.bg_color);
+          current_column++;
+        }
+        overlay_width[row] = row < int(overlay.size()) ? overlay[row].size() : 0;
+      }
+
       return;
     };
     
 };
 
+//Char and style each item type is drawn with, indexed by item type
+char* const ITEM_CHARS[ITEM_TYPES] = {&FOOD_CHAR, &POWERUP_1_CHAR, &POWERUP_2_CHAR, &POWERUP_3_CHAR, &POWERUP_4_CHAR};
+CharStyle* const ITEM_STYLES[ITEM_TYPES] = {&SNAKE_FOOD, &POWERUP1, &POWERUP2, &POWERUP3, &POWERUP4};
+
 //************************************************************************************//
 
 /*
-    Snake Class:
-    represents the snake and all of its functions. Responsible for: moving (changing the snake coordinates) up, down, left, and right;
-    displaying (drawing) the snake onto the 'field' (grid). Detecting collision for the snake (both with itself and with the borders);
-    and growing the snake (increasing its body size). 
+  sets the display size for the game itself, used to create the boundaries
+  and properly set the boundary collision.
+*/
+ipair setBoundary(ipair screen_size)
+{
+  int rows = screen_size.first - 1;
+  int columns = screen_size.second - 1;
+  return {rows, columns};
+}
+
+//Function prototypes for snake game logic
+class GhostSnake;
+bool playGame(GameState &game, Terminal &t, ScoreBoard& sb, ReplayLog *recording=nullptr, const ReplayLog *playback=nullptr, RewindBuffer *rewind=nullptr, GhostSnake *ghost=nullptr);
+void createGrid(ipair screensize, Terminal &t);
+int tilesPerSecond(int game_speed);
+
+/*
+    GameRenderer Class:
+    Draws a GameState onto the Terminal. The game itself knows nothing about the display, the renderer observes the result
+    of every tick and only sets the cells that changed: the previous position of the tail is erased (if the tail moved),
+    the segment behind the head becomes a body segment, the head is drawn according to its direction, cells cut off by a
+    shrink powerup are erased, and every item that spawned is drawn with the char and style of its type. Board coordinates are shifted down by BOARD_TOP_ROW to make room for the scoreboard.
+    The changes are printed with the next rendered frame.
 */
-class Snake
+class GameRenderer
 {
-private:
-  pvector body; //Vector of pairs to store the coordinates of the snake's body segments
-  char direction; //Current direction of the snake ('a' for left, 'd' for right, 'w' for up, 's' for down)
-  ipair prevTailPosition; //Previous position of the tail segment
-  Terminal &t; //Terminal reference
-  ipair screen_size; //screensize reference
-
-public:
-   /*
-    Constructor for Snake class
-    Params: 1 reference, 1 pair, 2 integers, 1 character
-    Terminal &terminal : reference to terminal object
-    ipair display_size : pair that contains the terminal/display size
-    int init_row : initial row for spawning
-    int init_column : initial column for spawning
-    char init_direction : initial direction of the snake
+  public:
+    /*
+    Constructor for GameRenderer
+
+    Params: 1 Terminal reference, 1 ScoreBoard reference
+    Terminal, terminal: The terminal to draw to
+    ScoreBoard, scoreboard: The scoreboard to keep up to date with the score and speed
     */
-  Snake(Terminal &terminal, ipair display_size, int init_row, int init_column, char init_direction)
-  : t(terminal), screen_size(display_size)
-  {
-    //Initialize the snake with a single body segment at the starting position
-    body.push_back({init_row, init_column});
-    direction = init_direction;
-    prevTailPosition = {init_row, init_column};
-  }
+    GameRenderer(Terminal &terminal, ScoreBoard &scoreboard) : t(terminal), sb(scoreboard) {};
 
-  //Function to move the snake in the current direction
-  void move()
-  {
-    //Calculate the offset for the new head position based on the current direction
-    int row_offset = 0, column_offset = 0;
-    switch (direction)
-    {
-    case 'a': //Left
-      row_offset = 0;
-      column_offset = -1;
-      break;
-    case 'd': //Right
-      row_offset = 0;
-      column_offset = 1;
-      break;
-    case 'w': //Up
-      row_offset = -1;
-      column_offset = 0;
-      break;
-    case 's': //Down
-      row_offset = 1;
-      column_offset = 0;
-      break;
-    }
-
-    //Update the previous position of the tail segment
-    prevTailPosition = body.back();
-
-    //Update the positions of the body segments to follow the head
-    for (size_t i = body.size() - 1; i > 0; --i)
-    {
-      body[i] = body[i - 1];
-    }
-
-    //Calculate updated position of the head.
-    ipair &head = body.front();
-    head.first += row_offset;
-    head.second += column_offset;
-  }
+    /*
+    Draws the changes of a single tick
 
-  //Function to change the direction of the snake
-  void changeDirection(char new_direction)
-  {
-    //Messy ifs, Only change direction is it is not opposite to the current direciton
-    if (!((new_direction == 'w' && direction == 's')||(new_direction == 's' && direction == 'w'))){
-      if (!((new_direction == 'a' && direction == 'd')||(new_direction == 'd' && direction == 'a'))) {
-        //Update the direction
-        direction = new_direction;
+    Params: 1 GameState, 1 StepResult
+    GameState, game: The game after the tick
+    StepResult, result: What changed during the tick
+
+    Returns: Void
+    */
+    void update(const GameState &game, const StepResult &result)
+    {
+      const SnakeBody &body = game.getBody();
+
+      //Erase the previous position of the tail segment first, the head may have just moved into it
+      //A segment still overlapping the cell (while self collision is off) keeps it drawn
+      if (result.tail_moved && !game.occupies(result.prev_tail)) setBlank(result.prev_tail);
+      if (result.shrunk) for (const ipair &cell:game.getShrunkCells()) if (!game.occupies(cell)) setBlank(cell);
+
+      //The old head is now the first body segment
+      if (body.size() > 1) setBodySegment(body[1]);
+      drawHead(body.front(), game.getDirection());
+
+      for (const Item &item:game.getSpawnedItems()) drawItem(item);
+
+      //Tell scoreboard to update
+      if (result.ate_food) sb.setScore(game.getScore());
+      if (result.ate_food || result.speed_changed)
+      {
+        sb.setSpeed(tilesPerSecond(game.getSpeed()));
+        sb.updateTerminal();
       }
+      return;
     }
-  }
-  /*
-    drawSnake Function:
-    This function is responsible for drawing the snake on a terminal screen. It takes the snake object and a terminal object as parameters.
-    It iterates through the snake's body segments, drawing each segment using a specified character for the body.
-    It also draws the head of the snake according to its direction, using different characters for each direction.
-    The function erases the previous position of the snake's tail segment and then draws the updated grid with the snake.
-  */
-  void drawSnake()
-  {
-    //Define the characters to represent the snake's body
-    char headChar;
-    switch (getDirection())
-    {
-    case 'a': //Left
-      headChar = SNAKE_HEAD_LEFT;
-      break;
-    case 'd': //Right
-      headChar = SNAKE_HEAD_RIGHT;
-      break;
-    case 'w': //Up
-      headChar = SNAKE_HEAD_UP;
-      break;
-    case 's': //Down
-      headChar = SNAKE_HEAD_DOWN;
-      break;
-    default: //Raise error if invalid head direction is found
-      cerr << "Current head direction: " << getDirection();
-      throw logic_error("Invalid head direction while drawing snake");
-    }
-
-    //Draw body segments (if there are any)
-    for (const ipair &segment:body) {
-      t.setChar(segment.first, segment.second, SNAKE_BODY_CHAR, SNAKE_BODY.bold, SNAKE_BODY.italic, SNAKE_BODY.underline, SNAKE_BODY.blinking, SNAKE_BODY.fg_color, SNAKE_BODY.bg_color);
+
+    /*
+    Draws the whole game, used when the game starts and when the grid was wiped (e.g. after returning from the pause menu)
+
+    Params: 1 GameState
+    GameState, game: The game to draw
+
+    Returns: Void
+    */
+    void redraw(const GameState &game)
+    {
+      const GameConfig &config = game.getConfig();
+      createGrid({config.rows, config.columns}, t);
+      drawLevel(game.getLevel());
+      for (const ipair &segment:game.getBody()) setBodySegment(segment);
+      drawHead(game.getBody().front(), game.getDirection());
+      for (const Item &item:game.getItems()) drawItem(item);
+      sb.setSpeed(tilesPerSecond(game.getSpeed()));
+      sb.updateTerminal();
+      overlay.clear();
+      return;
     }
-    
-    //Draw the snake's head
-    const ipair& headPos = body.front();
-    t.setChar(headPos.first, headPos.second, headChar, SNAKE_HEAD.bold, SNAKE_HEAD.italic, SNAKE_HEAD.underline, SNAKE_HEAD.blinking, SNAKE_HEAD.fg_color, SNAKE_HEAD.bg_color);
 
-    //Erase the previous position of the tail segment
-    ipair prevTailPosition = getPrevTailPos();
-    t.setChar(prevTailPosition.first, prevTailPosition.second, ' ', false, false, false, false, 0, BACKGROUND.bg_color);
+    /*
+    Draws a frame of the game's rewind history in place of what is on the board, the cells the last frame (or the game)
+    covered are restored first so only the cells that differ get printed
 
-    //Draw the updated grid with the snake
-    t.draw();
-  }
-  /*
-    checkSelfCollision Function:
-    This function checks for self-collision of the snake, meaning if the snake's head collides with any
-    part of its body. It takes the snake object as a parameter. It iterates through the snake's body
-    segments (starting from the second segment) and compares the segment coordinates with the head's coordinates.
-    If a match is found, indicating a collision, it returns true. Otherwise, it returns false, indicating
-    no collision.
-  */
-  bool checkSelfCollision() const
-  {
-    //Get the coordinates of the head
-    ipair head = body.front();
-    //Iterate over the body segments starting from the third segment
-    for (auto i = body.begin() + 1; i != body.end(); i++)
+    Params: 1 GameState, 1 RewindFrame
+    GameState, game: The game the history belongs to
+    RewindFrame, frame: The frame to show
+
+    Returns: Void
+    */
+    void drawFrame(const GameState &game, const RewindFrame &frame)
     {
-      //If the coordinates of the current segment match the head's coordinates, return true
-      if (*i == head)
-      {
-        //Only report self collision if SELF_COLLISION flag is true
-        if (SELF_COLLISION){
-          return true;
-        } else return false;
-      }
+      if (overlay.empty()) coverGame(game);
+      clearOverlay(game.getLevel());
+      for (const ipair &segment:frame.body) setBodySegment(segment);
+      drawHead(frame.body.front(), frame.direction);
+      for (const Item &item:frame.items) drawItem(item);
+      for (const ipair &segment:frame.body) overlay.push_back(segment);
+      for (const Item &item:frame.items) overlay.push_back(item.cell);
+      sb.setScore(frame.score);
+      sb.updateTerminal();
+      return;
     }
 
-    //No collision detected
-    return false;
-  }
+    /*
+    Puts the game back on the board after frames of its history were shown
 
-  /*
-    checkBoundaryCollision Function:
-    This function checks for boundary collision of the snake, meaning if the snake's head moves beyond
-    the boundaries of the game screen. It takes the snake object and the screen size as parameters.
-    It retrieves the coordinates of the snake's head and calculates the boundary based on the screen size.
-    It then checks if the head's coordinates exceed the boundaries. If a collision is detected, it returns
-    true; otherwise, it returns false, indicating no collision.
-  */
-  bool checkBoundaryCollision()
-  {
-    //Get the coordinates of the head
-    ipair head = body.front();
-    ipair boundary = screen_size;
-    //Check if the head's coordinates exceed the boundaries
-    if (head.first == 3 || head.first == boundary.first || head.second == 0 || head.second == boundary.second)
+    Params: 1 GameState
+    GameState, game: The game
+
+    Returns: Void
+    */
+    void showGame(const GameState &game)
     {
-      return true; //Collision detected
+      clearOverlay(game.getLevel());
+      for (const ipair &segment:game.getBody()) setBodySegment(segment);
+      drawHead(game.getBody().front(), game.getDirection());
+      for (const Item &item:game.getItems()) drawItem(item);
+      sb.setScore(game.getScore());
+      sb.updateTerminal();
+      return;
     }
-    //No collision detected
-    return false;
-  }
-  //Function to retrieve the snake's body
-  const pvector &getBody() const
-  {
-    return body;
-  }
 
-  //Function to retrieve the previous position of the tail segment
-  ipair getPrevTailPos() const
-  {
-    return prevTailPosition;
-  }
+  private:
+    Terminal &t;
+    ScoreBoard &sb;
+    vector<ipair> overlay; //Cells covered by the frame of the history on the board
 
-  //Function to retrieve the current direction of the snake
-  char getDirection() const
-  {
-    return direction;
-  }
+    //Notes the cells the game covers, the first frame drawn over it clears them
+    void coverGame(const GameState &game)
+    {
+      for (const ipair &segment:game.getBody()) overlay.push_back(segment);
+      for (const Item &item:game.getItems()) overlay.push_back(item.cell);
+      return;
+    }
 
-  //Function to make the snake grow by adding a new segment
-  void grow()
-  {
-    //Get the last segment of the snake's body
-    const ipair &tailSegment = body.back();
-
-    //Calculate the position for the new segment
-    int new_row = tailSegment.first;
-    int new_column = tailSegment.second;
-
-    //Add the new segment in a position adjacent to the tail segment, depending on the direction
-    switch (direction)
-    {
-    case 'a':    //Left
-      new_column += 1; //Move the new segment one column to the left
-      break;
-    case 'd':    //Right
-      new_column -= 1; //Move the new segment one column to the right
-      break;
-    case 'w':    //Up
-      new_row += 1; //Move the new segment one row up
-      break;
-    case 's':    //Down
-      new_row -= 1; //Move the new segment one row down
-      break;
-    }
-
-    ///Add the new body segment to the end of the snake body vector, effectively extending the tail/end.
-    body.push_back({new_row, new_column});
-  }
-};
+    //Restores the cells of the overlay to the level underneath, a head that crashed may have covered a wall
+    void clearOverlay(const Level &level)
+    {
+      for (const ipair &cell:overlay)
+      {
+        uint8_t tile = level.getTile(cell);
+        if (tile == TILE_FLOOR) setBlank(cell);
+        else t.setChar(cell.first + BOARD_TOP_ROW, cell.second, tile == TILE_WALL ? GRID_BORDER : char(tile), BARRIER.bold, BARRIER.italic, BARRIER.underline, BARRIER.blinking, BARRIER.fg_color, BARRIER.bg_color);
+      }
+      overlay.clear();
+      return;
+    }
 
-/*
-  sets the display size for the game itself, used to create the boundaries
-  and properly set the boundary collision.
-*/
-ipair setBoundary(ipair screen_size)
-{
-  int rows = screen_size.first - 1;
-  int columns = screen_size.second - 1;
-  return {rows, columns};
-}
+    void setBlank(ipair cell)
+    {
+      t.setChar(cell.first + BOARD_TOP_ROW, cell.second, ' ', false, false, false, false, 0, BACKGROUND.bg_color);
+    }
 
-//Function prototypes for snake game logic
-void playGame(Snake &snake, Terminal &t, ipair screensize, ScoreBoard& sb);
-void displayHeader(Snake &snake, Terminal&t, ipair screensize);
-void createGrid(ipair screensize, Terminal &t);
+    void setBodySegment(ipair cell)
+    {
+      t.setChar(cell.first + BOARD_TOP_ROW, cell.second, SNAKE_BODY_CHAR, SNAKE_BODY.bold, SNAKE_BODY.italic, SNAKE_BODY.underline, SNAKE_BODY.blinking, SNAKE_BODY.fg_color, SNAKE_BODY.bg_color);
+    }
 
-/*
-    Food Struct:
-    Represents 'food' in the snake game. It has a position defined by row and column coordinates.
-    The spawn method randomly selects and draws the food within the grid boundaries, making sure that the coordinates of the food 
-    do not collide with the coordinates of the snake. checkCollision method determines if the food collides with the snake by comparing 
-    its coordinates with the coordinates of the snake's body segments.
-*/
-struct Food
-{
-  int row = -1;
-  int col = -1;
-  Snake &snake;
-  Terminal &t;
+    //Draws the snake's head according to its direction
+    void drawHead(ipair head, char direction)
+    {
+      //Raise error if invalid head direction is found
+      if (directionOf(direction) == NO_DIRECTION)
+      {
+        cerr << "Current head direction: " << direction;
+        throw logic_error("Invalid head direction while drawing snake");
+      }
+      char headChar = headCharOf(direction);
 
-  //constructor for Food structure
-  Food(Snake &s, Terminal &terminal) : snake(s), t(terminal){}
+      t.setChar(head.first + BOARD_TOP_ROW, head.second, headChar, SNAKE_HEAD.bold, SNAKE_HEAD.italic, SNAKE_HEAD.underline, SNAKE_HEAD.blinking, SNAKE_HEAD.fg_color, SNAKE_HEAD.bg_color);
+    }
 
-  //Method to spawn food at a random location on the grid
-  void spawn(ipair boundary)
-  {
-    do{
-      row = rand() % (boundary.first - 4) + 4;
-      col = rand() % (boundary.second - 1) + 1;
-    }while(checkCollision());
-    t.setChar(row, col, FOOD_CHAR, SNAKE_FOOD.bold, SNAKE_FOOD.italic, SNAKE_FOOD.underline, SNAKE_FOOD.blinking, SNAKE_FOOD.fg_color, SNAKE_FOOD.bg_color);
-  }
+    //Draws an item with the 'graphic' (char) and style of its type
+    void drawItem(const Item &item)
+    {
+      char c = *ITEM_CHARS[item.type];
+      const CharStyle &style = *ITEM_STYLES[item.type];
+      t.setChar(item.cell.first + BOARD_TOP_ROW, item.cell.second, c, style.bold, style.italic, style.underline, style.blinking, style.fg_color, style.bg_color);
+    }
 
-  //Method to check the food collision with the snake
-  bool checkCollision() const
-  {
-    //Iterate over the snake's body and check if any segment matches the food's position
-    for (const ipair &segment : snake.getBody())
+    //Draws the walls and portals inside the border from the level's render layer, walls as the barrier and portals as their letter
+    void drawLevel(const Level &level)
     {
-      if (row == segment.first && col == segment.second)
+      for (int r = 1; r < level.getRows() - 1; r++)
       {
-        return true; //Collision detected
+        for (int c = 1; c < level.getColumns() - 1; c++)
+        {
+          uint8_t tile = level.getTile({r, c});
+          if (tile == TILE_FLOOR) continue;
+          char glyph = tile == TILE_WALL ? GRID_BORDER : char(tile);
+          t.setChar(r + BOARD_TOP_ROW, c, glyph, BARRIER.bold, BARRIER.italic, BARRIER.underline, BARRIER.blinking, BARRIER.fg_color, BARRIER.bg_color);
+        }
       }
     }
-    return false; //No collision
-  }
 };
+
 /*
-    Powerups Struct:
-    Represents powerups in the snake game. It has a position defined by row and column coordinates.
-    checkCollision function is identical to the food struct checkCollision function. activatePowerUp
+    GhostSnake Class:
+    The ghost of a recorded game raced alongside a live one. The ghost is a GameState of its own, played from a
+    ReplayStream whose inputs are decoded as the ghost reaches them, and kept level with the live game in game time so
+    it moves as fast as the recorded snake did. It is drawn like GameRenderer draws a snake, only the cells that changed
+    each tick, faintly and underneath the live game: it only shows on cells where the live game has nothing, and the
+    cells the live snake leaves are given back to it. Once the recorded game is over the ghost is taken off the board.
 */
-struct Powerups
+class GhostSnake
 {
-  int row = -1;
-  int col =-1;
-  int type;
-  bool powerUpActive;
-  bool initialPowerUpSpawned = false;
-  bool &isPowerUpSpawned;
-  time_t powerUpActivationTime;
-  Snake &snake;
-  Terminal &t;
-  
-  //Constructor for Powerups structure
-  Powerups(Snake &s, Terminal &terminal, bool &powerUpSpawned) : snake(s), t(terminal), isPowerUpSpawned(powerUpSpawned){}
-
-  /*
-      checkCollision: iterates through the body of the snake and checks to see if any of body coordinates intersect with the coordinates of the powerup
-      returns true if so, returns false otherwise.
-  */
-  bool checkCollision() const
-  {
-    //Iterate over the snake's body and check if any segment matches the Powerup's position
-    for (const ipair &bodySegment : snake.getBody())
+  public:
+    /*
+    Constructor for GhostSnake
+
+    Params: 1 Terminal reference, 1 ReplayStream reference, 1 Level
+    Terminal, terminal: The terminal to draw to
+    ReplayStream, replay: The recorded game, from its first tick
+    Level, level: The level it was played on (empty for the plain board)
+    */
+    GhostSnake(Terminal &terminal, ReplayStream &replay, const Level &level) : t(terminal), stream(replay), ghost(replay.getConfig(), level) {};
+
+    /*
+    Plays the ghost up to the game time of the live game after its tick, and draws what changed for both
+
+    Params: 1 GameState, 1 StepResult
+    GameState, live: The live game after the tick
+    StepResult, result: What changed in the live game during the tick
+
+    Returns: Void
+    */
+    void update(const GameState &live, const StepResult &result)
     {
-      if (row == bodySegment.first && col == bodySegment.second)
+      while (ghost.isAlive() && ghost.getGameTime() < live.getGameTime()) step(live);
+      if (!shown || HEADLESS) return;
+      if (!ghost.isAlive())
       {
-        return true; //Collision detected
+        //The recorded game is over, the ghost leaves the board
+        for (const ipair &segment:ghost.getBody()) erase(segment, live);
+        shown = false;
+        return;
       }
+      //The live game erased the cells it left, the ghost may still be lying on them
+      if (result.tail_moved && ghost.occupies(result.prev_tail)) drawCell(result.prev_tail, live);
+      for (const ipair &cell:live.getShrunkCells()) if (ghost.occupies(cell)) drawCell(cell, live);
+      return;
     }
-    return false; //No collision
-  }
-  /*
-      activatePowerUp: takes two reference variables (the game speed and the self collision flag) as parameters. 
-      Applies the effects of each power up depending on the integer variable type (can be 1 or 2, indicating which power up is on the board).
-      Then, it flags powerUpActive (indicating that a power up effect is currently being applied) and stores the time that the power up was activated.
-  */
-  void activatePowerUp(int &game_speed, bool &SELF_COLLISION)
-  {
-    if(type == 1) game_speed *= SLOW_MO_POWERUP_INCREMENT;
-    else if(type == 2) SELF_COLLISION = false;
-    powerUpActive = true;
-    powerUpActivationTime = time(NULL);
-  }
-  /*
-      deactivatePowerUp: takes two reference variables (the game speed and self collision flag) as parameters.
-      Reverses the effects of the active power up (defined as variable type). For the Slow-mo powerup (type = 1),
-      it first checks to make sure that reverting the speed won't cause it to go past the maximum speed. If so, it sets
-      the game speed to the maximum speed. Then, it sets the active power up flag (powerUpActive) to false, indicating that a power up is no
-      longer being applied.
-  */
-  void deactivatePowerUp(int &game_speed, bool &SELF_COLLISION)
-  {
-    if(type == 1){
-      if(game_speed / SLOW_MO_POWERUP_INCREMENT > MAX_SPEED){
-        game_speed = int(game_speed / SLOW_MO_POWERUP_INCREMENT);
+
+    /*
+    Draws the whole ghost, used after the live game was redrawn
+
+    Params: 1 GameState
+    GameState, live: The live game
+
+    Returns: Void
+    */
+    void redraw(const GameState &live)
+    {
+      if (!shown || HEADLESS) return;
+      for (const ipair &segment:ghost.getBody()) drawCell(segment, live);
+      return;
+    }
+
+    //Returns the recorded game as far as the ghost got
+    const GameState& getGame() const {return ghost;}
+
+  private:
+    Terminal &t;
+    ReplayStream &stream;
+    GameState ghost;
+    bool shown = true; //The ghost is on the board, cleared once the recorded game is over
+
+    //Advances the ghost one tick with the recorded inputs and draws the cells that changed under it
+    void step(const GameState &live)
+    {
+      ReplayEvent event;
+      while (stream.next(ghost.getTick(), event))
+      {
+        if (event.type == REPLAY_DIRECTION) ghost.setDirection(event.direction);
+        else if (event.type == REPLAY_QUIT) ghost.end();
       }
-      else game_speed = MAX_SPEED;
+      //The ghost never runs past the tick its game ended on
+      if (ghost.getTick() >= stream.getTicks()) ghost.end();
+      if (!ghost.isAlive()) return;
+
+      StepResult result = ghost.step();
+      if (!shown || HEADLESS) return;
+      if (result.tail_moved && !ghost.occupies(result.prev_tail)) erase(result.prev_tail, live);
+      for (const ipair &cell:ghost.getShrunkCells()) if (!ghost.occupies(cell)) erase(cell, live);
+      const SnakeBody &body = ghost.getBody();
+      if (body.size() > 1) drawCell(body[1], live);
+      drawCell(body.front(), live);
+      return;
     }
-    else if(type == 2) SELF_COLLISION = true;
-    powerUpActive = false;
-  }
-  /*
-    powerUpExpired: subtracts the time that the power up was activated (powerUpActivationTime) from the current time, checking to see if 
-    the result is greater than (or equal to) the amount of time the power up effects last. If so, then it returns true, meaning the power up has been applied for 
-    the designated amount of seconds. Otherwise, returns false.
-  */
-  bool powerUpExpired() const {
-     return time(NULL) - powerUpActivationTime >= POWERUP_TIME;
-  }
-  /*
-    respawnPowerUpTimer: similar to powerUpExpired, subtracts time that power up was activated from the current time, checking to see if 
-    the result is greater than the amount of time the power up effect lasts, plus the designated amount of time in between respawns (so that way power ups spawn a certain amount of 
-    time after the power up effect has worn off). Returns true if so, indicating that enough time has passed for a power up to spawn.
-  */
-  bool respawnPowerUpTimer() const {
-    return time(NULL) - powerUpActivationTime >= POWERUP_TIME + POWERUP_SPAWN_TIME;
-  }
-  /*
-    shouldPowerUpSpawn: uses multiple methods to determine whether a powerup is able to spawn. First checks to make sure the user has enabled powerups in-game. If so, it checks
-    to see if the initial power up has been spawned. If it has, it then checks to see: if there a power up is currently applied to the user and if enough time has passed for a respawn
-    to occur and if a power up is already spawned on the board (and hasn't been consumed by the user). If none of these are true, returns false, indicating that a power up should not spawn.
-  */
-  bool shouldPowerUpSpawn() const{
-    //Checks to see if the user has enabled powerups in the game
-    if(!ENABLE_POWERUPS) return false;
-    //Checks to see if a powerup has been spawned (start of game).
-    else if(col == -1 && !initialPowerUpSpawned) return true;
-    //checks to see if a power up is currently active and if the time between spawns has been reached
-    else if(!powerUpActive && respawnPowerUpTimer() && !isPowerUpSpawned) return true;
-    //if none of these conditions are true, returns false.
-    else return false;
-  }
-  /*
-    spawn: checks to see if a powerup should spawn using the shouldPowerUpSpawn function. If so, it randomly chooces a row, column, and type of powerup to spawn, making sure
-    that the coordinates of the powerup does not intersect with the snake body. It then checks to see if the flag for the first power up spawn is true, if not, it sets it to true (indicating
-    that this is the first powerup spawned). It then checks the type to see which powerup 'graphic' (char) to spawn.
-  */
-  void spawn(ipair boundary){
-    if(shouldPowerUpSpawn()){
-      do{
-        row = rand() % (boundary.first - 4) + 4;
-        col = rand() % (boundary.second - 1) + 1;
-        type = rand() % 2 + 1;
-      }while(checkCollision());
-      if(!initialPowerUpSpawned) initialPowerUpSpawned = true;
-      if(type == 1) t.setChar(row, col, POWERUP_1_CHAR, POWERUP1.bold, POWERUP1.italic, POWERUP1.underline, POWERUP1.blinking, POWERUP1.fg_color, POWERUP1.bg_color);
-      else if(type == 2) t.setChar(row, col, POWERUP_2_CHAR, POWERUP2.bold, POWERUP2.italic, POWERUP2.underline, POWERUP2.blinking, POWERUP2.fg_color, POWERUP2.bg_color);
-      isPowerUpSpawned = true;
+
+    //Returns true if the live game shows nothing on a cell, the only cells the ghost is drawn on
+    bool isClear(ipair cell, const GameState &live) const
+    {
+      return !live.isBlocked(cell) && !live.occupies(cell) && !live.hasItem(cell);
+    }
+
+    //Draws the ghost's segment (or head) on a cell
+    void drawCell(ipair cell, const GameState &live)
+    {
+      if (!isClear(cell, live)) return;
+      char c = cell == ghost.getBody().front() ? headCharOf(ghost.getDirection()) : SNAKE_BODY_CHAR;
+      t.setChar(cell.first + BOARD_TOP_ROW, cell.second, c, GHOST_SNAKE.bold, GHOST_SNAKE.italic, GHOST_SNAKE.underline, GHOST_SNAKE.blinking, GHOST_SNAKE.fg_color, GHOST_SNAKE.bg_color);
+    }
+
+    //Takes the ghost off a cell it left
+    void erase(ipair cell, const GameState &live)
+    {
+      if (isClear(cell, live)) t.setChar(cell.first + BOARD_TOP_ROW, cell.second, ' ', false, false, false, false, 0, BACKGROUND.bg_color);
     }
-  }
 };
 
 //Snake game logic
@@ -773,130 +807,794 @@ void createGrid(ipair screen_size, Terminal &t)
 
   t.draw();
 }
+/*
+    captureConfig: takes a snapshot of the current gameplay settings, together with the display size and seed of a game.
+*/
+GameConfig captureConfig(ipair screen_size, uint64_t seed)
+{
+  GameConfig config;
+  config.rows = screen_size.first;
+  config.columns = screen_size.second;
+  config.seed = seed;
+  config.initial_speed = INITIAL_SPEED;
+  config.max_speed = MAX_SPEED;
+  config.speed_multiplier = SPEED_MULTIPLIER;
+  config.self_collision = SELF_COLLISION;
+  config.enable_powerups = ENABLE_POWERUPS;
+  config.powerup_time = POWERUP_TIME;
+  config.powerup_spawn_time = POWERUP_SPAWN_TIME;
+  config.slow_mo_increment = SLOW_MO_POWERUP_INCREMENT;
+  config.food_count = FOOD_COUNT > 0 ? FOOD_COUNT : 1;
+  config.max_powerups = MAX_POWERUPS;
+  config.powerup_types = (1 << SLOW_MO_POWERUP) | (1 << GHOST_POWERUP) | (ENABLE_SHRINK_POWERUP << SHRINK_POWERUP) | (ENABLE_DOUBLE_SCORE_POWERUP << DOUBLE_SCORE_POWERUP);
+  config.level_path = LEVEL_PACK_PATH;
+  config.level_index = LEVEL_NUMBER;
+  return config;
+}
+
+/*
+    tickInterval: returns the time between two simulation ticks in microseconds. Uses TICK_RATE when it is set,
+    otherwise the current game speed (milliseconds per tile).
+*/
+uint64_t tickInterval(int game_speed)
+{
+  if (TICK_RATE > 0) return 1000000 / TICK_RATE;
+  return uint64_t(game_speed) * 1000;
+}
+
+/*
+    tilesPerSecond: the speed shown on the scoreboard, the tick rate actually being simulated.
+*/
+int tilesPerSecond(int game_speed)
+{
+  if (TICK_RATE > 0) return TICK_RATE;
+  return 1000 / game_speed;
+}
+
+/*
+    frameOverlay: the two lines of the frame timing overlay, the tick rate the game really ran at against the rate it
+    should run at, the bytes of the median frame, and the median and 99th percentile work per frame in microseconds.
+*/
+vector<string> frameOverlay(const FrameProfiler &profile, double actual_rate, double nominal_rate)
+{
+  ostringstream rates;
+  rates << fixed << setprecision(1) << "TPS " << actual_rate << "/" << nominal_rate << " " << profile.getFrameBytes().percentile(50) << " B/F";
+  string times = "P50 " + to_string(profile.getFrameTimes().percentile(50) / 1000) + "US P99 " +
+                 to_string(profile.getFrameTimes().percentile(99) / 1000) + "US";
+  return {rates.str(), times};
+}
+
+/*
+    scrubRewind: shows the game's history going backwards for as long as the rewind key is held down. Terminals only send
+    the repeats of a held key, so every repeat steps back a tenth of a second of play and the key counts as released once
+    no repeat came for 600 milliseconds, then the game is put back on the board. The game doesn't run in the meantime.
+*/
+void scrubRewind(const GameState &game, const RewindBuffer &rewind, Terminal &t, GameRenderer &renderer)
+{
+  RewindFrame frame;
+  uint64_t view = game.getTick();
+  const uint64_t step = tilesPerSecond(game.getSpeed()) / 10 > 1 ? tilesPerSecond(game.getSpeed()) / 10 : 1;
+  GameClock held;
+  uint64_t last_press = 0;
+  bool pressed = true; //The press that started the scrub
+  while (pressed || held.elapsedMicros() - last_press < 600000)
+  {
+    if (pressed)
+    {
+      view = view > rewind.getFirstTick() + step ? view - step : rewind.getFirstTick();
+      if (rewind.seek(view, frame)) renderer.drawFrame(game, frame);
+      t.drawChanges();
+      last_press = held.elapsedMicros();
+    }
+    pressed = getInput() == REWIND_KEY;
+    if (!pressed) usleep(1000);
+  }
+  renderer.showGame(game);
+  t.drawChanges();
+  return;
+}
+
+/*
+    playPostMortem: plays the history of a finished game back at the speed it was played, up to the tick it ended on.
+    The frames come straight out of the rewind history, nothing is simulated again. Any key stops the playback.
+*/
+void playPostMortem(const GameState &game, const RewindBuffer &rewind, Terminal &t, ScoreBoard &sb)
+{
+  GameRenderer renderer(t, sb);
+  t.clearGrid();
+  renderer.redraw(game);
+  RewindFrame frame;
+  if (!rewind.seek(rewind.getFirstTick(), frame)) return;
+  renderer.drawFrame(game, frame);
+  t.drawChanges();
+
+  GameClock clock;
+  uint64_t next_tick = tickInterval(frame.speed);
+  while (frame.tick < rewind.getLastTick() && getInput() == 0)
+  {
+    //Every tick that came due is shown in one frame
+    bool changed = false;
+    while (next_tick <= clock.elapsedMicros() && rewind.next(frame))
+    {
+      next_tick += tickInterval(frame.speed);
+      changed = true;
+    }
+    if (changed)
+    {
+      renderer.drawFrame(game, frame);
+      t.drawChanges();
+    }
+    usleep(1000);
+  }
+  //Hold the last frame for a moment so the crash can be seen
+  if (frame.tick == rewind.getLastTick()) usleep(500000);
+  return;
+}
+
 /*
     playGame: Essentially puts all of the pieces together to run the game. 
+    The rules live in the GameState, which is advanced with step() once per tick. This function only paces the ticks,
+    reads the keyboard and hands the result of every tick to a GameRenderer, headless games skip the renderer entirely.
+    The simulation and the display run on separate cadences: simulation ticks are scheduled every tickInterval()
+    and frames every 1/RENDER_RATE seconds. A frame prints the latest state only, so any number of ticks between two
+    frames are coalesced into a single update of the changed characters.
+
+    If recording is given every input is logged to it, if playback is given the inputs come from that log instead of the keyboard.
+    The recording also gets the state hash every REPLAY_HASH_INTERVAL ticks, a playback stops at the first hash that
+    doesn't match its log, so a replay that went out of step ends on the tick it was found.
+    If rewind is given every tick is added to it, and holding REWIND_KEY scrubs back through it (the game waits meanwhile).
+    Games that aren't a playback can be left with SAVE AND QUIT from the pause menu, which writes them to SAVE_PATH.
+    If ghost is given it is played alongside the game and drawn underneath it, the game stays unaffected by it.
+    Every phase of the ticks and frames is timed into FRAME_PROFILE (headless games only with PROFILE set), see FramePhase,
+    and while PROFILE_OVERLAY is on (OVERLAY_KEY toggles it) the scoreboard shows the tick rate and frame timings.
+    With AUTOPILOT_BOT set that bot picks the direction before every tick instead, and is recorded like any other input.
+    Returns true if the game was won by filling the whole board.
 */
-void playGame(Snake &snake, Terminal &t, ipair screen_size, ScoreBoard &sb)
+bool playGame(GameState &game, Terminal &t, ScoreBoard &sb, ReplayLog *recording, const ReplayLog *playback, RewindBuffer *rewind, GhostSnake *ghost)
 {
-  
-  //Initialize random seed
-  srand(time(NULL));
-  //initializes the game speed to the customizable INITIAL_SPEED
-  int game_speed = INITIAL_SPEED;
-  //Fnitialies the grid boundaries
-  ipair boundary = setBoundary(screen_size);
-  //Flag to check whether the snake is alive, or if the game should be over.
-  bool alive = true;
-  //Flag to check whether the first (initial) powerup of the game has spawned.
-  bool initialPowerUpSpawned = false;
   //User input to change the direction of the snake.
-  char input = getInput();
-  //Flag to check whether there is a powerup on the 'field' or not
-  bool isPowerUpSpawned = false;
-  //Initializes food struct
-  Food food(snake, t);
-  //Initializes powerup struct
-  Powerups powerup(snake, t, isPowerUpSpawned);
-  //Draws the grid
-  createGrid(screen_size, t);
-  //Initial Speed
-  sb.setSpeed((1000/game_speed));
-  sb.updateTerminal();
+  char input = 0;
+  //Monotonic clock (frozen while paused) that paces the ticks and frames
+  GameClock game_clock;
+  //Bot steering the snake in autopilot mode
+  const bool use_pilot = !AUTOPILOT_BOT.empty() && !playback;
+  unique_ptr<Bot> pilot = use_pilot ? makeBot(AUTOPILOT_BOT, true) : nullptr;
+  //Draws the grid, the snake and the scoreboard
+  GameRenderer renderer(t, sb);
+  if (!HEADLESS) renderer.redraw(game);
+  if (ghost) ghost->redraw(game);
+  if (rewind) rewind->start(game);
+
+  //Timing costs a few clock readings per tick, which only shows when headless games run flat out
+  const bool profiling = PROFILE || !HEADLESS;
+  FrameProfiler &profile = FRAME_PROFILE;
+  //The overlay is refreshed twice a second, the real tick rate is measured between the ticks on either end of that window
+  //(clock time of the last tick and the tick count then) so it doesn't depend on how the window lines up with the ticks
+  uint64_t overlay_time = 0;
+  uint64_t last_tick_time = 0;
+  uint64_t window_tick_time = 0;
+  uint64_t window_tick = game.getTick() + 1; //The first window starts at the first tick, which runs right away
+  const uint64_t overlay_interval = 500000;
+
+  //Next playback event to apply, and the last direction written to the recording
+  size_t playback_event = 0;
+  char recorded_direction = game.getDirection();
+
+  //Clock time (in microseconds) at which the next simulation tick and the next frame are due
+  uint64_t next_tick = 0;
+  uint64_t next_render = 0;
+  const uint64_t render_interval = 1000000 / (RENDER_RATE > 0 ? RENDER_RATE : 60);
+  //Longest the simulation is allowed to fall behind before it skips ahead instead of catching up
+  const uint64_t max_lag = 250000;
 
   //Game loop, continually loops as long as the snake is alive
-  while (alive)
+  while (game.isAlive())
   {
-    //Move the snake
-    snake.move();
+    //Headless games run on simulated time only, every pass of the loop is exactly one tick
+    uint64_t now = HEADLESS ? next_tick : game_clock.elapsedMicros();
+    if (now > next_tick + max_lag) next_tick = now;
 
-    //Draw the snake
-    snake.drawSnake();
+    //Run every tick that has come due, several per frame when ticking faster than the render rate
+    while (game.isAlive() && next_tick <= now)
+    {
+      if (profiling) profile.begin();
+      uint64_t tick = game.getTick();
+      //Apply the recorded inputs that arrived before this tick
+      if (playback)
+      {
+        for (; playback_event < playback->events.size() && playback->events[playback_event].tick <= tick; playback_event++)
+        {
+          const ReplayEvent &event = playback->events[playback_event];
+          if (event.type == REPLAY_DIRECTION) game.setDirection(event.direction);
+          else if (event.type == REPLAY_QUIT) game.end();
+        }
+        //A replay never runs past the tick its game ended on
+        if (tick >= playback->ticks) game.end();
+        if (!game.isAlive()) break;
+      }
 
-    //Check if the food needs to be spawned (initially)
-    if (food.row == -1 || food.col == -1) food.spawn(boundary);
+      if (use_pilot)
+      {
+        char direction = pilot->decide(game);
+        if (direction) game.changeDirection(direction);
+      }
 
-    //Run the powerup spawn function
-    powerup.spawn(boundary);
+      //Log the direction the snake takes into this tick if it changed
+      if (recording && game.getDirection() != recorded_direction)
+      {
+        recorded_direction = game.getDirection();
+        recording->addEvent(tick, REPLAY_DIRECTION, recorded_direction);
+      }
 
-    //Check if the snake has eaten the food
-    if (food.checkCollision())
+      //Advance the game and draw what changed
+      if (profiling) profile.endPhase(PHASE_INPUT);
+      StepResult result = profiling ? game.step(0, profile) : game.step();
+      if (!HEADLESS) renderer.update(game, result);
+      if (ghost) ghost->update(game, result);
+      if (profiling) profile.endPhase(PHASE_COMPOSE);
+      if (rewind) rewind->record(game, result);
+
+      if (game.getTick() % REPLAY_HASH_INTERVAL == 0)
+      {
+        size_t checkpoint = game.getTick() / REPLAY_HASH_INTERVAL - 1;
+        if (recording) recording->hashes.push_back(game.getStateHash());
+        if (playback && checkpoint < playback->hashes.size() && playback->hashes[checkpoint] != game.getStateHash()) game.end();
+      }
+
+      next_tick += tickInterval(game.getSpeed());
+      last_tick_time = now;
+    }
+
+    //Headless games have no display to draw and no input to wait for
+    if (HEADLESS) continue;
+
+    //Refresh the overlay with the tick rate since it was last refreshed
+    if (PROFILE_OVERLAY && now >= overlay_time + overlay_interval)
     {
-      //Tell scoreboard to update
-      sb.scoreEvent();
-      sb.setSpeed((1000/game_speed));
+      uint64_t span = last_tick_time - window_tick_time;
+      double actual_rate = span > 0 ? double(game.getTick() - window_tick) * 1000000.0 / double(span) : 0.0;
+      sb.setOverlay(frameOverlay(profile, actual_rate, 1000000.0 / double(tickInterval(game.getSpeed()))));
       sb.updateTerminal();
-      //Add a new segment to the snake's body, at the position of the food.
-      snake.grow();
-      //Respawn food
-      food.spawn(boundary);
-      //Increase game speed & check if game speed is below max speed.
-      if (game_speed>MAX_SPEED){
-      game_speed = int(game_speed*(float(SPEED_MULTIPLIER)/100.0));
-      } else game_speed=MAX_SPEED;
-    }
-    //check if the snake has eaten the powerup
-    if(powerup.checkCollision()){
-      //activates powerup effects
-      powerup.activatePowerUp(game_speed, SELF_COLLISION);
-      if(powerup.type == 1){
-        //updates scoreboard to reflect the new speed if slow-mo powerup was consumed.
-        sb.setSpeed(1000/game_speed);
-        sb.updateTerminal();
+      overlay_time = now;
+      window_tick_time = last_tick_time;
+      window_tick = game.getTick();
+    }
+
+    //Print everything that changed since the last frame in one go
+    if (now >= next_render || !game.isAlive())
+    {
+      profile.begin();
+      string frame = t.encodeChanges();
+      profile.endPhase(PHASE_ENCODE);
+      size_t bytes = t.writeFrame(frame);
+      profile.endPhase(PHASE_WRITE);
+      profile.frameDone(bytes);
+      next_render = now + render_interval;
+    }
+
+    //Parse input between ticks, it applies to the next tick that runs
+    profile.begin();
+    input=getInput();
+    profile.endPhase(PHASE_INPUT, false);
+    if (input == OVERLAY_KEY)
+    {
+      PROFILE_OVERLAY = !PROFILE_OVERLAY;
+      if (!PROFILE_OVERLAY) sb.setOverlay({});
+      sb.updateTerminal();
+      overlay_time = 0;
+    }
+    if (!playback && !use_pilot && (input == 'w' || input == 'a' || input == 's' || input == 'd'))
+    {
+      //Change snake direction based on user input
+      game.changeDirection(input);
+    }
+    if (input == REWIND_KEY && rewind && game.isAlive())
+    {
+      //The clock stands still while looking back, the game carries on from where it was
+      game_clock.pause();
+      scrubRewind(game, *rewind, t, renderer);
+      if (ghost) ghost->redraw(game);
+      game_clock.resume();
+    }
+    if(input==PAUSE_KEY && game.isAlive()) 
+    {
+      //Freeze the game clock so ticks don't run down while paused
+      bool resume = true, save = false;
+      if (recording) recording->addEvent(game.getTick(), REPLAY_PAUSE);
+      game_clock.pause();
+      pauseMenu("", t, resume, playback ? nullptr : &save);
+      //A game that can't be saved carries on instead of being lost
+      if (save && !saveGame(SAVE_PATH, game))
+      {
+        messageMenu(t, {"COULD NOT SAVE THE GAME", "Could not write " + SAVE_PATH});
+        resume = true;
       }
-      powerup.row = -1;
-      isPowerUpSpawned = false;
+      game_clock.resume();
+      if (recording) recording->addEvent(game.getTick(), resume ? REPLAY_RESUME : REPLAY_QUIT);
+      //Prevents snake grid flicker before main menu
+      if (resume){
+      t.clearGrid();
+      renderer.redraw(game);
+      if (ghost) ghost->redraw(game);
+      }
+      else game.end();
     }
 
-    //check if the power up should be deactivated
-    if(powerup.powerUpExpired() && powerup.powerUpActive){
-      //deactivates powerup effects
-      powerup.deactivatePowerUp(game_speed, SELF_COLLISION);
-      if(powerup.type == 1){
-        //updates scoreboard to show new speed if the slow-mo powerup was used.
-        sb.setSpeed(1000/game_speed);
-        sb.updateTerminal();
+    //Sleep until the next tick or frame is due, waking at least every millisecond to keep reading input
+    uint64_t wake = next_tick < next_render ? next_tick : next_render;
+    uint64_t current = game_clock.elapsedMicros();
+    if (game.isAlive() && wake > current) usleep(wake - current < 1000 ? wake - current : 1000);
+  }
+
+  if (recording)
+  {
+    recording->ticks = game.getTick();
+    recording->score = game.getScore();
+    recording->won = game.isWon();
+    recording->final_hash = game.getStateHash();
+  }
+  return game.isWon();
+}
+
+/*
+    MultiGameRenderer Class:
+    Draws a MultiGameState onto the Terminal, the multi-snake counterpart of GameRenderer. Every tick only the cells that
+    changed are set: the cells the game cleared are erased (unless a head moved onto them in the same tick), the segment
+    behind every head becomes a body segment, the heads are drawn in their new position and new food is drawn where it
+    spawned, so a tick costs the same at any total body length. Each snake is drawn in its color from SNAKE_COLORS.
+    The two scoreboard rows list the players' scores and the number of snakes left.
+*/
+class MultiGameRenderer
+{
+  public:
+    /*
+    Constructor for MultiGameRenderer
+
+    Params: 1 Terminal reference, 1 size_t
+    Terminal, terminal: The terminal to draw to
+    size_t, players: Number of snakes (the first ones) steered by local players
+    */
+    MultiGameRenderer(Terminal &terminal, size_t players) : t(terminal), player_count(players) {};
+
+    /*
+    Draws the changes of a single tick
+
+    Params: 1 MultiGameState, 1 MultiStepResult
+    MultiGameState, game: The game after the tick
+    MultiStepResult, result: What changed during the tick
+
+    Returns: Void
+    */
+    void update(const MultiGameState &game, const MultiStepResult &result)
+    {
+      for (const ipair &cell:result.cleared) if (game.ownerOf(cell) < 0) setBlank(cell);
+      for (size_t i = 0; i < game.getSnakeCount(); i++) {
+        if (!game.isAlive(i)) continue;
+        const SnakeBody &body = game.getBody(i);
+        if (body.size() > 1) setBodySegment(body[1], i);
+        drawHead(game, i);
+      }
+      for (const ipair &cell:result.food_spawned) drawFood(cell);
+      if (result.ate_food || !result.died.empty()) drawScores(game);
+      return;
+    }
+
+    /*
+    Draws the whole game, used when the game starts and after returning from the pause menu
+
+    Params: 1 MultiGameState
+    MultiGameState, game: The game to draw
+
+    Returns: Void
+    */
+    void redraw(const MultiGameState &game)
+    {
+      const GameConfig &config = game.getConfig();
+      createGrid({config.rows, config.columns}, t);
+      for (size_t i = 0; i < game.getSnakeCount(); i++) {
+        if (!game.isAlive(i)) continue;
+        for (const ipair &segment:game.getBody(i)) setBodySegment(segment, i);
+        drawHead(game, i);
+      }
+      for (const ipair &cell:game.getFood()) if (cell.first >= 0) drawFood(cell);
+      drawScores(game);
+      return;
+    }
+
+  private:
+    Terminal &t;
+    size_t player_count;
+    //Widest scoreboard line drawn so far, shorter lines are padded to it so no old characters are left behind
+    size_t scoreboard_width = 0;
+
+    void setBlank(ipair cell)
+    {
+      t.setChar(cell.first + BOARD_TOP_ROW, cell.second, ' ', false, false, false, false, 0, BACKGROUND.bg_color);
+    }
+
+    void setBodySegment(ipair cell, size_t snake)
+    {
+      t.setChar(cell.first + BOARD_TOP_ROW, cell.second, SNAKE_BODY_CHAR, SNAKE_BODY.bold, SNAKE_BODY.italic, SNAKE_BODY.underline, SNAKE_BODY.blinking, SNAKE_COLORS[snake % SNAKE_COLORS.size()], SNAKE_BODY.bg_color);
+    }
+
+    //Draws a snake's head according to its direction
+    void drawHead(const MultiGameState &game, size_t snake)
+    {
+      char headChar = headCharOf(game.getDirection(snake));
+      const ipair &head = game.getBody(snake).front();
+      t.setChar(head.first + BOARD_TOP_ROW, head.second, headChar, SNAKE_HEAD.bold, SNAKE_HEAD.italic, SNAKE_HEAD.underline, SNAKE_HEAD.blinking, SNAKE_COLORS[snake % SNAKE_COLORS.size()], SNAKE_HEAD.bg_color);
+    }
+
+    void drawFood(ipair cell)
+    {
+      t.setChar(cell.first + BOARD_TOP_ROW, cell.second, FOOD_CHAR, SNAKE_FOOD.bold, SNAKE_FOOD.italic, SNAKE_FOOD.underline, SNAKE_FOOD.blinking, SNAKE_FOOD.fg_color, SNAKE_FOOD.bg_color);
+    }
+
+    //Writes the players' scores on the first scoreboard row and the snakes left on the second
+    void drawScores(const MultiGameState &game)
+    {
+      string scores;
+      for (size_t i = 0; i < player_count && i < game.getSnakeCount(); i++) {
+        if (i > 0) scores += "   ";
+        scores += "P" + to_string(i + 1) + ": " + to_string(game.getScore(i)) + (game.isAlive(i) ? "" : " (OUT)");
       }
+      string left = "SNAKES LEFT: " + to_string(game.getAliveCount()) + " / " + to_string(game.getSnakeCount());
+      scoreboard_width = max(scoreboard_width, max(scores.size(), left.size()));
+
+      int center_line = t.findCenter().second;
+      int row = 0;
+      for (string line:{scores, left}) {
+        line.resize(scoreboard_width, ' ');
+        int column = center_line - int(scoreboard_width / 2);
+        for (char c:line) {
+          t.setChar(row, column, c, SCOREBOARD.bold, SCOREBOARD.italic, SCOREBOARD.underline, SCOREBOARD.blinking, SCOREBOARD.fg_color, SCOREBOARD.bg_color);
+          column++;
+        }
+        row++;
+      }
+      return;
     }
-    //Check for collisions after the snake has moved
-    if (snake.checkSelfCollision() || snake.checkBoundaryCollision())
+};
+
+/*
+    playMultiGame: runs a multi-snake game, the counterpart of playGame. The first players snakes are steered from the
+    keyboard with the keys in PLAYER_KEYS, all other snakes by multiBotMove. Every tick takes the same time, tickInterval()
+    of the initial speed, and the frames are drawn on their own cadence like in playGame. Headless games let the bots steer
+    every snake. The game ends once at most one snake is left, or once every player is out.
+*/
+void playMultiGame(MultiGameState &game, Terminal &t, size_t players)
+{
+  if (HEADLESS) players = 0;
+  const size_t snakes = game.getSnakeCount();
+  //Direction every snake turns to on the next tick, players' keys stay in place until the tick has run
+  vector<char> inputs(snakes, 0);
+  GameClock game_clock;
+  MultiGameRenderer renderer(t, players);
+  if (!HEADLESS) renderer.redraw(game);
+
+  uint64_t next_tick = 0;
+  uint64_t next_render = 0;
+  const uint64_t render_interval = 1000000 / (RENDER_RATE > 0 ? RENDER_RATE : 60);
+  const uint64_t max_lag = 250000;
+  auto playersOut = [&]() {
+    for (size_t i = 0; i < players; i++) if (game.isAlive(i)) return false;
+    return players > 0;
+  };
+
+  while (!game.isOver() && !playersOut())
+  {
+    uint64_t now = HEADLESS ? next_tick : game_clock.elapsedMicros();
+    if (now > next_tick + max_lag) next_tick = now;
+
+    while (!game.isOver() && next_tick <= now)
     {
-      //Handle collision (End the game)
-      alive=false;
+      for (size_t i = players; i < snakes; i++) inputs[i] = game.isAlive(i) ? multiBotMove(game, i) : 0;
+      const MultiStepResult &result = game.step(inputs.data());
+      if (!HEADLESS) renderer.update(game, result);
+      for (size_t i = 0; i < players; i++) inputs[i] = 0;
+      next_tick += tickInterval(game.getConfig().initial_speed);
     }
 
-    //Seperate loop for parsing input irrespective of whether we are waiting for the next frame
-    //Sleep to control the speed of the game
-    int clock = 0;
-    while(clock<=game_speed*10){
-      input=getInput();
-      if (input == 'w' || input == 'a' || input == 's' || input == 'd')
+    if (HEADLESS) continue;
+
+    if (now >= next_render || game.isOver())
+    {
+      t.drawChanges();
+      next_render = now + render_interval;
+    }
+
+    //Every key pressed since the last pass is read, each one turns the player whose keymap it belongs to
+    for (char key:getInputs())
+    {
+      for (size_t p = 0; p < players && p < PLAYER_KEYS.size(); p++)
       {
-        //Change snake direction based on user input
-        snake.changeDirection(input);
+        size_t k = PLAYER_KEYS[p].find(key);
+        if (k != string::npos) inputs[p] = "wasd"[k];
       }
-      if(input==PAUSE_KEY) 
+      if (key == PAUSE_KEY)
       {
-        pauseMenu("", t, alive);
-        //Prevents snake grid flicker before main menu
-        if (alive){
+        bool resume = true;
+        game_clock.pause();
+        pauseMenu("", t, resume);
+        game_clock.resume();
+        if (!resume) return;
         t.clearGrid();
-        createGrid(screen_size, t);
+        renderer.redraw(game);
+      }
+    }
+
+    uint64_t wake = next_tick < next_render ? next_tick : next_render;
+    uint64_t current = game_clock.elapsedMicros();
+    if (wake > current) usleep(wake - current < 1000 ? wake - current : 1000);
+  }
+  return;
+}
+
+/*
+    playNetGame: runs a networked multi-snake game, the counterpart of playMultiGame for a LockstepSession. The local
+    snake is steered with the first keys of PLAYER_KEYS (by multiBotMove in headless games, which then run as fast as the
+    inputs of the other players come in). Every tick the session predicts inputs that haven't arrived, so the game only
+    waits on the others once they fall MAX_ROLLBACK_TICKS behind; when an input proves a prediction wrong the session
+    rolls back and the board is drawn again. A process that runs ahead of the others stretches its ticks by a quarter
+    until they catch up. The pause menu stops only this process, the others stall shortly after. Quitting leaves the game.
+*/
+void playNetGame(LockstepSession &session, Terminal &t)
+{
+  const size_t local = session.getLocalPlayer();
+  char input = 0; //Direction the local snake turns to on the next tick
+  GameClock game_clock;
+  MultiGameRenderer renderer(t, session.getPlayerCount());
+  if (!HEADLESS) renderer.redraw(session.getState());
+
+  uint64_t next_tick = 0;
+  uint64_t next_render = 0;
+  const uint64_t tick_interval = tickInterval(session.getConfig().initial_speed);
+  const uint64_t render_interval = 1000000 / (RENDER_RATE > 0 ? RENDER_RATE : 60);
+  const uint64_t max_lag = 250000;
+
+  while (!session.isOver())
+  {
+    if (session.poll() && !HEADLESS) renderer.redraw(session.getState());
+    uint64_t now = HEADLESS ? next_tick : game_clock.elapsedMicros();
+    if (now > next_tick + max_lag) next_tick = now;
+
+    while (next_tick <= now && session.canAdvance())
+    {
+      if (HEADLESS) input = session.getState().isAlive(local) ? multiBotMove(session.getState(), local) : 0;
+      const MultiStepResult &result = session.advance(input);
+      if (!HEADLESS) renderer.update(session.getState(), result);
+      input = 0;
+      next_tick += tick_interval + (session.getLead() > 1 ? tick_interval / 4 : 0);
+    }
+
+    if (HEADLESS) {
+      if (!session.canAdvance()) session.wait(1);
+      continue;
+    }
+
+    if (now >= next_render)
+    {
+      t.drawChanges();
+      next_render = now + render_interval;
+    }
+
+    for (char key:getInputs())
+    {
+      size_t k = PLAYER_KEYS[0].find(key);
+      if (k != string::npos) input = "wasd"[k];
+      if (key == PAUSE_KEY)
+      {
+        bool resume = true;
+        game_clock.pause();
+        pauseMenu("", t, resume);
+        game_clock.resume();
+        if (!resume) {
+          session.leave();
+          return;
         }
+        t.clearGrid();
+        renderer.redraw(session.getState());
       }
-      clock++;
-      usleep(100);
     }
+
+    //Sleeps until the next tick or frame, or until an input arrives
+    uint64_t wake = next_tick < next_render ? next_tick : next_render;
+    uint64_t current = game_clock.elapsedMicros();
+    if (wake > current && wake - current < 1000) usleep(wake - current);
+    else if (wake > current) session.wait(1);
   }
+  if (!HEADLESS) {
+    renderer.redraw(session.getConfirmedState());
+    t.drawChanges();
+  }
+  return;
+}
+
+/*
+    WorldRenderer Class:
+    Draws a WorldState onto the Terminal through a Camera, the world mode counterpart of GameRenderer. The board area of
+    the screen shows the part of the world under the camera. While the camera stays put only the cells that changed are
+    set, like in GameRenderer. When it moves up or down the board rows are scrolled on console with Terminal::scrollRows
+    first, so the following frame only prints what really differs, and a sideways move relies on drawChanges alone.
+*/
+class WorldRenderer
+{
+  public:
+    /*
+    Constructor for WorldRenderer
+
+    Params: 1 Terminal reference, 1 ScoreBoard reference, 1 Camera reference
+    Terminal, terminal: The terminal to draw to
+    ScoreBoard, scoreboard: The scoreboard to keep up to date with the score and speed
+    Camera, view: The camera picking the part of the world to show, its size must match the board area of the screen
+    */
+    WorldRenderer(Terminal &terminal, ScoreBoard &scoreboard, Camera &view) : t(terminal), sb(scoreboard), camera(view) {};
+
+    /*
+    Draws the changes of a single tick
+
+    Params: 1 WorldState, 1 StepResult
+    WorldState, world: The game after the tick
+    StepResult, result: What changed during the tick
+
+    Returns: Void
+    */
+    void update(const WorldState &world, const StepResult &result)
+    {
+      int old_top = camera.getTop(), old_left = camera.getLeft();
+      if (camera.follow(world))
+      {
+        if (camera.getLeft() == old_left) t.scrollRows(FIRST_ROW, FIRST_ROW + camera.getRows() - 1, camera.getTop() - old_top);
+        drawView(world);
+      }
+      else
+      {
+        if (result.tail_moved && !world.occupies(result.prev_tail)) drawCell(world, result.prev_tail);
+        const SnakeBody &body = world.getBody();
+        if (body.size() > 1) drawCell(world, body[1]);
+        drawHead(world);
+        if (result.food_spawned) drawCell(world, world.getFood());
+      }
+
+      if (result.ate_food) sb.scoreEvent();
+      if (result.ate_food || result.speed_changed)
+      {
+        sb.setSpeed(tilesPerSecond(world.getSpeed()));
+        sb.updateTerminal();
+      }
+      return;
+    }
+
+    /*
+    Draws the whole screen, used when the game starts and after returning from the pause menu
+
+    Params: 1 WorldState
+    WorldState, world: The game to draw
+
+    Returns: Void
+    */
+    void redraw(const WorldState &world)
+    {
+      const GameConfig &config = world.getConfig();
+      createGrid({config.rows, config.columns}, t);
+      drawView(world);
+      sb.setSpeed(tilesPerSecond(world.getSpeed()));
+      sb.updateTerminal();
+      return;
+    }
+
+  private:
+    //Screen position of the top left cell of the view, inside the frame drawn by createGrid
+    static const int FIRST_ROW = BOARD_TOP_ROW + 1;
+    static const int FIRST_COLUMN = 1;
+
+    Terminal &t;
+    ScoreBoard &sb;
+    Camera &camera;
+
+    //Sets every cell of the view
+    void drawView(const WorldState &world)
+    {
+      for (int r = 0; r < camera.getRows(); r++)
+      {
+        for (int c = 0; c < camera.getColumns(); c++) drawCell(world, {camera.getTop() + r, camera.getLeft() + c});
+      }
+      drawHead(world);
+      return;
+    }
+
+    //Draws whatever is on a world cell (border, body segment, food or nothing), if it is in view
+    void drawCell(const WorldState &world, ipair cell)
+    {
+      if (!camera.contains(cell)) return;
+      int row = FIRST_ROW + cell.first - camera.getTop(), column = FIRST_COLUMN + cell.second - camera.getLeft();
+      if (world.isWall(cell)) t.setChar(row, column, GRID_BORDER, BARRIER.bold, BARRIER.italic, BARRIER.underline, BARRIER.blinking, BARRIER.fg_color, BARRIER.bg_color);
+      else if (world.occupies(cell)) t.setChar(row, column, SNAKE_BODY_CHAR, SNAKE_BODY.bold, SNAKE_BODY.italic, SNAKE_BODY.underline, SNAKE_BODY.blinking, SNAKE_BODY.fg_color, SNAKE_BODY.bg_color);
+      else if (cell == world.getFood()) t.setChar(row, column, FOOD_CHAR, SNAKE_FOOD.bold, SNAKE_FOOD.italic, SNAKE_FOOD.underline, SNAKE_FOOD.blinking, SNAKE_FOOD.fg_color, SNAKE_FOOD.bg_color);
+      else t.setChar(row, column, ' ', false, false, false, false, 0, BACKGROUND.bg_color);
+    }
+
+    //Draws the snake's head according to its direction
+    void drawHead(const WorldState &world)
+    {
+      const ipair &head = world.getBody().front();
+      if (!camera.contains(head)) return;
+      char headChar = headCharOf(world.getDirection());
+      t.setChar(FIRST_ROW + head.first - camera.getTop(), FIRST_COLUMN + head.second - camera.getLeft(), headChar, SNAKE_HEAD.bold, SNAKE_HEAD.italic, SNAKE_HEAD.underline, SNAKE_HEAD.blinking, SNAKE_HEAD.fg_color, SNAKE_HEAD.bg_color);
+    }
+};
+
+/*
+    playWorldGame: runs a game in world mode, the counterpart of playGame. The ticks and frames are paced exactly like
+    in playGame and the snake is steered with 'w', 'a', 's' and 'd', while a WorldRenderer keeps the camera on the head.
+*/
+void playWorldGame(WorldState &world, Terminal &t, ScoreBoard &sb)
+{
+  GameClock game_clock;
+  const GameConfig &config = world.getConfig();
+  Camera camera(config.rows - BOARD_TOP_ROW - 2, config.columns - 2);
+  camera.center(world);
+  WorldRenderer renderer(t, sb, camera);
+  if (!HEADLESS) renderer.redraw(world);
+
+  uint64_t next_tick = 0;
+  uint64_t next_render = 0;
+  const uint64_t render_interval = 1000000 / (RENDER_RATE > 0 ? RENDER_RATE : 60);
+  const uint64_t max_lag = 250000;
+
+  while (world.isAlive())
+  {
+    uint64_t now = HEADLESS ? next_tick : game_clock.elapsedMicros();
+    if (now > next_tick + max_lag) next_tick = now;
+
+    while (world.isAlive() && next_tick <= now)
+    {
+      StepResult result = world.step();
+      if (!HEADLESS) renderer.update(world, result);
+      next_tick += tickInterval(world.getSpeed());
+    }
+
+    if (HEADLESS) continue;
+
+    if (now >= next_render || !world.isAlive())
+    {
+      t.drawChanges();
+      next_render = now + render_interval;
+    }
+
+    char input = getInput();
+    if (input == 'w' || input == 'a' || input == 's' || input == 'd') world.changeDirection(input);
+    if (input == PAUSE_KEY && world.isAlive())
+    {
+      bool resume = true;
+      game_clock.pause();
+      pauseMenu("", t, resume);
+      game_clock.resume();
+      if (!resume) world.end();
+      else
+      {
+        t.clearGrid();
+        renderer.redraw(world);
+      }
+    }
+
+    uint64_t wake = next_tick < next_render ? next_tick : next_render;
+    uint64_t current = game_clock.elapsedMicros();
+    if (world.isAlive() && wake > current) usleep(wake - current < 1000 ? wake - current : 1000);
+  }
+  return;
 }
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
 
 //Function definitions used for menu navigation
 //Most of these are functionally identical
-void pauseMenu(string text, Terminal& t, bool& game_state)
+//With save given, SAVE AND QUIT is offered as well and sets it along with clearing game_state
+void pauseMenu(string text, Terminal& t, bool& game_state, bool* save)
 {
   vector<string> ts = {"GAME CURRENTLY PAUSED"};
   vector<string> ps = {"RESUME", "QUIT"};
+  if (save) ps.insert(ps.begin() + 1, "SAVE AND QUIT");
 
   Menu m(ts, ps, t);
 
@@ -929,6 +1627,10 @@ void pauseMenu(string text, Terminal& t, bool& game_state)
           case 1:
             return;
           case 2:
+            game_state=false;
+            if (save) *save = true;
+            return;
+          case 3:
             game_state=false;
             return;
         }
@@ -937,6 +1639,66 @@ void pauseMenu(string text, Terminal& t, bool& game_state)
   }
 }
 
+void winMenu(Terminal& t, int score)
+{
+  vector<string> ts = {"THE SNAKE FILLED THE WHOLE BOARD - YOU WIN!", "FINAL SCORE: " + to_string(score)};
+  vector<string> ps = {"CONTINUE"};
+
+  Menu m(ts, ps, t);
+
+  t.clearGrid();
+  m.updateTerminal();
+  t.draw();
+  //Wait for enter before returning to the main menu
+  while (getInput() != '\n') usleep(1000);
+}
+
+//Returns true if the player chose to watch the end of the game again (only offered when can_rewind is set)
+bool gameOverMenu(Terminal& t, int score, size_t space, size_t free_cells, bool can_rewind)
+{
+  vector<string> ts = {"GAME OVER", "FINAL SCORE: " + to_string(score),
+                       "SPACE REMAINING: " + to_string(space) + " OF " + to_string(free_cells) + " FREE CELLS WERE STILL REACHABLE"};
+  vector<string> ps = {"CONTINUE"};
+  if (can_rewind) ps.push_back("WATCH THE LAST SECONDS AGAIN");
+
+  Menu m(ts, ps, t);
+
+  t.clearGrid();
+  m.updateTerminal();
+  t.draw();
+  //Wait for enter before returning to the main menu
+  while (true)
+  {
+    switch (getInput()) {
+      case 'w':
+        m.moveCursor(-1);
+        m.updateTerminal();
+        t.draw();
+        break;
+      case 's':
+        m.moveCursor(1);
+        m.updateTerminal();
+        t.draw();
+        break;
+      case '\n':
+        return m.getSelection() == 2;
+      default:
+        usleep(1000);
+    }
+  }
+}
+
+void messageMenu(Terminal& t, const vector<string>& text)
+{
+  Menu m(text, {"CONTINUE"}, t);
+
+  t.clearGrid();
+  m.updateTerminal();
+  t.draw();
+  //Wait for enter before returning to the main menu
+  while (getInput() != '\n') usleep(1000);
+}
+
 void intInputMenu(string text, Terminal& t, int& to_set)
 {
   vector<string> ts = {text, "where the currently displayed number goes"};
@@ -1201,7 +1963,7 @@ void charEditorMenu(Terminal &t)
   bool force_menu = true;
   bool active = true;
   vector<string> menu_text = {"CHARACTER EDITOR", "NAVIGATE UP & DOWN WITH 'w' & 's'", "PRESS ENTER TO SELECT AN OPTION TO EDIT & C TO CANCEL"};
-  vector<string> menu_options = {"SNAKE HEAD (UP)", "SNAKE HEAD (DOWN)", "SNAKE HEAD (RIGHT)", "SNAKE HEAD (LEFT)", "SNAKE BODY", "FOOD", "BARRIER", "CURSOR","POWERUP 1 CHAR", "POWERUP 2 CHAR"};
+  vector<string> menu_options = {"SNAKE HEAD (UP)", "SNAKE HEAD (DOWN)", "SNAKE HEAD (RIGHT)", "SNAKE HEAD (LEFT)", "SNAKE BODY", "FOOD", "BARRIER", "CURSOR","POWERUP 1 CHAR", "POWERUP 2 CHAR", "POWERUP 3 CHAR", "POWERUP 4 CHAR"};
   Menu m(menu_text, menu_options, t);
 
   while(active)
@@ -1259,6 +2021,13 @@ void charEditorMenu(Terminal &t)
             break;
           case 10:
             charInputMenu("EDITING SELF-COLLISION POWERUP CHAR", t, POWERUP_2_CHAR);
+            break;
+          case 11:
+            charInputMenu("EDITING SHRINK POWERUP CHAR", t, POWERUP_3_CHAR);
+            break;
+          case 12:
+            charInputMenu("EDITING DOUBLE SCORE POWERUP CHAR", t, POWERUP_4_CHAR);
+            break;
         }
     }
   }
@@ -1319,7 +2088,7 @@ void powerupEditorMenu(Terminal &t)
   bool force_menu = true;
   bool active = true;
   vector<string> menu_text = {"POWERUP EDITOR", "NAVIGATE UP & DOWN WITH 'w' & 's'", "PRESS ENTER TO SELECT AN OPTION TO EDIT & C TO CANCEL"};
-  vector<string> menu_options = {"ENABLE POWERUPS", "POWERUP EFFECT TIME", "POWERUP SPAWN TIME", "SLOW-MO POWERUP TIME"};
+  vector<string> menu_options = {"ENABLE POWERUPS", "POWERUP EFFECT TIME", "POWERUP SPAWN TIME", "SLOW-MO POWERUP TIME", "FOOD ON THE BOARD", "POWERUPS ON THE BOARD", "SHRINK POWERUP", "DOUBLE SCORE POWERUP"};
   Menu m(menu_text, menu_options, t);
 
   while(active)
@@ -1360,6 +2129,18 @@ void powerupEditorMenu(Terminal &t)
           case 4:
             intInputMenu("RATIO CHANGE IN GAMESPEED FOR THE SLO-MO POWER UP", t, SLOW_MO_POWERUP_INCREMENT);
             break;
+          case 5:
+            intInputMenu("NUMBER OF FOOD ITEMS ON THE BOARD AT ONCE", t, FOOD_COUNT);
+            break;
+          case 6:
+            intInputMenu("MOST POWERUPS ON THE BOARD AT ONCE", t, MAX_POWERUPS);
+            break;
+          case 7:
+            boolInputMenu("ENABLE OR DISABLE THE SHRINK POWERUP (CUTS THE TAIL SHORT)", t, ENABLE_SHRINK_POWERUP);
+            break;
+          case 8:
+            boolInputMenu("ENABLE OR DISABLE THE DOUBLE SCORE POWERUP", t, ENABLE_DOUBLE_SCORE_POWERUP);
+            break;
         }
     }
   }
@@ -0,0 +1,108 @@
+/*
+* File: GameConfig.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the GameConfig struct, a snapshot of every
+* setting that affects how a game plays out. Together with the seed it is
+* all that is needed to replay a game tick for tick.
+*/
+
+//Redundancy safety check
+#ifndef GAMECONFIG_H
+#define GAMECONFIG_H
+
+#include <cstdint>
+#include <string>
+#include "BinaryFile.hpp"
+
+/*
+The GameConfig struct holds the display size, seed and gameplay settings a game was started with
+*/
+struct GameConfig
+{
+  int rows = 0; //Display rows
+  int columns = 0; //Display columns
+  uint64_t seed = 0;
+
+  int initial_speed = 200;
+  int max_speed = 50;
+  int speed_multiplier = 85;
+  bool self_collision = true;
+  bool enable_powerups = true;
+  int powerup_time = 10;
+  int powerup_spawn_time = 15;
+  int slow_mo_increment = 2;
+  int food_count = 1; //Food items kept on the board
+  int max_powerups = 1; //Most powerups lying on the board at once
+  int powerup_types = 0x1E; //Bit (1 << type) set for every powerup type that can spawn
+  std::string level_path = ""; //Level pack the board comes from, empty for a board with just the border
+  int level_index = 0; //Level of the pack, counting from 0
+  uint32_t level_checksum = 0; //Checksum of the level, so a replay notices when the pack changed
+};
+
+/*
+Appends a GameConfig to a byte buffer
+
+Params: 1 ByteWriter reference, 1 GameConfig
+ByteWriter, out: The buffer to write to
+GameConfig, config: The config to write
+
+Returns: Void
+*/
+void writeConfig(ByteWriter& out, const GameConfig& config)
+{
+  out.put16(config.rows);
+  out.put16(config.columns);
+  out.put64(config.seed);
+  out.put32(config.initial_speed);
+  out.put32(config.max_speed);
+  out.put32(config.speed_multiplier);
+  out.put8(config.self_collision | (config.enable_powerups << 1));
+  out.put32(config.powerup_time);
+  out.put32(config.powerup_spawn_time);
+  out.put32(config.slow_mo_increment);
+  out.put32(config.food_count);
+  out.put32(config.max_powerups);
+  out.put32(config.powerup_types);
+  out.put16(config.level_path.size());
+  out.putBytes(config.level_path.data(), config.level_path.size());
+  out.put32(config.level_index);
+  out.put32(config.level_checksum);
+  return;
+}
+
+/*
+Reads back a GameConfig written by writeConfig
+
+Params: 1 ByteReader reference
+ByteReader, in: The buffer to read from
+
+Returns: The config
+*/
+GameConfig readConfig(ByteReader& in)
+{
+  GameConfig config;
+  config.rows = in.get16();
+  config.columns = in.get16();
+  config.seed = in.get64();
+  config.initial_speed = int32_t(in.get32());
+  config.max_speed = int32_t(in.get32());
+  config.speed_multiplier = int32_t(in.get32());
+  uint8_t flags = in.get8();
+  config.self_collision = flags & 1;
+  config.enable_powerups = flags & 2;
+  config.powerup_time = int32_t(in.get32());
+  config.powerup_spawn_time = int32_t(in.get32());
+  config.slow_mo_increment = int32_t(in.get32());
+  config.food_count = int32_t(in.get32());
+  config.max_powerups = int32_t(in.get32());
+  config.powerup_types = int32_t(in.get32());
+  config.level_path.resize(in.get16());
+  in.getBytes(&config.level_path[0], config.level_path.size());
+  config.level_index = int32_t(in.get32());
+  config.level_checksum = in.get32();
+  return config;
+}
+
+#endif
@@ -0,0 +1,387 @@
+/*
+* File: GameTimer.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the timing utilities used by the game.
+* GameClock is a monotonic microsecond clock that can be paused, and
+* TimerWheel is a hierarchical timer wheel that schedules timed game
+* events (powerup spawns, powerup expiry, ...) against that clock.
+*/
+
+//Redundancy safety check
+#ifndef GAMETIMER_H
+#define GAMETIMER_H
+
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+/*
+GameClock Class:
+  A microsecond resolution clock built on the monotonic steady_clock. Time spent while the clock
+  is paused is excluded from the elapsed time, so anything scheduled against it freezes while the game is paused.
+*/
+class GameClock
+{
+  public:
+    /*
+    Constructor for GameClock, the clock starts counting from the moment it is constructed
+
+    Params: None
+    */
+    GameClock() : start_time(now()) {};
+
+    /*
+    Returns the amount of unpaused time that has passed since the clock was constructed
+
+    Params: None
+
+    Returns: The elapsed time in microseconds (elapsedMicros) or milliseconds (elapsed)
+    */
+    uint64_t elapsedMicros() const
+    {
+      //While paused the clock is frozen at the moment the pause began
+      uint64_t end_time = paused ? pause_start : now();
+      return end_time - start_time - paused_total;
+    }
+    uint64_t elapsed() const {return elapsedMicros() / 1000;}
+
+    /*
+    Freezes the clock, does nothing if it is already paused
+
+    Params: None
+
+    Returns: Void
+    */
+    void pause()
+    {
+      if (!paused) {
+        pause_start = now();
+        paused = true;
+      }
+      return;
+    }
+
+    /*
+    Unfreezes the clock, the time spent paused is never counted towards elapsed()
+
+    Params: None
+
+    Returns: Void
+    */
+    void resume()
+    {
+      if (paused) {
+        paused_total += now() - pause_start;
+        paused = false;
+      }
+      return;
+    }
+
+    bool isPaused() const {return paused;}
+
+  private:
+    uint64_t start_time;
+    uint64_t pause_start = 0;
+    uint64_t paused_total = 0;
+    bool paused = false;
+
+    //Current reading of the monotonic clock in microseconds
+    static uint64_t now()
+    {
+      using namespace std::chrono;
+      return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+//Types of events that can be scheduled on the timer wheel
+enum TimerEventType
+{
+  POWERUP_SPAWN_EVENT,
+  POWERUP_EXPIRE_EVENT
+};
+
+/*
+The TimerEvent struct is what gets handed back to the caller when a timer fires
+*/
+struct TimerEvent
+{
+  int type; //One of TimerEventType
+  int data; //Optional payload chosen when the event was scheduled
+};
+
+//Handle returned by TimerWheel::schedule, can be used to cancel the timer
+using TimerHandle = uint64_t;
+
+/*
+TimerWheel Class:
+  A hierarchical timer wheel with millisecond resolution. Level 0 has one slot per millisecond, every
+  level above it has slots 64 times wider than the level below. Timers are placed in the lowest level that
+  can hold them and are cascaded down a level each time the level below wraps around.
+
+  Scheduling and cancelling are O(1), and advancing the wheel costs O(1) per elapsed slot plus the number of
+  timers that fire, no matter how many timers are pending. Empty stretches of level 0 are skipped in one step.
+  Timer nodes are kept in a pool that is reused, so a running game does not allocate once the pool has warmed up.
+*/
+class TimerWheel
+{
+  public:
+    TimerWheel()
+    {
+      for (int level = 0; level < LEVELS; level++) {
+        occupied[level] = 0;
+        for (int slot = 0; slot < SLOTS; slot++) {
+          heads[level][slot] = -1;
+          tails[level][slot] = -1;
+        }
+      }
+    };
+
+    /*
+    Schedules an event to fire after a given delay
+
+    Params: 1 uint64_t, 2 integer
+    uint64_t, delay: Milliseconds from the current wheel time until the event fires (0 fires on the next millisecond)
+    int, type: The event type (TimerEventType)
+    int, data: Optional payload handed back with the event
+
+    Returns: A handle that can be passed to cancel()
+    */
+    TimerHandle schedule(uint64_t delay, int type, int data=0)
+    {
+      //Delays longer than the wheel can represent are clamped to its range
+      if (delay < 1) delay = 1;
+      if (delay > MAX_DELAY) delay = MAX_DELAY;
+
+      int node = allocateNode();
+      nodes[node].expiry = current_time + delay;
+      nodes[node].event = {type, data};
+      nodes[node].order = scheduled++;
+      nodes[node].active = true;
+      insertNode(node);
+      pending++;
+
+      return (uint64_t(nodes[node].generation) << 32) | uint32_t(node);
+    }
+
+    /*
+    Cancels a pending timer, does nothing if the timer already fired or was cancelled
+
+    Params: 1 TimerHandle
+    TimerHandle, handle: The handle returned when the timer was scheduled
+
+    Returns: Void
+    */
+    void cancel(TimerHandle handle)
+    {
+      uint32_t node = uint32_t(handle);
+      uint32_t generation = uint32_t(handle >> 32);
+      //The node is left in its slot and released when the wheel reaches it
+      if (node < nodes.size() && nodes[node].generation == generation) nodes[node].active = false;
+      return;
+    }
+
+    /*
+    Advances the wheel to the given time, calling on_fire for every event that comes due, in the order they expire
+
+    Params: 1 uint64_t, 1 callable
+    uint64_t, to_time: The time (in milliseconds) to advance to, times in the past are ignored
+    callable, on_fire: Called with a const TimerEvent& for each fired event, may schedule new events
+
+    Returns: Void
+    */
+    template <typename F>
+    void advance(uint64_t to_time, F&& on_fire)
+    {
+      while (current_time < to_time) {
+        //Nothing left to fire, jump straight to the target time
+        if (pending == 0) {
+          current_time = to_time;
+          break;
+        }
+
+        uint64_t next = current_time + 1;
+        //Empty level 0 slots before the next wrap-around can be skipped in a single step
+        if ((next & MASK) != 0) {
+          uint64_t ahead = occupied[0] >> (next & MASK);
+          uint64_t skip = ahead ? __builtin_ctzll(ahead) : SLOTS - (next & MASK);
+          if (skip > 0) {
+            current_time = (current_time + skip < to_time) ? current_time + skip : to_time;
+            continue;
+          }
+        }
+
+        current_time = next;
+        //Pull the timers of the next wider slot down whenever level 0 wraps around
+        if ((current_time & MASK) == 0) cascade(1);
+        fireSlot(current_time & MASK, on_fire);
+      }
+      return;
+    }
+
+    /*
+    Get respective private values (in function name)
+
+    Params: None
+
+    Returns: The current wheel time in milliseconds, and the number of timers still waiting in the wheel
+    */
+    uint64_t getTime() const {return current_time;}
+    int getPending() const {return pending;}
+
+    /*
+    Lists every timer still waiting to fire, in the order the wheel will fire them (by expiry, then by the order they
+    were scheduled in), used to save a game
+
+    Params: None
+
+    Returns: The expiry time (in milliseconds) and the event of each timer
+    */
+    std::vector<std::pair<uint64_t, TimerEvent>> getPendingTimers() const
+    {
+      std::vector<const Node*> waiting;
+      for (const Node &node:nodes) if (node.active) waiting.push_back(&node);
+      std::sort(waiting.begin(), waiting.end(), [](const Node *a, const Node *b) {
+        return a->expiry != b->expiry ? a->expiry < b->expiry : a->order < b->order;
+      });
+      std::vector<std::pair<uint64_t, TimerEvent>> timers;
+      for (const Node *node:waiting) timers.push_back({node->expiry, node->event});
+      return timers;
+    }
+
+    /*
+    Empties the wheel and moves it to a given time, used to restore a saved game: scheduling the saved timers again in
+    the order getPendingTimers() listed them, each with its expiry minus the time as the delay, fires them exactly as
+    the saved wheel would have
+
+    Params: 1 uint64_t
+    uint64_t, time: The wheel time in milliseconds
+
+    Returns: Void
+    */
+    void restart(uint64_t time)
+    {
+      *this = TimerWheel();
+      current_time = time;
+      return;
+    }
+
+  private:
+    //Number of bits per level, slots per level and the mask to index a level
+    static const int BITS = 6;
+    static const int SLOTS = 1 << BITS;
+    static const uint64_t MASK = SLOTS - 1;
+    static const int LEVELS = 4;
+    //Longest delay the wheel can hold (roughly 4.6 hours)
+    static const uint64_t MAX_DELAY = (uint64_t(1) << (BITS * LEVELS)) - 1;
+
+    //A single scheduled timer, linked into the list of the slot it sits in
+    struct Node
+    {
+      uint64_t expiry = 0;
+      TimerEvent event = {0, 0};
+      int next = -1;
+      uint64_t order = 0; //Timers scheduled before it, breaks ties between timers with the same expiry
+      uint32_t generation = 0;
+      bool active = false;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int> free_nodes;
+    //Head and tail of the list for each slot, the lists are kept in scheduling order
+    int heads[LEVELS][SLOTS];
+    int tails[LEVELS][SLOTS];
+    //One bit per slot, set when the slot's list is not empty
+    uint64_t occupied[LEVELS];
+    uint64_t current_time = 0;
+    int pending = 0;
+    uint64_t scheduled = 0; //Timers scheduled so far
+
+    //Takes a node from the free pool, growing the pool only when it is empty
+    int allocateNode()
+    {
+      if (!free_nodes.empty()) {
+        int node = free_nodes.back();
+        free_nodes.pop_back();
+        return node;
+      }
+      nodes.push_back(Node());
+      return nodes.size() - 1;
+    }
+
+    //Returns a node to the free pool, bumping its generation so old handles can no longer cancel it
+    void releaseNode(int node)
+    {
+      nodes[node].active = false;
+      nodes[node].generation++;
+      free_nodes.push_back(node);
+      pending--;
+      return;
+    }
+
+    //Places a node in the lowest level whose current window contains its expiry time
+    void insertNode(int node)
+    {
+      uint64_t expiry = nodes[node].expiry;
+      int level = 0;
+      while (level < LEVELS - 1 && (expiry >> (BITS * (level + 1))) != (current_time >> (BITS * (level + 1)))) level++;
+
+      int slot = (expiry >> (BITS * level)) & MASK;
+      nodes[node].next = -1;
+      if (tails[level][slot] == -1) heads[level][slot] = node;
+      else nodes[tails[level][slot]].next = node;
+      tails[level][slot] = node;
+      occupied[level] |= (uint64_t(1) << slot);
+      return;
+    }
+
+    //Detaches and returns the list of a slot
+    int takeSlot(int level, int slot)
+    {
+      int head = heads[level][slot];
+      heads[level][slot] = -1;
+      tails[level][slot] = -1;
+      occupied[level] &= ~(uint64_t(1) << slot);
+      return head;
+    }
+
+    //Moves the timers of the current slot of a level down into the levels below it
+    void cascade(int level)
+    {
+      if (level >= LEVELS) return;
+      int slot = (current_time >> (BITS * level)) & MASK;
+      //Higher levels are cascaded first so their timers can be redistributed all the way down
+      if (slot == 0) cascade(level + 1);
+
+      int node = takeSlot(level, slot);
+      while (node != -1) {
+        int next = nodes[node].next;
+        if (nodes[node].active) insertNode(node);
+        else releaseNode(node);
+        node = next;
+      }
+      return;
+    }
+
+    //Fires every active timer in a level 0 slot
+    template <typename F>
+    void fireSlot(int slot, F& on_fire)
+    {
+      int node = takeSlot(0, slot);
+      while (node != -1) {
+        int next = nodes[node].next;
+        bool active = nodes[node].active;
+        TimerEvent event = nodes[node].event;
+        //Release before calling back so the callback can reuse the node
+        releaseNode(node);
+        if (active) on_fire(event);
+        node = next;
+      }
+      return;
+    }
+};
+
+#endif
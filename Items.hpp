@@ -0,0 +1,125 @@
+/*
+* File: Items.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the items that can lie on the board: the item
+* types and the table describing what eating each one does, and ItemIndex,
+* which keeps every item on the board together with a per-cell map so the
+* item under the head is found in constant time however many are out.
+*/
+
+//Redundancy safety check
+#ifndef ITEMS_H
+#define ITEMS_H
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+//Item types, also the index into ITEM_KINDS
+const int FOOD_ITEM = 0;
+const int SLOW_MO_POWERUP = 1;
+const int GHOST_POWERUP = 2;
+const int SHRINK_POWERUP = 3;
+const int DOUBLE_SCORE_POWERUP = 4;
+const int ITEM_TYPES = 5;
+
+/*
+The ItemKind struct describes what eating an item of one type does. Every effect in the game is one of these fields,
+so eating any item runs through the same steps: instant effects first, then the lasting ones are stacked on the snake
+for the powerup time and unstacked when they expire. Stacks of the same effect add up.
+*/
+struct ItemKind
+{
+  int points; //Score added, doubled once per active double score stack
+  int growth; //Segments the snake grows by
+  int shrink; //Segments cut off the tail (the head always stays)
+  bool speeds_up; //Moves the game speed one step towards the max speed
+  bool timed; //The effects below last for the powerup time
+  bool slows; //Each stack multiplies the time per tick by the slow-mo increment
+  bool ghost; //While any stack is active the snake can pass through itself
+  bool doubles_score; //Each stack doubles the points of food
+};
+
+//What every item type does, indexed by type
+const ItemKind ITEM_KINDS[ITEM_TYPES] = {
+  //points, growth, shrink, speeds_up, timed, slows, ghost, doubles_score
+  {1, 1, 0, true, false, false, false, false}, //FOOD_ITEM
+  {0, 0, 0, false, true, true, false, false}, //SLOW_MO_POWERUP
+  {0, 0, 0, false, true, false, true, false}, //GHOST_POWERUP
+  {0, 0, 5, false, false, false, false, false}, //SHRINK_POWERUP
+  {0, 0, 0, false, true, false, false, true} //DOUBLE_SCORE_POWERUP
+};
+
+/*
+The Item struct is a single item lying on the board
+*/
+struct Item
+{
+  std::pair<int, int> cell;
+  int type; //One of the item types
+};
+
+/*
+ItemIndex Class:
+  Every item on the board, kept in a dense array for drawing and counting, plus a slot per cell of the board holding the
+  position of the item on it (0 for none, otherwise position + 1). Adding, finding and removing an item are all O(1),
+  removing moves the last item into the hole. Only one item can lie on a cell at a time.
+*/
+class ItemIndex
+{
+  public:
+    //Most items that can be on the board at once, the limit of a 16-bit slot
+    static const size_t MAX_ITEMS = 65535;
+
+    /*
+    Constructor for ItemIndex
+
+    Params: 2 integer
+    int, rows, columns: The size of the board, border included
+    */
+    ItemIndex(int rows, int columns) : board_columns(columns), slots(size_t(rows) * columns, 0) {};
+
+    //Returns the position of the item on a cell in getItems(), -1 if the cell is empty
+    int find(std::pair<int, int> cell) const {return int(slots[index(cell)]) - 1;}
+
+    //Places an item on an empty cell, returns false if the cell already holds one or the index is full
+    bool add(std::pair<int, int> cell, int type)
+    {
+      uint16_t &slot = slots[index(cell)];
+      if (slot || items.size() == MAX_ITEMS) return false;
+      items.push_back({cell, type});
+      slot = uint16_t(items.size());
+      counts[type]++;
+      return true;
+    }
+
+    //Removes and returns the item at a position in getItems()
+    Item remove(int at)
+    {
+      Item item = items[at];
+      slots[index(item.cell)] = 0;
+      if (size_t(at) + 1 != items.size()) {
+        items[at] = items.back();
+        slots[index(items[at].cell)] = uint16_t(at + 1);
+      }
+      items.pop_back();
+      counts[item.type]--;
+      return item;
+    }
+
+    const std::vector<Item>& getItems() const {return items;}
+    //Number of items of a type on the board
+    int count(int type) const {return counts[type];}
+
+  private:
+    int board_columns;
+    std::vector<uint16_t> slots;
+    std::vector<Item> items;
+    int counts[ITEM_TYPES] = {};
+
+    size_t index(std::pair<int, int> cell) const {return size_t(cell.first) * board_columns + cell.second;}
+};
+
+#endif
@@ -0,0 +1,497 @@
+/*
+* File: Level.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the levels: boards with walls, spawn zones and
+* portals besides the border. Levels are compiled from a text file into a
+* binary level pack once, laid out the way the game uses them (a packed
+* wall bitmap, a portal bitmap and a static render layer per level), so
+* loading a pack only maps the file into memory and checks the headers.
+* Nothing is parsed while playing, a wall test is a single bit test on the
+* mapped bitmap.
+*/
+
+//Redundancy safety check
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "BinaryFile.hpp"
+
+//Level pack layout constants
+const std::string LEVEL_PACK_MAGIC = "ASNL";
+const uint32_t LEVEL_PACK_VERSION = 1;
+const size_t LEVEL_PACK_HEADER_SIZE = 16; //Magic, version, level count and a reserved word, followed by a 64-bit offset per level
+const int MAX_LEVEL_SIDE = 65535; //Cells are stored as 16-bit rows and columns
+const size_t LEVEL_NAME_SIZE = 24; //Bytes of the name, zero padded
+
+//Tiles of the render layer, portal tiles hold the letter of their portal instead
+const uint8_t TILE_FLOOR = 0;
+const uint8_t TILE_WALL = 1;
+
+/*
+The LevelHeader struct starts every level in a pack. It is followed by (every part starting on an 8 byte boundary):
+the wall bitmap and the portal bitmap, rows * stride 64-bit words each with cell (row, column) in bit column % 64 of
+word row * stride + column / 64, the spawn cells, the portal pairs, and the render layer, one tile per cell row by row.
+The wall bitmap has a bit set for every cell the head can't end a tick on: the border, the walls and the portals.
+Levels are used in place, so everything in them is in the byte order of the machine that compiled the pack (little-endian
+on every machine the game runs on).
+*/
+struct LevelHeader
+{
+  uint32_t rows; //Border included
+  uint32_t columns;
+  uint32_t stride; //64-bit words per row of a bitmap
+  uint32_t spawn_count;
+  uint32_t portal_count;
+  uint32_t checksum; //FNV-1a checksum of everything after the header, identifies the level in replays
+  char name[LEVEL_NAME_SIZE];
+};
+
+//A cell of a level
+struct LevelCell
+{
+  uint16_t row;
+  uint16_t column;
+};
+
+//Two portals leading into each other
+struct LevelPortal
+{
+  LevelCell a;
+  LevelCell b;
+};
+
+static_assert(sizeof(LevelHeader) == 48 && sizeof(LevelCell) == 4 && sizeof(LevelPortal) == 8, "Level pack structs must match the file layout");
+
+/*
+The LevelLayout struct holds where each part of a level lies, counted in bytes from the start of its header
+*/
+struct LevelLayout
+{
+  uint64_t walls, portals, spawn_cells, portal_pairs, tiles, size;
+
+  static uint64_t align(uint64_t bytes) {return (bytes + 7) & ~uint64_t(7);}
+
+  LevelLayout(uint64_t rows, uint64_t columns, uint64_t stride, uint64_t spawn_count, uint64_t portal_count)
+  {
+    uint64_t bitmap = rows * stride * 8;
+    walls = sizeof(LevelHeader);
+    portals = walls + bitmap;
+    spawn_cells = portals + bitmap;
+    portal_pairs = align(spawn_cells + spawn_count * sizeof(LevelCell));
+    tiles = portal_pairs + portal_count * sizeof(LevelPortal);
+    size = align(tiles + rows * columns);
+  }
+};
+
+/*
+Level Class:
+  A view of one level, either inside a mapped level pack or built in memory for a plain bordered board. Copying a Level
+  is cheap, every copy shares the memory it points into and keeps it alive. A default constructed Level is empty.
+*/
+class Level
+{
+  public:
+    Level() {};
+
+    /*
+    Creates a view of a level record
+
+    Params: 1 shared pointer, 1 pointer
+    shared_ptr, owner: Keeps the memory holding the record alive for as long as the view exists
+    const uint8_t*, record: The LevelHeader of the level, 8 byte aligned and checked to be intact
+
+    Returns: The level
+    */
+    static Level view(std::shared_ptr<const void> owner, const uint8_t* record)
+    {
+      Level level;
+      level.owner = std::move(owner);
+      level.header = (const LevelHeader*)record;
+      LevelLayout layout(level.header->rows, level.header->columns, level.header->stride, level.header->spawn_count, level.header->portal_count);
+      level.rows = level.header->rows;
+      level.columns = level.header->columns;
+      level.stride = level.header->stride;
+      level.walls = (const uint64_t*)(record + layout.walls);
+      level.portal_bits = (const uint64_t*)(record + layout.portals);
+      level.spawns = (const LevelCell*)(record + layout.spawn_cells);
+      level.portals = (const LevelPortal*)(record + layout.portal_pairs);
+      level.tiles = record + layout.tiles;
+      return level;
+    }
+
+    /*
+    Builds a level with nothing but the border, the board every game is played on without a level pack
+
+    Params: 2 integer
+    int, rows, columns: The size of the board, border included
+
+    Returns: The level
+    */
+    static Level bordered(int rows, int columns);
+
+    //Returns true if the head can't end a tick on the cell (border, wall or portal), cells off the level count as walls
+    bool isSolid(std::pair<int, int> cell) const
+    {
+      if (unsigned(cell.first) >= unsigned(rows) || unsigned(cell.second) >= unsigned(columns)) return true;
+      return (walls[size_t(cell.first) * stride + (cell.second >> 6)] >> (cell.second & 63)) & 1;
+    }
+
+    //Returns true if the cell is a portal
+    bool isPortal(std::pair<int, int> cell) const
+    {
+      if (unsigned(cell.first) >= unsigned(rows) || unsigned(cell.second) >= unsigned(columns)) return false;
+      return (portal_bits[size_t(cell.first) * stride + (cell.second >> 6)] >> (cell.second & 63)) & 1;
+    }
+
+    //Returns the portal a portal cell leads to (the cell itself if it has no pair), a scan of the few pairs of the level
+    std::pair<int, int> portalExit(std::pair<int, int> cell) const
+    {
+      for (uint32_t i = 0; i < header->portal_count; i++) {
+        const LevelPortal &portal = portals[i];
+        if (portal.a.row == cell.first && portal.a.column == cell.second) return {portal.b.row, portal.b.column};
+        if (portal.b.row == cell.first && portal.b.column == cell.second) return {portal.a.row, portal.a.column};
+      }
+      return cell;
+    }
+
+    //Returns the tile of the render layer on a cell: TILE_FLOOR, TILE_WALL or the letter of a portal
+    uint8_t getTile(std::pair<int, int> cell) const {return tiles[size_t(cell.first) * columns + cell.second];}
+
+    //Returns the words of a row of the wall bitmap
+    const uint64_t* wallRow(int row) const {return walls + size_t(row) * stride;}
+
+    std::pair<int, int> getSpawn(size_t i) const {return {spawns[i].row, spawns[i].column};}
+    size_t getSpawnCount() const {return header ? header->spawn_count : 0;}
+    size_t getPortalCount() const {return header ? header->portal_count : 0;}
+    std::string getName() const {return header ? std::string(header->name, strnlen(header->name, LEVEL_NAME_SIZE)) : "";}
+    uint32_t getChecksum() const {return header ? header->checksum : 0;}
+    int getRows() const {return rows;}
+    int getColumns() const {return columns;}
+    bool isEmpty() const {return header == nullptr;}
+
+  private:
+    std::shared_ptr<const void> owner;
+    const LevelHeader* header = nullptr;
+    int rows = 0;
+    int columns = 0;
+    size_t stride = 0;
+    const uint64_t* walls = nullptr;
+    const uint64_t* portal_bits = nullptr;
+    const LevelCell* spawns = nullptr;
+    const LevelPortal* portals = nullptr;
+    const uint8_t* tiles = nullptr;
+};
+
+/*
+Lays out one level record from its render layer, the bitmaps are worked out from the tiles
+
+Params: 2 integer, 1 byte vector, 2 vector, 1 string
+int, rows, columns: The size of the level, border included
+vector<uint8_t>, tiles: One tile per cell row by row, the border must be TILE_WALL
+vector<LevelCell>, spawns: The spawn cells
+vector<LevelPortal>, portals: The portal pairs
+string, name: The name of the level, cut to LEVEL_NAME_SIZE - 1 characters
+
+Returns: The bytes of the record, a multiple of 8 long
+*/
+std::vector<uint8_t> buildLevelRecord(int rows, int columns, const std::vector<uint8_t>& tiles, const std::vector<LevelCell>& spawns,
+                                      const std::vector<LevelPortal>& portals, const std::string& name)
+{
+  LevelHeader header = {};
+  header.rows = rows;
+  header.columns = columns;
+  header.stride = (columns + 63) / 64;
+  header.spawn_count = spawns.size();
+  header.portal_count = portals.size();
+  name.copy(header.name, LEVEL_NAME_SIZE - 1);
+  LevelLayout layout(rows, columns, header.stride, spawns.size(), portals.size());
+
+  std::vector<uint8_t> record(layout.size, 0);
+  uint64_t* walls = (uint64_t*)(record.data() + layout.walls);
+  uint64_t* portal_bits = (uint64_t*)(record.data() + layout.portals);
+  for (int r = 0; r < rows; r++) {
+    for (int c = 0; c < columns; c++) {
+      uint8_t tile = tiles[size_t(r) * columns + c];
+      uint64_t bit = uint64_t(1) << (c & 63);
+      if (tile != TILE_FLOOR) walls[size_t(r) * header.stride + (c >> 6)] |= bit;
+      if (tile != TILE_FLOOR && tile != TILE_WALL) portal_bits[size_t(r) * header.stride + (c >> 6)] |= bit;
+    }
+  }
+  if (!spawns.empty()) memcpy(record.data() + layout.spawn_cells, spawns.data(), spawns.size() * sizeof(LevelCell));
+  if (!portals.empty()) memcpy(record.data() + layout.portal_pairs, portals.data(), portals.size() * sizeof(LevelPortal));
+  memcpy(record.data() + layout.tiles, tiles.data(), tiles.size());
+
+  header.checksum = checksumBytes(record.data() + sizeof(LevelHeader), record.size() - sizeof(LevelHeader));
+  memcpy(record.data(), &header, sizeof(LevelHeader));
+  return record;
+}
+
+Level Level::bordered(int rows, int columns)
+{
+  std::vector<uint8_t> tiles(size_t(rows) * columns, TILE_FLOOR);
+  for (int r = 0; r < rows; r++) {
+    for (int c = 0; c < columns; c++) {
+      if (r == 0 || c == 0 || r == rows - 1 || c == columns - 1) tiles[size_t(r) * columns + c] = TILE_WALL;
+    }
+  }
+  std::vector<uint8_t> record = buildLevelRecord(rows, columns, tiles, {}, {}, "");
+  //Copied into 64-bit words so the bitmaps are aligned like in a mapped pack
+  std::shared_ptr<std::vector<uint64_t>> memory = std::make_shared<std::vector<uint64_t>>(record.size() / 8);
+  memcpy(memory->data(), record.data(), record.size());
+  return view(memory, (const uint8_t*)memory->data());
+}
+
+/*
+LevelPack Class:
+  A level pack file mapped read-only into memory. Opening a pack reads nothing but its header and offset table, so it
+  takes the same time however many levels it holds, and the pages of a level are only read from disk once the game
+  touches them. A level is checked when it is first looked up: its header, its size and its border, spawn cells and
+  portals must lie inside the file and the level, so a damaged pack can't make the game read outside the mapping.
+  Levels keep the pack mapped for as long as any of them is in use.
+*/
+class LevelPack : public std::enable_shared_from_this<LevelPack>
+{
+  public:
+    /*
+    Maps a level pack
+
+    Params: 1 string
+    string, path: The pack file
+
+    Returns: The pack, throws runtime_error with the reason if it can't be opened or is not a level pack
+    */
+    static std::shared_ptr<LevelPack> open(const std::string& path)
+    {
+      int fd = ::open(path.c_str(), O_RDONLY);
+      if (fd < 0) throw std::runtime_error("Could not read " + path);
+      struct stat info;
+      if (fstat(fd, &info) != 0 || info.st_size < (off_t)LEVEL_PACK_HEADER_SIZE) {
+        close(fd);
+        throw std::runtime_error(path + " is not a " + LEVEL_PACK_MAGIC + " file");
+      }
+      void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      //The mapping stays valid after the file is closed
+      close(fd);
+      if (mapped == MAP_FAILED) throw std::runtime_error("Could not map " + path);
+
+      std::shared_ptr<LevelPack> pack(new LevelPack(path, (const uint8_t*)mapped, info.st_size));
+      ByteReader header(pack->data, LEVEL_PACK_HEADER_SIZE);
+      char tag[4];
+      header.getBytes(tag, 4);
+      if (std::string(tag, 4) != LEVEL_PACK_MAGIC) throw std::runtime_error(path + " is not a " + LEVEL_PACK_MAGIC + " file");
+      if (header.get32() != LEVEL_PACK_VERSION) throw std::runtime_error(path + " was written by an unsupported version");
+      pack->count = header.get32();
+      if ((pack->bytes - LEVEL_PACK_HEADER_SIZE) / 8 < pack->count) throw std::runtime_error(path + " is truncated");
+      return pack;
+    }
+
+    ~LevelPack() {munmap((void*)data, bytes);}
+    LevelPack(const LevelPack&) = delete;
+    LevelPack& operator=(const LevelPack&) = delete;
+
+    /*
+    Looks up a level of the pack
+
+    Params: 1 size_t
+    size_t, index: The level, counting from 0
+
+    Returns: The level, throws runtime_error if there is no such level or it is damaged
+    */
+    Level level(size_t index) const
+    {
+      if (index >= count) throw std::runtime_error(path + " has " + std::to_string(count) + " levels, there is no level " + std::to_string(index + 1));
+      uint64_t offset;
+      memcpy(&offset, data + LEVEL_PACK_HEADER_SIZE + index * 8, 8);
+      std::string damaged = path + " is damaged (level " + std::to_string(index + 1) + ")";
+      if (offset % 8 != 0 || offset > bytes || bytes - offset < sizeof(LevelHeader)) throw std::runtime_error(damaged);
+
+      const uint8_t* record = data + offset;
+      const LevelHeader &header = *(const LevelHeader*)record;
+      if (header.rows < 3 || header.columns < 3 || header.rows > uint32_t(MAX_LEVEL_SIDE) || header.columns > uint32_t(MAX_LEVEL_SIDE)) throw std::runtime_error(damaged);
+      if (header.stride != (header.columns + 63) / 64) throw std::runtime_error(damaged);
+      if (header.spawn_count > bytes || header.portal_count > bytes) throw std::runtime_error(damaged);
+      LevelLayout layout(header.rows, header.columns, header.stride, header.spawn_count, header.portal_count);
+      if (layout.size > bytes - offset) throw std::runtime_error(damaged);
+
+      Level level = Level::view(std::shared_ptr<const void>(shared_from_this(), data), record);
+      //The head never leaves the level as long as the border is solid and spawns and portals lie inside it
+      for (int c = 0; c < level.getColumns(); c++) {
+        if (!level.isSolid({0, c}) || !level.isSolid({level.getRows() - 1, c})) throw std::runtime_error(damaged);
+      }
+      for (int r = 0; r < level.getRows(); r++) {
+        if (!level.isSolid({r, 0}) || !level.isSolid({r, level.getColumns() - 1})) throw std::runtime_error(damaged);
+      }
+      auto inside = [&](const LevelCell &cell) {
+        return cell.row > 0 && cell.column > 0 && cell.row < header.rows - 1 && cell.column < header.columns - 1;
+      };
+      const LevelCell* spawns = (const LevelCell*)(record + layout.spawn_cells);
+      for (uint32_t i = 0; i < header.spawn_count; i++) if (!inside(spawns[i])) throw std::runtime_error(damaged);
+      const LevelPortal* portals = (const LevelPortal*)(record + layout.portal_pairs);
+      for (uint32_t i = 0; i < header.portal_count; i++) if (!inside(portals[i].a) || !inside(portals[i].b)) throw std::runtime_error(damaged);
+      return level;
+    }
+
+    size_t size() const {return count;}
+    const std::string& getPath() const {return path;}
+
+  private:
+    std::string path;
+    const uint8_t* data;
+    size_t bytes;
+    uint32_t count = 0;
+
+    LevelPack(const std::string& file, const uint8_t* mapped, size_t size) : path(file), data(mapped), bytes(size) {};
+};
+
+/*
+Opens a level pack and looks up one of its levels
+
+Params: 1 string, 1 size_t
+string, path: The pack file
+size_t, index: The level, counting from 0
+
+Returns: The level, throws runtime_error with the reason if it can't be loaded
+*/
+Level openLevel(const std::string& path, size_t index)
+{
+  return LevelPack::open(path)->level(index);
+}
+
+/*
+Compiles the text form of a level pack. Every level starts with a line "= NAME", followed by its rows: '#' is a wall,
+'.' or a space is floor, 'S' a spawn cell and any other letter a portal, each portal letter must appear exactly twice
+and the two cells lead into each other. The border is added around the rows, shorter rows are filled up with floor.
+Lines before the first level and lines starting with ';' are ignored, as are blank lines at the end of a level.
+
+Params: 1 string
+string, text: The text form of the pack
+
+Returns: The bytes of the pack, throws invalid_argument naming the line of the first mistake
+*/
+std::vector<uint8_t> compileLevelPack(const std::string& text)
+{
+  //Split into levels, each a name and its rows
+  struct Source {std::string name; size_t line; std::vector<std::string> rows;};
+  std::vector<Source> sources;
+  size_t line_number = 0, start = 0;
+  while (start < text.size()) {
+    size_t end = text.find('\n', start);
+    if (end == std::string::npos) end = text.size();
+    std::string line = text.substr(start, end - start);
+    start = end + 1;
+    line_number++;
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (!line.empty() && line[0] == ';') continue;
+    if (!line.empty() && line[0] == '=') {
+      size_t name_start = line.find_first_not_of(" ", 1);
+      sources.push_back({name_start == std::string::npos ? "" : line.substr(name_start), line_number, {}});
+    }
+    else if (!sources.empty()) sources.back().rows.push_back(line);
+  }
+  if (sources.empty()) throw std::invalid_argument("The level pack has no levels, start each level with a line \"= NAME\"");
+
+  std::vector<std::vector<uint8_t>> records;
+  for (Source &source:sources) {
+    std::string where = "Level \"" + source.name + "\" (line " + std::to_string(source.line) + "): ";
+    while (!source.rows.empty() && source.rows.back().find_first_not_of(" ") == std::string::npos) source.rows.pop_back();
+    if (source.rows.empty()) throw std::invalid_argument(where + "the level has no rows");
+    size_t width = 0;
+    for (const std::string &row:source.rows) width = std::max(width, row.size());
+    if (source.rows.size() + 2 > size_t(MAX_LEVEL_SIDE) || width + 2 > size_t(MAX_LEVEL_SIDE)) throw std::invalid_argument(where + "a level can be at most " + std::to_string(MAX_LEVEL_SIDE) + " cells on each side");
+
+    int rows = source.rows.size() + 2, columns = width + 2;
+    std::vector<uint8_t> tiles(size_t(rows) * columns, TILE_FLOOR);
+    std::vector<LevelCell> spawns;
+    std::vector<std::vector<LevelCell>> portal_cells(128);
+    for (int r = 0; r < rows; r++) {
+      for (int c = 0; c < columns; c++) {
+        uint8_t &tile = tiles[size_t(r) * columns + c];
+        if (r == 0 || c == 0 || r == rows - 1 || c == columns - 1) {
+          tile = TILE_WALL;
+          continue;
+        }
+        const std::string &row = source.rows[r - 1];
+        char cell = size_t(c - 1) < row.size() ? row[c - 1] : '.';
+        if (cell == '#') tile = TILE_WALL;
+        else if (cell == 'S') spawns.push_back({uint16_t(r), uint16_t(c)});
+        else if (isalpha((unsigned char)cell)) {
+          tile = cell;
+          portal_cells[cell].push_back({uint16_t(r), uint16_t(c)});
+        }
+        else if (cell != '.' && cell != ' ') {
+          throw std::invalid_argument(where + "unknown cell '" + std::string(1, cell) + "' on line " + std::to_string(source.line + r));
+        }
+      }
+    }
+    if (spawns.empty()) throw std::invalid_argument(where + "the level needs at least one spawn cell 'S'");
+    std::vector<LevelPortal> portals;
+    for (int letter = 0; letter < 128; letter++) {
+      if (portal_cells[letter].empty()) continue;
+      if (portal_cells[letter].size() != 2) throw std::invalid_argument(where + "portal '" + std::string(1, char(letter)) + "' must appear exactly twice");
+      portals.push_back({portal_cells[letter][0], portal_cells[letter][1]});
+    }
+
+    //Food spawns on any floor cell, so every one of them must be reachable from the spawn cells, walking or through portals
+    std::vector<uint8_t> reached(tiles.size(), 0);
+    std::vector<size_t> queue;
+    for (const LevelCell &spawn:spawns) {
+      reached[size_t(spawn.row) * columns + spawn.column] = 1;
+      queue.push_back(size_t(spawn.row) * columns + spawn.column);
+    }
+    const int steps[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+    for (size_t next = 0; next < queue.size(); next++) {
+      int r = queue[next] / columns, c = queue[next] % columns;
+      for (const int *step:steps) {
+        int to_r = r + step[0], to_c = c + step[1];
+        uint8_t tile = tiles[size_t(to_r) * columns + to_c];
+        if (tile != TILE_FLOOR && tile != TILE_WALL) {
+          const std::vector<LevelCell> &pair = portal_cells[tile];
+          const LevelCell &exit = (pair[0].row == to_r && pair[0].column == to_c) ? pair[1] : pair[0];
+          to_r = exit.row + step[0];
+          to_c = exit.column + step[1];
+        }
+        size_t to = size_t(to_r) * columns + to_c;
+        if (tiles[to] != TILE_FLOOR || reached[to]) continue;
+        reached[to] = 1;
+        queue.push_back(to);
+      }
+    }
+    for (size_t cell = 0; cell < tiles.size(); cell++) {
+      if (tiles[cell] != TILE_FLOOR || reached[cell]) continue;
+      throw std::invalid_argument(where + "the floor on line " + std::to_string(source.line + cell / columns) + ", column " + std::to_string(cell % columns) +
+                                  " can't be reached from a spawn cell");
+    }
+    records.push_back(buildLevelRecord(rows, columns, tiles, spawns, portals, source.name));
+  }
+
+  //Header, offset table, then the levels one after another
+  ByteWriter pack;
+  pack.putBytes(LEVEL_PACK_MAGIC.data(), 4);
+  pack.put32(LEVEL_PACK_VERSION);
+  pack.put32(records.size());
+  pack.put32(0);
+  uint64_t offset = LEVEL_PACK_HEADER_SIZE + records.size() * 8;
+  for (const std::vector<uint8_t> &record:records) {
+    pack.put64(offset);
+    offset += record.size();
+  }
+  for (const std::vector<uint8_t> &record:records) pack.putBytes(record.data(), record.size());
+  return pack.bytes;
+}
+
+#endif
@@ -0,0 +1,278 @@
+/*
+* File: Mcts.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the MctsBot, a bot that picks its moves with a
+* Monte Carlo tree search: it plays out thousands of short randomized
+* continuations of the game from the current tick and takes the move whose
+* continuations went best. Every worker thread searches its own tree and
+* the trees' votes are added up, so more cores mean more rollouts per tick.
+*/
+
+//Redundancy safety check
+#ifndef MCTS_H
+#define MCTS_H
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+#include "Engine.hpp"
+#include "Bot.hpp"
+#include "ThreadPool.hpp"
+
+using namespace std;
+
+/*
+MctsBot Class:
+  An open-loop tree search: a node stands for a sequence of moves from the current tick rather than for one exact state,
+  because food spawns are random. Every iteration copies the real game into the worker's pooled GameState, gives the copy
+  a fresh generator (so the bot samples spawns rather than foreseeing them), walks down the tree picking moves by UCB1,
+  adds one new node, plays a short rollout with a mostly greedy random policy and scores the result.
+
+  Nodes live in a fixed pool per worker, allocated once. After each tick the child for the move that was actually taken
+  becomes the new root, so its statistics carry over to the next search. The pool is only wiped once it fills up.
+*/
+class MctsBot : public Bot
+{
+  public:
+    /*
+    Constructor for MctsBot
+
+    Params: 2 size_t, 1 double, 1 uint64_t
+    size_t, threads: Worker threads searching in parallel, 0 uses one per hardware thread
+    double, budget_fraction: Share of the tick (game speed milliseconds) spent searching
+    size_t, iterations: If not 0, every worker runs exactly this many iterations per tick instead of watching the clock,
+                        which makes the bot deterministic for a given seed and thread count
+    uint64_t, seed: Seed of the workers' generators
+    */
+    MctsBot(size_t threads=0, double budget_fraction=0.5, size_t iterations=0, uint64_t seed=0) :
+     pool(threads), time_fraction(budget_fraction), fixed_iterations(iterations)
+    {
+      for (size_t i = 0; i < pool.size(); i++) {
+        workers.emplace_back(new Worker);
+        workers.back()->nodes.resize(NODE_POOL_SIZE);
+        workers.back()->rng.reseed(seed + i * 0x9E3779B97F4A7C15ull);
+      }
+    }
+
+    /*
+    Picks the direction for the next tick
+
+    Params: 1 GameState
+    GameState, game: The game, before the tick is run
+
+    Returns: The direction whose subtree was visited most across all workers
+    */
+    char decide(const GameState &game) override
+    {
+      //Keep the subtree of the move that was taken if exactly one tick passed since the last search
+      bool reuse = game.getTick() == last_tick + 1 && game.getTick() != 0;
+      for (auto &worker:workers) {
+        if (reuse) reroot(*worker, directionIndex(game.getDirection()));
+        else resetTree(*worker);
+      }
+      last_tick = game.getTick();
+
+      auto deadline = chrono::steady_clock::now() + chrono::microseconds(uint64_t(game.getSpeed() * 1000 * time_fraction));
+      for (size_t i = 0; i < workers.size(); i++) {
+        Worker *worker = workers[i].get();
+        pool.submit([this, worker, &game, deadline]() {search(*worker, game, deadline);});
+      }
+      pool.wait();
+
+      //Add up the votes of every worker's tree
+      uint64_t visits[4] = {0, 0, 0, 0};
+      last_rollouts = 0;
+      for (auto &worker:workers) {
+        const Node &root = worker->nodes[worker->root];
+        for (int d = 0; d < 4; d++) if (root.children[d] >= 0) visits[d] += worker->nodes[root.children[d]].visits;
+        last_rollouts += worker->rollouts;
+      }
+      int best = -1;
+      for (int d = 0; d < 4; d++) if (visits[d] > 0 && (best < 0 || visits[d] > visits[best])) best = d;
+      return best < 0 ? 0 : DIRECTIONS[best];
+    }
+
+    //Number of rollouts played for the last decision, across all workers
+    uint64_t getLastRollouts() const {return last_rollouts;}
+
+  private:
+    static const size_t NODE_POOL_SIZE = 1 << 16;
+    static const int ROLLOUT_DEPTH = 40;
+    static constexpr double EXPLORATION = 0.7;
+    static constexpr double FOOD_DISCOUNT = 0.9; //Food eaten a tick later is worth this much of food eaten now
+    static constexpr const char* DIRECTIONS = "wasd";
+
+    struct Node
+    {
+      int parent;
+      int children[4]; //Index of the child for each direction in DIRECTIONS, -1 if not expanded
+      uint32_t visits;
+      double total; //Sum of the rewards of every iteration through this node
+    };
+
+    struct Worker
+    {
+      vector<Node> nodes;
+      size_t used = 0;
+      int root = -1;
+      unique_ptr<GameState> scratch; //Pooled copy of the game the iterations play on
+      Random rng;
+      uint64_t rollouts = 0;
+    };
+
+    ThreadPool pool;
+    vector<unique_ptr<Worker>> workers;
+    const double time_fraction;
+    const size_t fixed_iterations;
+    uint64_t last_tick = 0;
+    uint64_t last_rollouts = 0;
+
+    static int directionIndex(char direction)
+    {
+      for (int d = 0; d < 4; d++) if (DIRECTIONS[d] == direction) return d;
+      return -1;
+    }
+
+    static int newNode(Worker &worker, int parent)
+    {
+      if (worker.used == worker.nodes.size()) return -1;
+      Node &node = worker.nodes[worker.used];
+      node.parent = parent;
+      for (int d = 0; d < 4; d++) node.children[d] = -1;
+      node.visits = 0;
+      node.total = 0;
+      return int(worker.used++);
+    }
+
+    static void resetTree(Worker &worker)
+    {
+      worker.used = 0;
+      worker.root = newNode(worker, -1);
+      return;
+    }
+
+    //Makes the child for the move that was taken the new root, or starts over if it was never explored or the pool is mostly used
+    static void reroot(Worker &worker, int direction)
+    {
+      if (worker.root < 0 || direction < 0 || worker.used > worker.nodes.size() / 4 * 3) return resetTree(worker);
+      int child = worker.nodes[worker.root].children[direction];
+      if (child < 0) return resetTree(worker);
+      worker.root = child;
+      worker.nodes[child].parent = -1;
+      return;
+    }
+
+    //Returns true if the head could move onto the cell on the next tick
+    static bool isSafe(const GameState &sim, ipair cell)
+    {
+      if (sim.isBlocked(cell)) return false;
+      if (!sim.occupies(cell)) return true;
+      const SnakeBody &body = sim.getBody();
+      return body.size() > 2 && sim.getPendingGrowth() == 0 && cell == body.back();
+    }
+
+    //Rollout policy: usually the safe move closest to the food, otherwise a random safe move
+    static char rolloutMove(const GameState &sim, Random &rng)
+    {
+      const ipair head = sim.getBody().front();
+      const ipair food = sim.getFood();
+      char safe[3];
+      int safe_count = 0, best = -1, best_distance = 0;
+      for (int d = 0; d < 4; d++) {
+        if (isReverseDirection(DIRECTIONS[d], sim.getDirection())) continue;
+        ipair next = stepCell(head, DIRECTIONS[d]);
+        if (!isSafe(sim, next)) continue;
+        int distance = food.first < 0 ? 0 : abs(next.first - food.first) + abs(next.second - food.second);
+        if (best < 0 || distance < best_distance) {
+          best = safe_count;
+          best_distance = distance;
+        }
+        safe[safe_count++] = DIRECTIONS[d];
+      }
+      if (safe_count == 0) return 0;
+      if (rng.range(4) != 0) return safe[best];
+      return safe[rng.range(safe_count)];
+    }
+
+    //Runs iterations on one worker's tree until the deadline (or the fixed iteration count)
+    void search(Worker &worker, const GameState &game, chrono::steady_clock::time_point deadline)
+    {
+      if (!worker.scratch) worker.scratch.reset(new GameState(game));
+      GameState &sim = *worker.scratch;
+      worker.rollouts = 0;
+
+      for (size_t iteration = 0; ; iteration++) {
+        if (fixed_iterations ? iteration >= fixed_iterations : (iteration % 16 == 0 && chrono::steady_clock::now() >= deadline)) break;
+
+        //Pooled copy, the vectors inside keep their capacity so copying doesn't allocate
+        sim = game;
+        sim.reseedRandom(worker.rng.next());
+        //Depth (ticks after the current one) and the discounted value of the food eaten so far
+        int depth = 0;
+        double food_value = 0;
+        auto advance = [&](char direction) {
+          int score = sim.getScore();
+          sim.step(direction);
+          if (sim.getScore() > score) food_value += pow(FOOD_DISCOUNT, depth);
+          depth++;
+        };
+
+        //Selection and expansion: follow UCB1 down the tree until a move that has no node yet
+        int node = worker.root;
+        while (sim.isAlive()) {
+          Node &current = worker.nodes[node];
+          int chosen = -1, unexplored = -1;
+          double best_value = 0;
+          for (int d = 0; d < 4; d++) {
+            if (isReverseDirection(DIRECTIONS[d], sim.getDirection())) continue;
+            int child = current.children[d];
+            if (child < 0) {
+              if (unexplored < 0) unexplored = d;
+              continue;
+            }
+            const Node &c = worker.nodes[child];
+            double value = c.total / c.visits + EXPLORATION * sqrt(log(double(current.visits)) / c.visits);
+            if (chosen < 0 || value > best_value) {
+              chosen = d;
+              best_value = value;
+            }
+          }
+
+          if (unexplored >= 0) {
+            //Expand one new node and continue with a rollout from it (if the pool is full the rollout starts here instead)
+            int child = newNode(worker, node);
+            advance(DIRECTIONS[unexplored]);
+            if (child >= 0) {
+              worker.nodes[node].children[unexplored] = child;
+              node = child;
+            }
+            break;
+          }
+          advance(DIRECTIONS[chosen]);
+          node = worker.nodes[node].children[chosen];
+        }
+
+        //Rollout
+        for (int rollout_depth = 0; rollout_depth < ROLLOUT_DEPTH && sim.isAlive(); rollout_depth++) advance(rolloutMove(sim, worker.rng));
+        worker.rollouts++;
+
+        //Surviving counts for half (dying later is less bad), food for the rest, and sooner food is worth more
+        bool died = !sim.isAlive() && !sim.isWon();
+        double survival = died ? 0.5 * depth / (depth + ROLLOUT_DEPTH) : 0.5;
+        double reward = survival + 0.5 * min(1.0, food_value);
+
+        for (int n = node; n >= 0; n = worker.nodes[n].parent) {
+          worker.nodes[n].visits++;
+          worker.nodes[n].total += reward;
+        }
+      }
+      return;
+    }
+};
+
+#endif
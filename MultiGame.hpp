@@ -0,0 +1,388 @@
+/*
+* File: MultiGame.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the multi-snake game: MultiGameState puts many
+* snakes on one board, some steered by local players and the rest by bots.
+* The snakes are stored structure of arrays style (every per-snake field in
+* its own array indexed by snake) and share a single occupancy grid that
+* records which snake covers each cell, so a tick only looks at the heads
+* and tails of the snakes and costs the same at any total body length.
+*/
+
+//Redundancy safety check
+#ifndef MULTIGAME_H
+#define MULTIGAME_H
+
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include "Board.hpp"
+#include "Random.hpp"
+#include "GameConfig.hpp"
+#include "Engine.hpp"
+#include "Bot.hpp"
+
+using namespace std;
+
+/*
+The MultiStepResult struct lists what changed on the board during a single tick of a MultiGameState,
+it is reused from tick to tick so observers don't allocate
+*/
+struct MultiStepResult
+{
+  vector<ipair> cleared; //Cells that became empty: tails that moved and the bodies of snakes that died
+  vector<ipair> food_spawned; //Cells where new food appeared
+  vector<size_t> died; //Snakes that died this tick
+  bool ate_food = false; //At least one snake ate this tick
+};
+
+/*
+MultiGameState Class:
+  A game of snake with several snakes on the same board. Every snake dies when its head hits the border, the body of any
+  snake (its own included), or when two heads move onto the same cell in the same tick, in which case both die. A tail
+  that moves away in the same tick leaves its cell free for any head. Eating food scores a point and grows the snake by
+  one segment, and the food is replaced right away, so the number of food items on the board stays the same.
+
+  The board uses the GameState coordinates, (row, column) with the border on the outermost rows and columns. owner holds
+  the index of the snake covering each cell (-1 for an empty cell). A tick moves every living snake in four linear passes
+  over the snakes (turn, pop tails, check the new heads, push heads), and a snake's body is only walked once, when it dies.
+  Powerups and speed changes are left out, every tick takes the initial speed of the config.
+
+  Like GameState it keeps a Zobrist hash of the board, here with a key per (snake, cell) segment, per food item and per
+  snake's direction and score, updated with an XOR for every change, so getStateHash is O(1) per tick.
+*/
+class MultiGameState
+{
+  public:
+    /*
+    Constructor for MultiGameState, places every snake at a random starting position drawn from the seed
+
+    Params: 1 GameConfig, 2 size_t
+    GameConfig, game_config: The board size, speed and seed of the game
+    size_t, snakes: Number of snakes, index 0 first
+    size_t, food_count: Food items kept on the board, 0 picks one per two snakes
+
+    Throws invalid_argument if there are no snakes or the board has fewer than 8 free cells per snake
+    */
+    MultiGameState(const GameConfig& game_config, size_t snakes, size_t food_count=0) :
+     config(game_config), board_rows(game_config.rows - BOARD_TOP_ROW), board_columns(game_config.columns),
+     free_cells(1, 1, board_rows - 2, board_columns - 2), rng(game_config.seed)
+    {
+      if (snakes == 0) throw invalid_argument("A multi-snake game needs at least one snake");
+      if (board_rows < 8 || board_columns < 8 || size_t(board_rows - 4) * (board_columns - 4) < snakes * 8) {
+        throw invalid_argument("The board is too small for " + to_string(snakes) + " snakes");
+      }
+
+      size_t cells = size_t(board_rows) * board_columns;
+      owner.assign(cells, -1);
+      food_slot.assign(cells, -1);
+      claim_tick.assign(cells, 0);
+      claim_snake.assign(cells, 0);
+
+      direction.resize(snakes);
+      alive.assign(snakes, 1);
+      score.assign(snakes, 0);
+      pending_growth.assign(snakes, 0);
+      bodies.resize(snakes);
+      target.resize(snakes);
+      dying.assign(snakes, 0);
+      alive_count = snakes;
+
+      //Starting positions are kept 2 cells from the border, each snake heads for the far side of the board
+      for (size_t i = 0; i < snakes; i++) {
+        ipair start;
+        do {
+          start = {int(rng.range(board_rows - 4)) + 2, int(rng.range(board_columns - 4)) + 2};
+        } while (owner[index(start)] >= 0);
+        direction[i] = start.second < board_columns / 2 ? 'd' : 'a';
+        board_hash ^= directionKey(i) ^ scoreKey(i);
+        bodies[i].pushFront(start);
+        board_hash ^= segmentKey(i, start);
+        owner[index(start)] = int32_t(i);
+        free_cells.take(start);
+      }
+
+      size_t foods = food_count ? food_count : (snakes + 1) / 2;
+      for (size_t i = 0; i < foods; i++) {
+        food.push_back({-1, -1});
+        spawnFood(i);
+      }
+    }
+
+    /*
+    Advances the game by one tick. Does nothing once the game is over.
+
+    Params: 1 char pointer
+    const char*, inputs: One new direction per snake ('w', 'a', 's', 'd', 0 keeps going straight), or nullptr for no turns
+
+    Returns: What changed during the tick, valid until the next call
+    */
+    const MultiStepResult& step(const char* inputs=nullptr)
+    {
+      result.cleared.clear();
+      result.food_spawned.clear();
+      result.died.clear();
+      result.ate_food = false;
+      if (isOver()) return result;
+      tick++;
+      const size_t snakes = direction.size();
+
+      //Turn and find the cell every head moves onto
+      for (size_t i = 0; i < snakes; i++) {
+        if (!alive[i]) continue;
+        if (inputs && inputs[i]) changeDirection(i, inputs[i]);
+        target[i] = stepCell(bodies[i].front(), direction[i]);
+      }
+
+      //Pop the tails first so a head may follow right behind any tail
+      for (size_t i = 0; i < snakes; i++) {
+        if (!alive[i]) continue;
+        if (pending_growth[i] > 0) {
+          pending_growth[i]--;
+          continue;
+        }
+        ipair tail = bodies[i].popBack();
+        board_hash ^= segmentKey(i, tail);
+        owner[index(tail)] = -1;
+        free_cells.release(tail);
+        result.cleared.push_back(tail);
+      }
+
+      //Check the new heads, the first head to claim a cell this tick is stamped on it so a second one finds it
+      for (size_t i = 0; i < snakes; i++) {
+        if (!alive[i]) continue;
+        const ipair cell = target[i];
+        if (cell.first <= 0 || cell.second <= 0 || cell.first >= board_rows - 1 || cell.second >= board_columns - 1 || owner[index(cell)] >= 0) {
+          kill(i);
+          continue;
+        }
+        size_t id = index(cell);
+        if (claim_tick[id] == tick) {
+          //Head on collision, both snakes die
+          kill(i);
+          kill(claim_snake[id]);
+          continue;
+        }
+        claim_tick[id] = tick;
+        claim_snake[id] = uint32_t(i);
+      }
+
+      //Push the heads of the survivors and let them eat, eaten food is replaced once every head is on the board (below),
+      //or it could appear under a head pushed later in this pass and be eaten on the tick it appeared
+      for (size_t i = 0; i < snakes; i++) {
+        if (!alive[i] || dying[i]) continue;
+        const ipair cell = target[i];
+        size_t id = index(cell);
+        bodies[i].pushFront(cell);
+        board_hash ^= segmentKey(i, cell);
+        owner[id] = int32_t(i);
+        free_cells.take(cell);
+        if (food_slot[id] >= 0) {
+          food[food_slot[id]] = {-1, -1};
+          food_slot[id] = -1;
+          board_hash ^= foodKey(cell);
+          board_hash ^= scoreKey(i);
+          score[i]++;
+          board_hash ^= scoreKey(i);
+          pending_growth[i]++;
+          result.ate_food = true;
+        }
+      }
+
+      //Clear the bodies of the snakes that died, the only pass that depends on body length
+      for (size_t i:result.died) {
+        alive[i] = 0;
+        dying[i] = 0;
+        alive_count--;
+        while (!bodies[i].empty()) {
+          ipair segment = bodies[i].popBack();
+          board_hash ^= segmentKey(i, segment);
+          owner[index(segment)] = -1;
+          free_cells.release(segment);
+          result.cleared.push_back(segment);
+        }
+      }
+
+      //Replace the food eaten this tick, and food that found no room earlier tries again
+      for (size_t slot = 0; slot < food.size(); slot++) if (food[slot].first < 0) spawnFood(slot);
+      return result;
+    }
+
+    /*
+    Changes the direction of a snake, unless the new direction is opposite to its current one
+
+    Params: 1 size_t, 1 char
+    size_t, snake: The snake to turn
+    char, new_direction: 'w', 'a', 's' or 'd'
+
+    Returns: Void
+    */
+    void changeDirection(size_t snake, char new_direction)
+    {
+      if (new_direction != 'w' && new_direction != 'a' && new_direction != 's' && new_direction != 'd') return;
+      if (isReverseDirection(new_direction, direction[snake])) return;
+      board_hash ^= directionKey(snake);
+      direction[snake] = new_direction;
+      board_hash ^= directionKey(snake);
+      return;
+    }
+
+    /*
+    Returns a 64 bit hash of the whole game: the Zobrist hash of the segments, food, directions and scores, with the
+    tick, the number of snakes left and the generator state folded in.
+
+    Params: None
+
+    Returns: The hash, equal for two games in the same state
+    */
+    uint64_t getStateHash() const
+    {
+      uint64_t hash = mixHash(board_hash, tick);
+      hash = mixHash(hash, alive_count);
+      for (int i = 0; i < 4; i++) hash = mixHash(hash, rng.getState()[i]);
+      return hash;
+    }
+
+    /*
+    Returns true once at most one snake is left (no snake left for a single snake game)
+
+    Params: None
+
+    Returns: Whether the game is over
+    */
+    bool isOver() const {return alive_count == 0 || (direction.size() > 1 && alive_count <= 1);}
+
+    /*
+    Get respective private values (in function name)
+
+    Params: None (or the snake index)
+
+    Returns: The respective value
+    */
+    const GameConfig& getConfig() const {return config;}
+    int getRows() const {return board_rows;}
+    int getColumns() const {return board_columns;}
+    size_t getSnakeCount() const {return direction.size();}
+    size_t getAliveCount() const {return alive_count;}
+    bool isAlive(size_t snake) const {return alive[snake];}
+    char getDirection(size_t snake) const {return direction[snake];}
+    int getScore(size_t snake) const {return score[snake];}
+    const SnakeBody& getBody(size_t snake) const {return bodies[snake];}
+    const vector<ipair>& getFood() const {return food;}
+    uint64_t getTick() const {return tick;}
+
+    //Returns the snake covering a cell, -1 if the cell is empty
+    int ownerOf(ipair cell) const {return owner[index(cell)];}
+    //Returns true if a food item is on the cell
+    bool hasFood(ipair cell) const {return food_slot[index(cell)] >= 0;}
+
+  private:
+    GameConfig config;
+    int board_rows;
+    int board_columns;
+
+    //Per-snake fields, one entry per snake
+    vector<char> direction;
+    vector<uint8_t> alive;
+    vector<int> score;
+    vector<int> pending_growth;
+    vector<SnakeBody> bodies; //Front is the head
+    vector<ipair> target; //Cell each head moves onto during the current tick
+    vector<uint8_t> dying; //Set for the snakes that die during the current tick
+    size_t alive_count = 0;
+
+    //Per-cell fields, indexed by row * board_columns + column
+    vector<int32_t> owner; //Snake covering the cell, -1 if empty
+    vector<int32_t> food_slot; //Index into food of the item on the cell, -1 if none
+    vector<uint64_t> claim_tick; //Last tick a head moved onto the cell
+    vector<uint32_t> claim_snake; //The snake whose head claimed the cell on that tick
+    FreeCellIndex free_cells; //Every cell inside the border not covered by a snake
+
+    vector<ipair> food; //Position of every food item, {-1, -1} while there is nowhere to put it
+    Random rng;
+    uint64_t tick = 0;
+    MultiStepResult result;
+    uint64_t board_hash = 0; //XOR of the Zobrist keys of every segment, food item and direction
+
+    //Kinds of Zobrist keys, segments take HASH_SEGMENT + their snake
+    static const uint64_t HASH_FOOD = 1;
+    static const uint64_t HASH_DIRECTION = 2;
+    static const uint64_t HASH_SCORE = 3;
+    static const uint64_t HASH_SEGMENT = 4;
+
+    size_t index(ipair cell) const {return size_t(cell.first) * board_columns + cell.second;}
+    uint64_t segmentKey(size_t snake, ipair cell) const {return zobristKey(HASH_SEGMENT + snake, index(cell));}
+    uint64_t foodKey(ipair cell) const {return zobristKey(HASH_FOOD, index(cell));}
+    uint64_t directionKey(size_t snake) const {return zobristKey(HASH_DIRECTION, snake * 256 + uint8_t(direction[snake]));}
+    uint64_t scoreKey(size_t snake) const {return zobristKey(HASH_SCORE, uint64_t(snake) << 32 | uint32_t(score[snake]));}
+
+    //Marks a snake as dying this tick, its body is cleared at the end of the tick
+    void kill(size_t snake)
+    {
+      if (dying[snake]) return;
+      dying[snake] = 1;
+      result.died.push_back(snake);
+    }
+
+    //Places a food item on a random free cell without food, leaves it off the board if every free cell is taken
+    void spawnFood(size_t slot)
+    {
+      food[slot] = {-1, -1};
+      if (free_cells.size() == 0) return;
+      //Only a few free cells hold food, so retrying a handful of times almost always finds one without
+      for (int attempt = 0; attempt < 16; attempt++) {
+        ipair cell = free_cells.at(rng.range(free_cells.size()));
+        if (food_slot[index(cell)] >= 0) continue;
+        food[slot] = cell;
+        food_slot[index(cell)] = int32_t(slot);
+        board_hash ^= foodKey(cell);
+        result.food_spawned.push_back(cell);
+        return;
+      }
+      return;
+    }
+};
+
+/*
+Picks a move for a bot snake: the safe step closest to its food item (snake i goes for food i modulo the food count),
+avoiding cells next to another snake's head when it can, since that head may move there on the same tick
+
+Params: 1 MultiGameState, 1 size_t
+MultiGameState, game: The game, before the tick is run
+size_t, snake: The snake to steer
+
+Returns: The direction to take, 0 to keep going straight (when no step is safe)
+*/
+char multiBotMove(const MultiGameState &game, size_t snake)
+{
+  const ipair head = game.getBody(snake).front();
+  const vector<ipair> &food = game.getFood();
+  const ipair goal = food.empty() ? ipair(-1, -1) : food[snake % food.size()];
+
+  char best = 0;
+  int best_cost = 0;
+  for (char direction:{'w', 'a', 's', 'd'}) {
+    if (isReverseDirection(direction, game.getDirection(snake))) continue;
+    ipair next = stepCell(head, direction);
+    if (next.first <= 0 || next.second <= 0 || next.first >= game.getRows() - 1 || next.second >= game.getColumns() - 1) continue;
+    if (game.ownerOf(next) >= 0) continue;
+
+    //Being next to another head risks a head on collision, that counts as a long detour
+    int cost = goal.first < 0 ? 0 : abs(next.first - goal.first) + abs(next.second - goal.second);
+    for (char around:{'w', 'a', 's', 'd'}) {
+      ipair neighbour = stepCell(next, around);
+      int other = game.ownerOf(neighbour);
+      if (other >= 0 && size_t(other) != snake && game.getBody(other).front() == neighbour) cost += 1000;
+    }
+    if (best == 0 || cost < best_cost) {
+      best = direction;
+      best_cost = cost;
+    }
+  }
+  return best;
+}
+
+#endif
@@ -0,0 +1,691 @@
+/*
+* File: Netplay.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains networked multi-snake games between game
+* processes on the same machine: NetLink is a non-blocking stream socket
+* (a Unix domain socket or TCP on loopback), and LockstepSession keeps a
+* MultiGameState in deterministic lockstep with the other processes by
+* exchanging only the inputs of every tick, predicting the inputs that
+* have not arrived yet and rolling back when a prediction was wrong.
+*/
+
+//Redundancy safety check
+#ifndef NETPLAY_H
+#define NETPLAY_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <functional>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "Board.hpp"
+#include "GameConfig.hpp"
+#include "MultiGame.hpp"
+#include "BinaryFile.hpp"
+
+using namespace std;
+
+//"ASNN" in little-endian, the first bytes the host sends every player
+const uint32_t NET_MAGIC = 0x4E4E5341;
+const uint8_t NET_VERSION = 1;
+//Most players in one networked game, the host included
+const size_t MAX_NET_PLAYERS = 8;
+//Most bot snakes in one networked game, the hello message sends their number in a single byte
+const size_t MAX_NET_BOTS = 255;
+//Most ticks of input delay a host can ask for
+const int MAX_INPUT_DELAY = 10;
+//Most ticks a session runs ahead of the last tick it has every input for, a peer further behind stalls the game
+const uint64_t MAX_ROLLBACK_TICKS = 16;
+//Input code a player sends when leaving the game, its snake goes straight on from then on
+const uint8_t NET_LEFT = 0xFF;
+//Code of a packet carrying a state hash (8 more bytes) instead of an input
+const uint8_t NET_HASH = 0xFE;
+//Confirmed ticks between two state hashes sent to check the players are still in step
+const uint64_t NET_HASH_INTERVAL = 8;
+
+//Turns a direction ('w', 'a', 's', 'd' or 0 to keep going straight) into its input code, 0 for going straight
+uint8_t encodeInput(char direction)
+{
+  const char* keys = "wasd";
+  for (uint8_t i = 0; i < 4; i++) if (keys[i] == direction) return i + 1;
+  return 0;
+}
+
+//Turns an input code back into a direction, 0 for going straight
+char decodeInput(uint8_t code) {return code >= 1 && code <= 4 ? "wasd"[code - 1] : 0;}
+
+//Returns the path of the Unix domain socket an address names, empty for a TCP address (see openNetSocket)
+string netSocketPath(const string &address)
+{
+  if (address.compare(0, 4, "tcp:") == 0) return "";
+  if (!address.empty() && address.find_first_not_of("0123456789") == string::npos) return "";
+  return address.compare(0, 5, "unix:") == 0 ? address.substr(5) : address;
+}
+
+/*
+Opens a stream socket listening on, or connected to, an address on this machine: "tcp:PORT" (or just the port number)
+is TCP on the loopback interface, "unix:PATH" (or any other text) is the path of a Unix domain socket
+
+Params: 1 string, 1 bool
+string, address: The address
+bool, listening: Listen on the address instead of connecting to it, a stale socket file in the way is removed
+
+Returns: The file descriptor of the socket, throws invalid_argument for a malformed address and runtime_error if the
+socket can't be opened
+*/
+int openNetSocket(const string &address, bool listening)
+{
+  string path = netSocketPath(address);
+  bool tcp = path.empty();
+  sockaddr_storage storage;
+  memset(&storage, 0, sizeof(storage));
+  socklen_t length;
+
+  if (tcp) {
+    string port = address.compare(0, 4, "tcp:") == 0 ? address.substr(4) : address;
+    if (port.empty() || port.size() > 5 || port.find_first_not_of("0123456789") != string::npos || stoi(port) == 0 || stoi(port) > 65535) {
+      throw invalid_argument("Not a port number: " + port);
+    }
+    sockaddr_in &in = (sockaddr_in&)storage;
+    in.sin_family = AF_INET;
+    in.sin_port = htons(uint16_t(stoi(port)));
+    in.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    length = sizeof(in);
+  } else {
+    sockaddr_un &un = (sockaddr_un&)storage;
+    if (path.size() >= sizeof(un.sun_path)) throw invalid_argument("Not a usable socket path: " + path);
+    un.sun_family = AF_UNIX;
+    memcpy(un.sun_path, path.c_str(), path.size() + 1);
+    length = sizeof(un);
+  }
+
+  int fd = socket(storage.ss_family, SOCK_STREAM, 0);
+  if (fd < 0) throw runtime_error(string("Could not open a socket: ") + strerror(errno));
+  int error = 0;
+  if (listening) {
+    int yes = 1;
+    if (tcp) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    else unlink(path.c_str());
+    if (::bind(fd, (sockaddr*)&storage, length) < 0 || listen(fd, int(MAX_NET_PLAYERS)) < 0) error = errno;
+  } else if (connect(fd, (sockaddr*)&storage, length) < 0) error = errno;
+
+  if (error) {
+    ::close(fd);
+    throw runtime_error("Could not " + string(listening ? "listen on " : "connect to ") + address + ": " + strerror(error));
+  }
+  return fd;
+}
+
+/*
+NetLink Class:
+  A connected stream socket in non-blocking mode. Bytes to send are queued and written as far as the socket takes them,
+  the rest goes out with the next flush, so sending never waits on the peer. Received bytes pile up in incoming until the
+  owner takes them out.
+*/
+class NetLink
+{
+  public:
+    /*
+    Constructor for NetLink, takes over the socket
+
+    Params: 1 integer
+    int, socket_fd: A connected stream socket
+    */
+    explicit NetLink(int socket_fd) : fd(socket_fd)
+    {
+      fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+      int yes = 1;
+      //Inputs are a couple of bytes each, they go out right away instead of waiting to fill a packet (fails harmlessly on Unix sockets)
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+#ifdef SO_NOSIGPIPE
+      setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof(yes));
+#endif
+    }
+    ~NetLink() {close();}
+    NetLink(const NetLink&) = delete;
+    NetLink& operator=(const NetLink&) = delete;
+
+    //Bytes received and not taken out yet
+    vector<uint8_t> incoming;
+
+    //Queues bytes to send and writes out as many as the socket takes
+    void send(const uint8_t* data, size_t size)
+    {
+      if (fd < 0) return;
+      outgoing.insert(outgoing.end(), data, data + size);
+      flush();
+      return;
+    }
+
+    //Writes out as many queued bytes as the socket takes, returns false once the link is broken
+    bool flush()
+    {
+      size_t done = 0;
+      while (fd >= 0 && done < outgoing.size()) {
+        ssize_t n = ::send(fd, outgoing.data() + done, outgoing.size() - done, sendFlags());
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n <= 0) {
+          drop();
+          return false;
+        }
+        done += n;
+        bytes_sent += n;
+      }
+      outgoing.erase(outgoing.begin(), outgoing.begin() + done);
+      return fd >= 0;
+    }
+
+    //Reads every byte waiting on the socket into incoming, returns false once the peer closed the link or it broke
+    bool receive()
+    {
+      uint8_t buffer[4096];
+      while (fd >= 0) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n <= 0) {
+          drop();
+          break;
+        }
+        incoming.insert(incoming.end(), buffer, buffer + n);
+        bytes_received += n;
+      }
+      return fd >= 0;
+    }
+
+    //Gives the queued bytes up to a second to go out, then closes the socket
+    void close()
+    {
+      if (fd < 0) return;
+      if (!outgoing.empty()) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+        struct timeval timeout = {1, 0};
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        ::send(fd, outgoing.data(), outgoing.size(), sendFlags());
+      }
+      drop();
+      return;
+    }
+
+    bool isOpen() const {return fd >= 0;}
+    int getFd() const {return fd;}
+    uint64_t getBytesSent() const {return bytes_sent;}
+    uint64_t getBytesReceived() const {return bytes_received;}
+
+  private:
+    int fd;
+    vector<uint8_t> outgoing;
+    uint64_t bytes_sent = 0;
+    uint64_t bytes_received = 0;
+
+    //Closes the socket right away, whatever is still queued is lost
+    void drop()
+    {
+      ::close(fd);
+      fd = -1;
+      outgoing.clear();
+      return;
+    }
+
+    //A peer that hung up makes send fail instead of raising SIGPIPE
+    static int sendFlags()
+    {
+#ifdef MSG_NOSIGNAL
+      return MSG_NOSIGNAL;
+#else
+      return 0;
+#endif
+    }
+};
+
+/*
+LockstepSession Class:
+  One process's side of a networked multi-snake game. Every process runs the same MultiGameState from the same config and
+  seed, and only the players' inputs go over the wire: each tick every player sends one input, two bytes (the player and
+  the input code), which the host relays to everyone else. Bot snakes are steered by multiBotMove inside the simulation,
+  so every process agrees on them without sending anything.
+
+  The local player's input is scheduled input_delay ticks ahead, which gives it that long to reach the other players
+  before they need it. The session keeps two states: confirmed, run up to the first tick some input is still missing for,
+  and current, the one shown, which runs ahead of it predicting that every missing input is "go straight". When an input
+  arrives that differs from what was predicted for a tick current has already run, current is rolled back to confirmed
+  and run forward again with everything known, so the local player never waits for the others. Only when current gets
+  MAX_ROLLBACK_TICKS ahead of confirmed does the game stall until the slowest player catches up.
+
+  Every NET_HASH_INTERVAL confirmed ticks the host sends everyone the state hash of its confirmed game, and every player
+  sends theirs to the host, so a game that went out of step is noticed within a few ticks and the session ends there
+  instead of playing on with different boards.
+
+  The host (player 0) listens for the others and sends each of them the config, their player number, the number of
+  players and bots and the input delay. A player that leaves (or whose connection drops) sends NET_LEFT, its snake goes
+  straight on from the tick after its last input, everyone agrees on that tick since the stream keeps the order.
+*/
+class LockstepSession
+{
+  public:
+    /*
+    Constructor for LockstepSession, a session without any connections yet
+
+    Params: 1 GameConfig, 3 size_t, 1 integer
+    GameConfig, game_config: The board size, speed and seed of the game, the same for every player
+    size_t, players: Number of players, the first snakes
+    size_t, bots: Number of bot snakes after the players
+    size_t, local: The snake of this process
+    int, delay: Ticks of input delay
+
+    Throws invalid_argument if the board is too small for the snakes
+    */
+    LockstepSession(const GameConfig& game_config, size_t players, size_t bots, size_t local, int delay) :
+     confirmed(game_config, players + bots), current(confirmed), player_count(players), local_player(local),
+     input_delay(delay), pending(players), left(players, 0), inputs(players + bots, 0) {};
+
+    /*
+    Hosts a game: listens on the address until players - 1 other processes have joined, then starts the game
+
+    Params: 2 string, 1 GameConfig, 2 size_t, 1 integer, 1 function
+    string, address: Where to listen (see openNetSocket)
+    GameConfig, game_config: The config of the game
+    size_t, players: Number of players, the host included
+    size_t, bots: Number of bot snakes
+    int, delay: Ticks of input delay
+    function, cancelled: Checked while waiting, the host gives up once it returns true
+
+    Returns: The session, nullptr if it was cancelled. Throws invalid_argument for bad settings and runtime_error if the
+    socket can't be opened
+    */
+    static unique_ptr<LockstepSession> host(const string &address, const GameConfig &game_config, size_t players, size_t bots, int delay, const function<bool()> &cancelled)
+    {
+      if (players < 2 || players > MAX_NET_PLAYERS) throw invalid_argument("A networked game takes 2 to " + to_string(MAX_NET_PLAYERS) + " players");
+      if (delay < 0 || delay > MAX_INPUT_DELAY) throw invalid_argument("The input delay can be at most " + to_string(MAX_INPUT_DELAY) + " ticks");
+      if (bots > MAX_NET_BOTS) throw invalid_argument("A networked game takes at most " + to_string(MAX_NET_BOTS) + " bots");
+      unique_ptr<LockstepSession> session(new LockstepSession(game_config, players, bots, 0, delay));
+      session->hosting = true;
+
+      int listener = openNetSocket(address, true);
+      while (session->links.size() + 1 < players) {
+        struct pollfd fds[1] = {{listener, POLLIN, 0}};
+        if (cancelled()) break;
+        if (::poll(fds, 1, 100) <= 0) continue;
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) continue;
+        session->links.emplace_back(new NetLink(fd));
+        session->link_player.push_back(session->links.size());
+      }
+      ::close(listener);
+      if (!netSocketPath(address).empty()) unlink(netSocketPath(address).c_str());
+      if (session->links.size() + 1 < players) return nullptr;
+
+      //Everyone starts on receiving this, the host right after sending it
+      for (size_t i = 0; i < session->links.size(); i++) {
+        ByteWriter hello;
+        hello.put32(NET_MAGIC);
+        hello.put8(NET_VERSION);
+        hello.put8(uint8_t(session->link_player[i]));
+        hello.put8(uint8_t(players));
+        hello.put8(uint8_t(bots));
+        hello.put8(uint8_t(delay));
+        writeConfig(hello, game_config);
+        uint8_t size[2] = {uint8_t(hello.bytes.size() & 0xFF), uint8_t(hello.bytes.size() >> 8)};
+        session->links[i]->send(size, 2);
+        session->links[i]->send(hello.bytes.data(), hello.bytes.size());
+      }
+      session->start();
+      return session;
+    }
+
+    /*
+    Joins a game hosted on the address and waits for the host to start it
+
+    Params: 1 string, 1 function
+    string, address: Where the host listens (see openNetSocket)
+    function, cancelled: Checked while waiting, the player gives up once it returns true
+
+    Returns: The session, nullptr if it was cancelled. Throws runtime_error if the host can't be reached, hangs up or
+    speaks another version
+    */
+    static unique_ptr<LockstepSession> join(const string &address, const function<bool()> &cancelled)
+    {
+      unique_ptr<NetLink> link(new NetLink(openNetSocket(address, false)));
+      vector<uint8_t> &in = link->incoming;
+      while (in.size() < 2 || in.size() < 2 + size_t(in[0] | (in[1] << 8))) {
+        if (cancelled()) return nullptr;
+        struct pollfd fds[1] = {{link->getFd(), POLLIN, 0}};
+        ::poll(fds, 1, 100);
+        if (!link->receive()) throw runtime_error("The host hung up before the game started");
+      }
+
+      size_t size = in[0] | (in[1] << 8);
+      unique_ptr<LockstepSession> session;
+      try {
+        ByteReader hello(in.data() + 2, size);
+        if (hello.get32() != NET_MAGIC) throw runtime_error("The host is not running a snake game");
+        if (hello.get8() != NET_VERSION) throw runtime_error("The host runs another version of the game");
+        size_t local = hello.get8();
+        size_t players = hello.get8();
+        size_t bots = hello.get8();
+        int delay = hello.get8();
+        GameConfig game_config = readConfig(hello);
+        if (players < 2 || players > MAX_NET_PLAYERS || local == 0 || local >= players || delay > MAX_INPUT_DELAY) {
+          throw runtime_error("The host sent a malformed game");
+        }
+        session.reset(new LockstepSession(game_config, players, bots, local, delay));
+      } catch (const out_of_range &e) {
+        throw runtime_error("The host sent a malformed game");
+      } catch (const invalid_argument &e) {
+        throw runtime_error(string("The host sent a game that can't be played: ") + e.what());
+      }
+      //Inputs the host sent right after the hello stay queued for poll
+      in.erase(in.begin(), in.begin() + 2 + size);
+      session->links.push_back(move(link));
+      session->link_player.push_back(0);
+      session->start();
+      return session;
+    }
+
+    /*
+    Returns true while current may run another tick, false once it is MAX_ROLLBACK_TICKS ahead of confirmed or the game is over
+
+    Params: None
+
+    Returns: Whether advance may be called
+    */
+    bool canAdvance() const {return !isOver() && current_tick < confirmed_tick + MAX_ROLLBACK_TICKS;}
+
+    /*
+    Runs current one tick forward and sends the local player's input for the tick input_delay ticks later
+
+    Params: 1 char
+    char, input: The local player's new direction ('w', 'a', 's', 'd', 0 keeps going straight)
+
+    Returns: What changed during the tick, valid until the next call
+    */
+    const MultiStepResult& advance(char input)
+    {
+      sendLocal(encodeInput(input));
+      const MultiStepResult &result = stepState(current, current_tick);
+      current_tick++;
+      return result;
+    }
+
+    /*
+    Reads every input that arrived (the host relays them to the other players), runs confirmed up to the first tick an
+    input is missing for and rolls current back if any of the inputs differ from what it predicted
+
+    Params: None
+
+    Returns: True if current was rolled back and has to be drawn again from scratch
+    */
+    bool poll()
+    {
+      for (size_t i = 0; i < links.size(); i++) {
+        NetLink &link = *links[i];
+        if (!link.isOpen()) continue;
+        bool open = link.receive();
+        size_t used = 0;
+        while (used + 2 <= link.incoming.size()) {
+          size_t player = link.incoming[used];
+          uint8_t code = link.incoming[used + 1];
+          //A player only speaks for itself, the host for anyone
+          if (player >= player_count || player == local_player || (hosting && player != link_player[i])) {
+            link.close();
+            open = false;
+            break;
+          }
+          if (code == NET_HASH) {
+            if (used + 10 > link.incoming.size()) break;
+            ByteReader hash(link.incoming.data() + used + 2, 8);
+            peer_hashes[i].push_back(hash.get64());
+            used += 10;
+            continue;
+          }
+          receive(player, code);
+          if (hosting) relay(i, player, code);
+          used += 2;
+        }
+        if (link.isOpen()) link.incoming.erase(link.incoming.begin(), link.incoming.begin() + used);
+        if (!open) {
+          //The host takes a dropped player out of the game, a player can't go on without the host
+          if (!hosting) {
+            connected = false;
+            lost_host = true;
+          } else if (!left[link_player[i]]) {
+            receive(link_player[i], NET_LEFT);
+            relay(i, link_player[i], NET_LEFT);
+          }
+        }
+      }
+      for (auto &link:links) link->flush();
+
+      //Confirm every tick current has run that all inputs are known for, stopping where the game ends so everyone ends on the same tick
+      while (confirmed_tick < current_tick && inputsKnown() && !isFinished()) {
+        stepState(confirmed, confirmed_tick);
+        for (size_t p = 0; p < player_count; p++) if (!pending[p].empty()) pending[p].popFront();
+        confirmed_tick++;
+        if (confirmed_tick % NET_HASH_INTERVAL == 0) sendHash(confirmed.getStateHash());
+      }
+      for (size_t i = 0; i < links.size(); i++) {
+        for (; hashes_checked[i] < hashes.size() && hashes_checked[i] < peer_hashes[i].size(); hashes_checked[i]++) {
+          if (hashes[hashes_checked[i]] != peer_hashes[i][hashes_checked[i]] && !desync_tick) desync_tick = (hashes_checked[i] + 1) * NET_HASH_INTERVAL;
+        }
+      }
+
+      if (!mispredicted) return false;
+      mispredicted = false;
+      rollbacks++;
+      current = confirmed;
+      for (uint64_t tick = confirmed_tick; tick < current_tick; tick++) stepState(current, tick);
+      return true;
+    }
+
+    /*
+    Waits until an input arrives or the time runs out
+
+    Params: 1 integer
+    int, milliseconds: Longest time to wait
+
+    Returns: Void
+    */
+    void wait(int milliseconds) const
+    {
+      vector<struct pollfd> fds;
+      for (const auto &link:links) if (link->isOpen()) fds.push_back({link->getFd(), POLLIN, 0});
+      if (fds.empty()) usleep(milliseconds * 1000);
+      else ::poll(fds.data(), fds.size(), milliseconds);
+      return;
+    }
+
+    /*
+    Leaves the game: tells the others the local snake goes straight on from here and closes the connections
+
+    Params: None
+
+    Returns: Void
+    */
+    void leave()
+    {
+      if (!connected) return;
+      uint8_t packet[2] = {uint8_t(local_player), NET_LEFT};
+      for (auto &link:links) {
+        link->send(packet, 2);
+        link->close();
+      }
+      connected = false;
+      return;
+    }
+
+    /*
+    How many ticks current is ahead of the slowest other player, estimated from the inputs received so far. A player
+    that keeps up has sent its inputs up to input_delay ticks past its own tick, so the lead stays around 0, a process
+    with a lead can slow down to let the others catch up.
+
+    Params: None
+
+    Returns: The lead in ticks, negative when this process is the one behind
+    */
+    int64_t getLead() const
+    {
+      int64_t lead = INT64_MIN;
+      for (size_t p = 0; p < player_count; p++) {
+        if (p == local_player || left[p]) continue;
+        int64_t their_tick = int64_t(confirmed_tick + pending[p].size()) - input_delay;
+        lead = max(lead, int64_t(current_tick) - their_tick);
+      }
+      return lead == INT64_MIN ? 0 : lead;
+    }
+
+    /*
+    Returns true once the confirmed game is over or every player's snake is out
+
+    Params: None
+
+    Returns: Whether the game was played to the end
+    */
+    bool isFinished() const
+    {
+      if (confirmed.isOver()) return true;
+      for (size_t p = 0; p < player_count; p++) if (confirmed.isAlive(p)) return false;
+      return true;
+    }
+
+    /*
+    Returns true once the game is finished, went out of step with another player, or the connections are closed and the
+    inputs received before that have all been confirmed. A host that finishes first and hangs up has already sent every
+    input the others need to finish.
+
+    Params: None
+
+    Returns: Whether the session is over
+    */
+    bool isOver() const {return isFinished() || desync_tick || (!connected && !inputsKnown());}
+
+    /*
+    Get respective private values (in function name)
+
+    Params: None
+
+    Returns: The respective value
+    */
+    const MultiGameState& getState() const {return current;}
+    const MultiGameState& getConfirmedState() const {return confirmed;}
+    const GameConfig& getConfig() const {return confirmed.getConfig();}
+    size_t getPlayerCount() const {return player_count;}
+    size_t getLocalPlayer() const {return local_player;}
+    int getInputDelay() const {return input_delay;}
+    uint64_t getTick() const {return current_tick;}
+    uint64_t getConfirmedTick() const {return confirmed_tick;}
+    uint64_t getRollbacks() const {return rollbacks;}
+    bool hasLostHost() const {return lost_host;}
+    //The confirmed tick whose state hash differed from another player's, 0 while every hash matched
+    uint64_t getDesyncTick() const {return desync_tick;}
+    uint64_t getBytesSent() const {uint64_t n = 0; for (const auto &link:links) n += link->getBytesSent(); return n;}
+    uint64_t getBytesReceived() const {uint64_t n = 0; for (const auto &link:links) n += link->getBytesReceived(); return n;}
+
+  private:
+    MultiGameState confirmed; //Run up to confirmed_tick with every input known
+    MultiGameState current; //Run up to current_tick, missing inputs predicted
+    uint64_t confirmed_tick = 0;
+    uint64_t current_tick = 0;
+    size_t player_count;
+    size_t local_player;
+    int input_delay;
+
+    vector<RingBuffer<uint8_t>> pending; //Input codes of every player from confirmed_tick on
+    vector<uint8_t> left; //Set for the players that left, their inputs past the pending ones are 0
+    vector<char> inputs; //Inputs of every snake for the tick being run
+    bool mispredicted = false; //An input arrived that current predicted wrong
+
+    bool hosting = false;
+    bool connected = true;
+    bool lost_host = false; //The host hung up
+    vector<unique_ptr<NetLink>> links; //The other players for the host, the host for a player
+    vector<size_t> link_player; //Player at the other end of each link
+    vector<uint64_t> hashes; //State hash of confirmed after every NET_HASH_INTERVAL ticks
+    vector<vector<uint64_t>> peer_hashes; //The hashes received over each link
+    vector<size_t> hashes_checked; //Hashes of each link compared so far
+    uint64_t desync_tick = 0;
+    uint64_t rollbacks = 0;
+
+    //Queues the local inputs of the first input_delay ticks, which have passed before anyone could press a key
+    void start()
+    {
+      peer_hashes.resize(links.size());
+      hashes_checked.resize(links.size(), 0);
+      for (int i = 0; i < input_delay; i++) sendLocal(0);
+      return;
+    }
+
+    //Queues an input code of the local player for the next tick without one and sends it to the others
+    void sendLocal(uint8_t code)
+    {
+      pending[local_player].pushBack(code);
+      uint8_t packet[2] = {uint8_t(local_player), code};
+      for (auto &link:links) link->send(packet, 2);
+      return;
+    }
+
+    //Keeps a state hash of confirmed and sends it to the host, or to every player from the host
+    void sendHash(uint64_t hash)
+    {
+      hashes.push_back(hash);
+      ByteWriter packet;
+      packet.put8(uint8_t(local_player));
+      packet.put8(NET_HASH);
+      packet.put64(hash);
+      for (auto &link:links) link->send(packet.bytes.data(), packet.bytes.size());
+      return;
+    }
+
+    //Sends an input of a player to every other player but the one it came from
+    void relay(size_t from, size_t player, uint8_t code)
+    {
+      uint8_t packet[2] = {uint8_t(player), code};
+      for (size_t i = 0; i < links.size(); i++) if (i != from && links[i]->isOpen()) links[i]->send(packet, 2);
+      return;
+    }
+
+    //Queues an input code of another player for the next tick without one
+    void receive(size_t player, uint8_t code)
+    {
+      if (left[player]) return;
+      if (code == NET_LEFT) {
+        left[player] = 1;
+        return;
+      }
+      //current went straight on for every tick it had no input for
+      if (confirmed_tick + pending[player].size() < current_tick && code != 0) mispredicted = true;
+      pending[player].pushBack(code);
+      return;
+    }
+
+    //Returns true if every player's input for confirmed_tick is known
+    bool inputsKnown() const
+    {
+      for (size_t p = 0; p < player_count; p++) if (pending[p].empty() && !left[p]) return false;
+      return true;
+    }
+
+    //Runs a state one tick forward with the inputs known for the tick, going straight for the missing ones
+    const MultiStepResult& stepState(MultiGameState &state, uint64_t tick)
+    {
+      size_t offset = tick - confirmed_tick;
+      for (size_t p = 0; p < player_count; p++) inputs[p] = offset < pending[p].size() ? decodeInput(pending[p][offset]) : 0;
+      for (size_t i = player_count; i < inputs.size(); i++) inputs[i] = state.isAlive(i) ? multiBotMove(state, i) : 0;
+      return state.step(inputs.data());
+    }
+};
+
+#endif
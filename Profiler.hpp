@@ -0,0 +1,249 @@
+/*
+* File: Profiler.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the frame profiler: how long every phase of a
+* game's ticks and frames takes (reading input, the phases of a step,
+* composing, encoding and writing a frame) and how many bytes every frame
+* prints. Samples go into fixed size log-linear histograms of atomic
+* counters, in the manner of HDR histograms, so recording one is a bit scan
+* and a relaxed increment, never a lock or an allocation, and percentiles
+* can be read at any moment.
+*/
+
+//Redundancy safety check
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include "Engine.hpp"
+
+using namespace std;
+
+/*
+The LatencyHistogram class counts samples (nanoseconds, bytes, any unsigned value) into buckets that are exact below
+2*SUB_BUCKETS and then split every power of two into SUB_BUCKETS equal parts, so every value is known to within about 6%
+from 0 up to 2^(MAX_SHIFT+SUB_BITS+1) and the whole histogram is a few kilobytes that never grow. Every counter is
+atomic and only ever increased with relaxed operations, so one thread can record while another reads percentiles.
+*/
+class LatencyHistogram
+{
+  public:
+    static const int SUB_BITS = 4;
+    static const int SUB_BUCKETS = 1 << SUB_BITS;
+    static const int MAX_SHIFT = 40; //Larger values all land in the last bucket
+    static const int BUCKETS = (MAX_SHIFT + 2) * SUB_BUCKETS;
+
+    LatencyHistogram() {reset();}
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /*
+    Counts a sample
+
+    Params: 1 uint64_t
+    uint64_t, value: The sample
+
+    Returns: Void
+    */
+    void record(uint64_t value)
+    {
+      counts[bucketOf(value)].fetch_add(1, memory_order_relaxed);
+      total.fetch_add(1, memory_order_relaxed);
+      sum.fetch_add(value, memory_order_relaxed);
+      uint64_t seen = maximum.load(memory_order_relaxed);
+      while (value > seen && !maximum.compare_exchange_weak(seen, value, memory_order_relaxed)) {}
+      return;
+    }
+
+    /*
+    Returns the value a percentage of the samples are at or below, rounded up to the top of its bucket (and never above
+    the largest sample)
+
+    Params: 1 double
+    double, percent: 0 to 100
+
+    Returns: The percentile, 0 if nothing was recorded
+    */
+    uint64_t percentile(double percent) const
+    {
+      uint64_t n = count();
+      if (n == 0) return 0;
+      uint64_t rank = uint64_t(ceil(percent / 100.0 * double(n)));
+      if (rank < 1) rank = 1;
+      if (rank > n) rank = n;
+
+      uint64_t seen = 0;
+      for (int i = 0; i < BUCKETS; i++) {
+        seen += counts[i].load(memory_order_relaxed);
+        if (seen >= rank) return min(highestInBucket(i), getMax());
+      }
+      return getMax();
+    }
+
+    //Returns the number of samples, their largest value and their mean
+    uint64_t count() const {return total.load(memory_order_relaxed);}
+    uint64_t getMax() const {return maximum.load(memory_order_relaxed);}
+    double mean() const {return count() ? double(sum.load(memory_order_relaxed)) / double(count()) : 0.0;}
+
+    //Forgets every sample
+    void reset()
+    {
+      for (atomic<uint64_t> &bucket:counts) bucket.store(0, memory_order_relaxed);
+      total.store(0, memory_order_relaxed);
+      sum.store(0, memory_order_relaxed);
+      maximum.store(0, memory_order_relaxed);
+      return;
+    }
+
+  private:
+    atomic<uint64_t> counts[BUCKETS];
+    atomic<uint64_t> total;
+    atomic<uint64_t> sum;
+    atomic<uint64_t> maximum;
+
+    //Bucket of a value: its top SUB_BITS+1 bits, offset by how far it had to be shifted down
+    static int bucketOf(uint64_t value)
+    {
+      if (value < 2 * SUB_BUCKETS) return int(value);
+      int shift = 64 - __builtin_clzll(value) - (SUB_BITS + 1);
+      if (shift > MAX_SHIFT) return BUCKETS - 1;
+      return shift * SUB_BUCKETS + int(value >> shift);
+    }
+
+    //Largest value that falls into a bucket
+    static uint64_t highestInBucket(int bucket)
+    {
+      if (bucket < 2 * SUB_BUCKETS) return uint64_t(bucket);
+      int shift = bucket / SUB_BUCKETS - 1;
+      return (uint64_t(bucket - shift * SUB_BUCKETS + 1) << shift) - 1;
+    }
+};
+
+//Phases of a game that are timed, the step phases in the order of StepPhase
+enum FramePhase
+{
+  PHASE_INPUT, //Reading the keyboard, applying recorded inputs or letting the autopilot decide
+  PHASE_MOVE,
+  PHASE_SPAWN,
+  PHASE_COLLISION,
+  PHASE_COMPOSE, //Setting the changed cells on the display grid
+  PHASE_ENCODE, //Turning the changed cells into escape codes
+  PHASE_WRITE, //Printing them to console
+  FRAME_PHASES
+};
+static_assert(PHASE_MOVE + STEP_COLLISION == PHASE_COLLISION, "The step phases are timed in the order of StepPhase");
+
+const string FRAME_PHASE_NAMES[FRAME_PHASES] = {"input", "move", "spawn", "collision", "compose", "encode", "write"};
+
+/*
+The FrameProfiler class times the phases of a game on the monotonic clock and keeps a histogram of each. A phase is
+timed from begin() (or the end of the phase before it) to endPhase(), and doubles as the probe of GameState::step, so
+the step phases are timed by the engine's own calls to phaseDone. The time of every phase since the last printed frame
+adds up to the work that frame cost, which frameDone() records along with the bytes the frame printed.
+*/
+class FrameProfiler
+{
+  public:
+    //Starts timing the next phase
+    void begin() {lap_start = now();}
+
+    /*
+    Ends the phase being timed and starts timing the next one
+
+    Params: 1 FramePhase, 1 bool
+    FramePhase, phase: The phase that just ended
+    bool, counts_to_frame: False for work done whether or not anything is drawn (polling the keyboard between frames), which
+                           is timed but not counted towards the cost of the next frame
+
+    Returns: Void
+    */
+    void endPhase(FramePhase phase, bool counts_to_frame=true)
+    {
+      uint64_t time = now();
+      uint64_t spent = time - lap_start;
+      phases[phase].record(spent);
+      if (counts_to_frame) frame_work += spent;
+      lap_start = time;
+      return;
+    }
+
+    //Probe interface of GameState::step
+    void phaseDone(StepPhase phase) {endPhase(FramePhase(PHASE_MOVE + phase));}
+
+    /*
+    Records a frame that was printed, frames that had nothing to print aren't counted (their work goes to the next one)
+
+    Params: 1 size_t
+    size_t, bytes: The bytes the frame printed
+
+    Returns: Void
+    */
+    void frameDone(size_t bytes)
+    {
+      if (bytes == 0) return;
+      frame_times.record(frame_work);
+      frame_bytes.record(bytes);
+      frame_work = 0;
+      return;
+    }
+
+    //Returns the histogram of a phase (nanoseconds), of the work per frame (nanoseconds) and of the bytes per frame
+    const LatencyHistogram& getPhase(FramePhase phase) const {return phases[phase];}
+    const LatencyHistogram& getFrameTimes() const {return frame_times;}
+    const LatencyHistogram& getFrameBytes() const {return frame_bytes;}
+
+    /*
+    Prints a table of every histogram that has samples: count, mean, median, 99th percentile and maximum, times in
+    microseconds
+
+    Params: 1 ostream reference
+    ostream, out: Where to print
+
+    Returns: Void
+    */
+    void printSummary(ostream &out) const
+    {
+      out << "Frame profile (times in microseconds)" << endl
+          << left << setw(12) << "phase" << right << setw(10) << "count" << setw(10) << "mean"
+          << setw(10) << "p50" << setw(10) << "p99" << setw(10) << "max" << endl;
+      for (int p = 0; p < FRAME_PHASES; p++) printRow(out, FRAME_PHASE_NAMES[p], phases[p], 1000.0);
+      printRow(out, "frame", frame_times, 1000.0);
+      printRow(out, "bytes/frame", frame_bytes, 1.0);
+      out << defaultfloat;
+      return;
+    }
+
+  private:
+    LatencyHistogram phases[FRAME_PHASES];
+    LatencyHistogram frame_times;
+    LatencyHistogram frame_bytes;
+    uint64_t lap_start = 0;
+    uint64_t frame_work = 0; //Time of the phases since the last printed frame
+
+    //Prints one row of the summary, values divided by scale
+    static void printRow(ostream &out, const string &name, const LatencyHistogram &histogram, double scale)
+    {
+      if (histogram.count() == 0) return;
+      out << left << setw(12) << name << right << setw(10) << histogram.count() << fixed << setprecision(2)
+          << setw(10) << histogram.mean() / scale << setw(10) << double(histogram.percentile(50)) / scale
+          << setw(10) << double(histogram.percentile(99)) / scale << setw(10) << double(histogram.getMax()) / scale << endl;
+      return;
+    }
+
+    //Current reading of the monotonic clock in nanoseconds
+    static uint64_t now()
+    {
+      using namespace std::chrono;
+      return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+#endif
@@ -0,0 +1,178 @@
+/*
+* File: Random.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the random number generator used by the game.
+* Every game owns its own generator, so a game can be reproduced exactly
+* from its seed and any number of games can run side by side without
+* sharing hidden global state the way rand()/srand() do.
+*/
+
+//Redundancy safety check
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <ctime>
+#include <chrono>
+#include <random>
+
+/*
+Random Class:
+  A xoshiro256** generator: 32 bytes of state, a handful of shifts/rotates per number and a period of 2^256-1.
+  The seed is expanded into the state with splitmix64, so any 64 bit seed (including 0) gives a well mixed state.
+*/
+class Random
+{
+  public:
+    /*
+    Constructor for Random
+
+    Params: 1 uint64_t
+    uint64_t, seed: The seed, equal seeds always produce the same sequence
+    */
+    Random(uint64_t seed=0)
+    {
+      reseed(seed);
+    }
+
+    /*
+    Resets the generator to the start of the sequence for a seed
+
+    Params: 1 uint64_t
+    uint64_t, seed: The new seed
+
+    Returns: Void
+    */
+    void reseed(uint64_t seed)
+    {
+      for (int i = 0; i < 4; i++) state[i] = splitMix(seed);
+      return;
+    }
+
+    /*
+    Returns the next 64 random bits
+
+    Params: None
+
+    Returns: A uniformly distributed 64 bit value
+    */
+    uint64_t next()
+    {
+      uint64_t result = rotate(state[1] * 5, 7) * 9;
+      uint64_t t = state[1] << 17;
+
+      state[2] ^= state[0];
+      state[3] ^= state[1];
+      state[1] ^= state[2];
+      state[0] ^= state[3];
+      state[2] ^= t;
+      state[3] = rotate(state[3], 45);
+
+      return result;
+    }
+
+    /*
+    Returns a uniformly distributed number in [0, bound) without modulo bias. Uses a widening multiply
+    to map 32 random bits into the range, and only redraws in the rare case the draw lands in the biased remainder.
+
+    Params: 1 uint32_t
+    uint32_t, bound: The exclusive upper limit, must be greater than 0
+
+    Returns: A number from 0 to bound-1
+    */
+    uint32_t range(uint32_t bound)
+    {
+      uint64_t product = uint64_t(uint32_t(next() >> 32)) * bound;
+      uint32_t low = uint32_t(product);
+      if (low < bound) {
+        //Values below this threshold would make some results more likely than others
+        uint32_t threshold = uint32_t(-bound) % bound;
+        while (low < threshold) {
+          product = uint64_t(uint32_t(next() >> 32)) * bound;
+          low = uint32_t(product);
+        }
+      }
+      return product >> 32;
+    }
+
+    //Raw generator state, used when a game is saved or restored
+    const uint64_t* getState() const {return state;}
+    void setState(const uint64_t to_set[4]) {for (int i = 0; i < 4; i++) state[i] = to_set[i];}
+
+  private:
+    uint64_t state[4];
+
+    static uint64_t rotate(uint64_t x, int k) {return (x << k) | (x >> (64 - k));}
+
+    //Advances a splitmix64 sequence, used only to expand a seed into the full state
+    static uint64_t splitMix(uint64_t& x)
+    {
+      uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      return z ^ (z >> 31);
+    }
+};
+
+/*
+Returns a fresh seed for games started without one
+
+Params: None
+
+Returns: A seed mixed from the system entropy source and the monotonic clock
+*/
+uint64_t randomSeed()
+{
+  std::random_device device;
+  uint64_t seed = (uint64_t(device()) << 32) | device();
+  return seed ^ uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+/*
+Returns the seed of today's daily challenge, the same for everyone playing on the same (local) date
+
+Params: None
+
+Returns: The date written as YYYYMMDD, which Random mixes into a full state
+*/
+uint64_t dailyChallengeSeed()
+{
+  time_t now = time(NULL);
+  struct tm* date = localtime(&now);
+  return uint64_t(date->tm_year + 1900) * 10000 + (date->tm_mon + 1) * 100 + date->tm_mday;
+}
+
+/*
+Returns the Zobrist key of a feature of a game state (a segment on a cell, an item of some type on a cell, ...): a fixed
+pseudo-random 64 bit value, the same on every run and machine. A state hash is the XOR of the keys of everything in the
+state, so putting a thing on the board or taking it off updates the hash with a single XOR. The keys are worked out
+with the splitmix64 finalizer instead of being looked up in a table, so boards of any size need no memory for them.
+
+Params: 2 uint64_t
+uint64_t, kind: What the feature is, one of the kinds the caller defines
+uint64_t, value: Where or which (e.g. the index of a cell)
+
+Returns: The key
+*/
+uint64_t zobristKey(uint64_t kind, uint64_t value)
+{
+  uint64_t z = (value ^ (kind << 40)) * 0x9E3779B97F4A7C15ull + kind;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+/*
+Folds a value into a hash, for the few plain numbers (score, tick, ...) that are mixed in when a state hash is read
+
+Params: 2 uint64_t
+uint64_t, hash: The hash so far
+uint64_t, value: The value to fold in
+
+Returns: The new hash
+*/
+uint64_t mixHash(uint64_t hash, uint64_t value) {return zobristKey(hash >> 40, hash ^ (value * 0xD6E8FEB86659FD93ull));}
+
+#endif
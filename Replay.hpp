@@ -0,0 +1,325 @@
+/*
+* File: Replay.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the replay log: the config a game was started
+* with plus every input it received, indexed by simulation tick. Since the
+* simulation is deterministic for a given config, re-simulating the log
+* reproduces the game exactly, which the state hashes recorded along the
+* way confirm every REPLAY_HASH_INTERVAL ticks. A replay can also be
+* streamed, its inputs decoded one at a time as the game reaches them.
+*/
+
+//Redundancy safety check
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "BinaryFile.hpp"
+#include "GameConfig.hpp"
+
+using namespace std;
+
+//Types of inputs recorded in a replay
+enum ReplayEventType
+{
+  REPLAY_DIRECTION, //The snake's direction changed before the tick
+  REPLAY_PAUSE, //The pause menu was opened before the tick
+  REPLAY_RESUME, //The pause menu was closed with RESUME
+  REPLAY_QUIT //The game was quit from the pause menu before the tick
+};
+
+/*
+The ReplayEvent struct is a single recorded input
+*/
+struct ReplayEvent
+{
+  uint64_t tick; //The tick the input applies to (it takes effect before that tick's move)
+  uint8_t type; //One of ReplayEventType
+  char direction; //The new direction ('w', 'a', 's', 'd') for REPLAY_DIRECTION events
+};
+
+//Replay file layout constants
+const string REPLAY_MAGIC = "ASNR";
+const uint8_t REPLAY_VERSION = 5; //Version 2 added the item settings to the config, version 3 the level, version 4 the state hashes, version 5 changed where items spawn
+//Directions are stored as their index in this string
+const string REPLAY_DIRECTIONS = "wasd";
+//Ticks between two recorded state hashes, a quarter of a byte per tick
+const uint64_t REPLAY_HASH_INTERVAL = 32;
+
+/*
+The ReplayLog struct holds everything needed to re-simulate a game, and the outcome it had
+*/
+struct ReplayLog
+{
+  GameConfig config;
+  vector<ReplayEvent> events;
+  uint64_t ticks = 0; //Number of ticks simulated before the game ended
+  int score = 0;
+  bool won = false;
+  vector<uint64_t> hashes; //State hash after every REPLAY_HASH_INTERVAL ticks, hashes[i] after tick (i + 1) * REPLAY_HASH_INTERVAL
+  uint64_t final_hash = 0; //State hash once the game ended
+
+  //Appends an input to the log, inputs must be added in tick order
+  void addEvent(uint64_t tick, uint8_t type, char direction=0)
+  {
+    events.push_back({tick, type, direction});
+    return;
+  }
+
+  //Returns true if two logs describe the same inputs and the same outcome
+  bool sameOutcome(const ReplayLog& other) const
+  {
+    if (ticks != other.ticks || score != other.score || won != other.won || events.size() != other.events.size()) return false;
+    for (size_t i = 0; i < events.size(); i++) {
+      if (events[i].tick != other.events[i].tick || events[i].type != other.events[i].type || events[i].direction != other.events[i].direction) return false;
+    }
+    return hashes == other.hashes && final_hash == other.final_hash;
+  }
+
+  //Returns the tick of the first state hash that differs between two logs of the same game, ticks if only the final hash differs
+  //and 0 if they agree all the way
+  uint64_t firstDivergence(const ReplayLog& other) const
+  {
+    for (size_t i = 0; i < hashes.size() && i < other.hashes.size(); i++) {
+      if (hashes[i] != other.hashes[i]) return (i + 1) * REPLAY_HASH_INTERVAL;
+    }
+    return final_hash != other.final_hash ? max(ticks, other.ticks) : 0;
+  }
+};
+
+/*
+Appends the inputs and outcome of a replay to a byte buffer. Each event takes the tick distance from the previous
+event as a variable length number followed by one byte holding the type and direction, so a typical input is 2 bytes.
+The state hashes follow the events.
+
+Params: 1 ByteWriter reference, 1 ReplayLog
+ByteWriter, out: The buffer to write to
+ReplayLog, log: The replay to write
+
+Returns: Void
+*/
+void writeReplay(ByteWriter& out, const ReplayLog& log)
+{
+  writeConfig(out, log.config);
+  out.putVar(log.ticks);
+  out.putVar(log.score);
+  out.put8(log.won);
+  out.putVar(log.events.size());
+
+  uint64_t previous_tick = 0;
+  for (const ReplayEvent& e:log.events) {
+    size_t direction = REPLAY_DIRECTIONS.find(e.direction);
+    out.putVar(e.tick - previous_tick);
+    out.put8((e.type << 2) | (direction == string::npos ? 0 : direction));
+    previous_tick = e.tick;
+  }
+
+  out.putVar(log.hashes.size());
+  for (uint64_t hash:log.hashes) out.put64(hash);
+  out.put64(log.final_hash);
+  return;
+}
+
+/*
+Reads back a replay written by writeReplay
+
+Params: 1 ByteReader reference
+ByteReader, in: The buffer to read from
+
+Returns: The replay, throws out_of_range if the buffer ends early
+*/
+ReplayLog readReplay(ByteReader& in)
+{
+  ReplayLog log;
+  log.config = readConfig(in);
+  log.ticks = in.getVar();
+  log.score = in.getVar();
+  log.won = in.get8();
+
+  uint64_t count = in.getVar();
+  uint64_t tick = 0;
+  for (uint64_t i = 0; i < count; i++) {
+    tick += in.getVar();
+    uint8_t packed = in.get8();
+    uint8_t type = packed >> 2;
+    log.addEvent(tick, type, type == REPLAY_DIRECTION ? REPLAY_DIRECTIONS[packed & 3] : 0);
+  }
+
+  uint64_t hash_count = in.getVar();
+  if (hash_count > log.ticks / REPLAY_HASH_INTERVAL) throw out_of_range("More state hashes than ticks in a replay.");
+  log.hashes.resize(hash_count);
+  for (uint64_t &hash:log.hashes) hash = in.get64();
+  log.final_hash = in.get64();
+  return log;
+}
+
+/*
+Writes a replay file
+
+Params: 1 string, 1 ReplayLog
+string, path: The file to write
+ReplayLog, log: The replay to write
+
+Returns: True if the file was written
+*/
+bool saveReplay(const string& path, const ReplayLog& log)
+{
+  ByteWriter payload;
+  writeReplay(payload, log);
+  return writeFramedFile(path, REPLAY_MAGIC, REPLAY_VERSION, payload.bytes);
+}
+
+/*
+Reads a replay file
+
+Params: 1 string
+string, path: The file to read
+
+Returns: The replay, throws runtime_error if the file is missing or damaged
+*/
+ReplayLog loadReplay(const string& path)
+{
+  vector<uint8_t> payload;
+  readFramedFile(path, REPLAY_MAGIC, REPLAY_VERSION, payload);
+  ByteReader in(payload);
+  try {
+    return readReplay(in);
+  } catch (const out_of_range&) {
+    throw runtime_error(path + " is truncated");
+  }
+}
+
+/*
+ReplayStream Class:
+  A replay file mapped read-only into memory and decoded as it is played: opening it checks the frame and reads the
+  config and outcome, and every input is decoded from the mapping only once the game reaches its tick, with a single
+  decoded input kept ahead. A replay of any length takes the same memory to play this way, used to race a ghost of an
+  earlier game alongside a live one.
+*/
+class ReplayStream
+{
+  public:
+    /*
+    Constructor for ReplayStream, maps a replay file and reads its header
+
+    Params: 1 string
+    string, path: The replay file
+
+    Throws runtime_error if the file is missing, damaged or not a replay of this version
+    */
+    ReplayStream(const string& path)
+    {
+      int fd = open(path.c_str(), O_RDONLY);
+      if (fd < 0) throw runtime_error("Could not read " + path);
+      struct stat info;
+      if (fstat(fd, &info) != 0 || info.st_size < 13) {
+        close(fd);
+        throw runtime_error(path + " is not a " + REPLAY_MAGIC + " file");
+      }
+      void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      //The mapping stays valid after the file is closed
+      close(fd);
+      if (mapped == MAP_FAILED) throw runtime_error("Could not map " + path);
+      data = (const uint8_t*)mapped;
+      bytes = info.st_size;
+
+      //Same frame as readFramedFile, checked in place instead of copying the payload out
+      try {
+        if (string((const char*)data, 4) != REPLAY_MAGIC) throw runtime_error(path + " is not a " + REPLAY_MAGIC + " file");
+        if (data[4] != REPLAY_VERSION) throw runtime_error(path + " was written by an unsupported version");
+        ByteReader frame(data + 5, 4);
+        uint32_t size = frame.get32();
+        if (bytes - 13 != size) throw runtime_error(path + " is truncated");
+        ByteReader checksum(data + 9 + size, 4);
+        if (checksum.get32() != checksumBytes(data + 9, size)) throw runtime_error(path + " is damaged");
+
+        in = ByteReader(data + 9, size);
+        config = readConfig(in);
+        ticks = in.getVar();
+        score = in.getVar();
+        won = in.get8();
+        remaining = in.getVar();
+      } catch (const out_of_range&) {
+        munmap((void*)data, bytes);
+        throw runtime_error(path + " is truncated");
+      } catch (const runtime_error&) {
+        munmap((void*)data, bytes);
+        throw;
+      }
+    }
+
+    ~ReplayStream() {munmap((void*)data, bytes);}
+    ReplayStream(const ReplayStream&) = delete;
+    ReplayStream& operator=(const ReplayStream&) = delete;
+
+    /*
+    Hands out the next input of the replay if it applies before a tick, decoding it from the file when needed
+
+    Params: 1 uint64_t, 1 ReplayEvent reference
+    uint64_t, tick: The tick about to be simulated
+    ReplayEvent, event: Receives the input
+
+    Returns: True if there was an input for the tick (call again until false), false once the next input is further ahead
+    */
+    bool next(uint64_t tick, ReplayEvent& event)
+    {
+      if (!has_ahead) {
+        if (remaining == 0) return false;
+        try {
+          ahead.tick += in.getVar();
+          uint8_t packed = in.get8();
+          ahead.type = packed >> 2;
+          ahead.direction = ahead.type == REPLAY_DIRECTION ? REPLAY_DIRECTIONS[packed & 3] : 0;
+        } catch (const out_of_range&) {
+          //The checksum matched, so only a replay written wrongly ends early, it just has no more inputs
+          remaining = 0;
+          return false;
+        }
+        remaining--;
+        decoded++;
+        has_ahead = true;
+      }
+      if (ahead.tick > tick) return false;
+      event = ahead;
+      has_ahead = false;
+      return true;
+    }
+
+    /*
+    Get respective private values (in function name)
+
+    Params: None
+
+    Returns: The respective value
+    */
+    const GameConfig& getConfig() const {return config;}
+    uint64_t getTicks() const {return ticks;} //Ticks the recorded game lasted
+    int getScore() const {return score;} //Final score of the recorded game
+    bool isWon() const {return won;}
+    uint64_t getDecoded() const {return decoded;} //Inputs decoded so far
+
+  private:
+    const uint8_t* data = nullptr;
+    size_t bytes = 0;
+    ByteReader in = ByteReader(nullptr, 0); //Positioned at the next undecoded input
+    GameConfig config;
+    uint64_t ticks = 0;
+    int score = 0;
+    bool won = false;
+    uint64_t remaining = 0; //Inputs not decoded yet
+    uint64_t decoded = 0;
+    ReplayEvent ahead = {0, 0, 0}; //The last decoded input, has_ahead while it hasn't been handed out
+    bool has_ahead = false;
+};
+
+#endif
@@ -0,0 +1,433 @@
+/*
+* File: Rewind.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the rewind history of a game: RewindBuffer
+* keeps the last seconds of a GameState as a byte per tick or so in a
+* fixed-size ring, so a game can be scrubbed backwards while playing and
+* watched again on the game over screen without re-simulating it, and
+* RewindFrame is what the board looked like on one tick of that history.
+*/
+
+//Redundancy safety check
+#ifndef REWIND_H
+#define REWIND_H
+
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <string>
+#include <cstdint>
+#include "Engine.hpp"
+#include "Bot.hpp"
+#include "BinaryFile.hpp"
+
+using namespace std;
+
+//Bytes of history kept by default, a power of two
+const size_t REWIND_BUFFER_BYTES = 1 << 20;
+//Fewest ticks between two keyframes, longer snakes space them further apart
+const uint64_t MIN_KEYFRAME_INTERVAL = 64;
+
+/*
+The RewindFrame struct is the board as it was on one tick of the history: everything needed to draw it
+*/
+struct RewindFrame
+{
+  uint64_t tick = 0;
+  uint64_t game_time = 0;
+  int score = 0;
+  int speed = 0; //Milliseconds of game time per tick
+  char direction = 'd';
+  SnakeBody body; //Front is the head
+  vector<Item> items;
+  uint64_t next_record = 0; //Where the record of the next tick starts in the ring
+};
+
+/*
+RewindBuffer Class:
+  The history of a game as a ring of bytes. Every tick adds a delta record, usually a single byte: the direction the head
+  moved in and whether the tail moved, followed only when needed by the cell of a head that went through a portal, the
+  number of cells cut off the tail, the items that spawned, the points scored and the new speed. An eaten item is the one
+  under the new head, so it takes no room at all. Now and then a keyframe records the whole board (the body as runs of
+  2-bit steps), and a tick is found by decoding the keyframe before it and applying the deltas after it. Keyframes are
+  spaced by at least a quarter of the snake's length in ticks, so they never cost more than about a byte per tick either.
+
+  Memory stays at the size of the ring however long the game or the snake gets: once the ring is full, or the oldest
+  keyframe is further back than the window, the oldest keyframe and its deltas are dropped. If a single keyframe doesn't
+  fit the ring, the history is empty until one does.
+*/
+class RewindBuffer
+{
+  public:
+    /*
+    Constructor for RewindBuffer
+
+    Params: 1 size_t, 1 uint64_t
+    size_t, capacity: Bytes of history kept, rounded up to a power of two
+    uint64_t, window: Milliseconds of game time to look back at most
+    */
+    RewindBuffer(size_t capacity=REWIND_BUFFER_BYTES, uint64_t window=10000) : window_ms(window)
+    {
+      size_t bytes = 64;
+      while (bytes < capacity) bytes <<= 1;
+      ring.assign(bytes, 0);
+      mask = bytes - 1;
+    };
+
+    /*
+    Starts a new history with the state of a game that has not been stepped yet, or is being picked up midway
+
+    Params: 1 GameState
+    GameState, game: The game
+
+    Returns: Void
+    */
+    void start(const GameState &game)
+    {
+      keyframes.clear();
+      board_columns = game.getColumns();
+      writeKeyframe(game);
+      return;
+    }
+
+    /*
+    Adds the tick that was just stepped to the history
+
+    Params: 1 GameState, 1 StepResult
+    GameState, game: The game after the tick
+    StepResult, result: What changed during the tick
+
+    Returns: Void
+    */
+    void record(const GameState &game, const StepResult &result)
+    {
+      //The history restarts when a tick was missed, and gets a keyframe once the deltas since the last one add up
+      uint64_t interval = game.getBody().size() / 4 > MIN_KEYFRAME_INTERVAL ? game.getBody().size() / 4 : MIN_KEYFRAME_INTERVAL;
+      if (keyframes.empty() || game.getTick() != last_tick + 1 || game.getTick() - keyframes.back().tick >= interval) return writeKeyframe(game);
+
+      scratch.bytes.clear();
+      const ipair head = game.getBody().front();
+      uint8_t flags = directionIndex(game.getDirection());
+      scratch.put8(0);
+      if (head != stepCell(last_head, game.getDirection()))
+      {
+        flags |= DELTA_JUMP;
+        scratch.putVar(cellIndex(head));
+      }
+      size_t pops = result.tail_moved + game.getShrunkCells().size();
+      if (pops == 1) flags |= DELTA_POP;
+      else if (pops > 1)
+      {
+        flags |= DELTA_POPS;
+        scratch.putVar(pops);
+      }
+      if (!game.getSpawnedItems().empty())
+      {
+        flags |= DELTA_SPAWNS;
+        scratch.putVar(game.getSpawnedItems().size());
+        for (const Item &item:game.getSpawnedItems())
+        {
+          scratch.putVar(cellIndex(item.cell));
+          scratch.put8(item.type);
+        }
+      }
+      if (game.getScore() != last_score)
+      {
+        flags |= DELTA_SCORE;
+        scratch.putVar(game.getScore() - last_score);
+      }
+      if (game.getSpeed() != last_speed)
+      {
+        flags |= DELTA_SPEED;
+        scratch.putVar(game.getSpeed());
+      }
+      scratch.bytes[0] = flags;
+
+      //A delta can only follow the keyframe of its own segment, when that segment fills the ring a keyframe starts a new one
+      if (!makeRoom(scratch.bytes.size(), false)) return writeKeyframe(game);
+      append(scratch.bytes);
+      remember(game);
+      return;
+    }
+
+    /*
+    Decodes one tick of the history
+
+    Params: 1 uint64_t, 1 RewindFrame reference
+    uint64_t, tick: The tick, between getFirstTick() and getLastTick()
+    RewindFrame, frame: Receives the board on that tick
+
+    Returns: False if the tick is not in the history
+    */
+    bool seek(uint64_t tick, RewindFrame &frame) const
+    {
+      if (empty() || tick < getFirstTick() || tick > last_tick) return false;
+      //The last keyframe at or before the tick
+      size_t low = 0, high = keyframes.size() - 1;
+      while (low < high)
+      {
+        size_t middle = (low + high + 1) / 2;
+        if (keyframes[middle].tick <= tick) low = middle;
+        else high = middle - 1;
+      }
+      readKeyframe(keyframes[low].offset, frame);
+      while (frame.tick < tick) readDelta(frame);
+      return true;
+    }
+
+    /*
+    Moves a decoded frame one tick forward, much cheaper than seeking to it
+
+    Params: 1 RewindFrame reference
+    RewindFrame, frame: A frame decoded by seek() or next(), receives the following tick
+
+    Returns: False if the frame was already on the last tick of the history
+    */
+    bool next(RewindFrame &frame) const
+    {
+      if (frame.tick >= last_tick) return false;
+      //The record after the last delta of a segment is the keyframe of the next one
+      auto keyframe = lower_bound(keyframes.begin(), keyframes.end(), frame.tick + 1, [](const Keyframe &k, uint64_t tick){return k.tick < tick;});
+      if (keyframe != keyframes.end() && keyframe->tick == frame.tick + 1)
+      {
+        readKeyframe(keyframe->offset, frame);
+        return true;
+      }
+      readDelta(frame);
+      return true;
+    }
+
+    bool empty() const {return keyframes.empty();}
+    //Oldest and newest tick in the history
+    uint64_t getFirstTick() const {return keyframes.empty() ? 0 : keyframes.front().tick;}
+    uint64_t getLastTick() const {return last_tick;}
+    //Bytes of the ring in use
+    size_t getUsedBytes() const {return keyframes.empty() ? 0 : write_pos - keyframes.front().offset;}
+    size_t getCapacity() const {return ring.size();}
+
+  private:
+    //Flags of the first byte of a delta record, the low 2 bits are the direction the head moved in (an index into "wasd")
+    static const uint8_t DELTA_JUMP = 0x04; //The head went through a portal, its cell follows
+    static const uint8_t DELTA_POP = 0x08; //One cell was popped off the tail
+    static const uint8_t DELTA_POPS = 0x10; //Several cells were popped off the tail, their count follows
+    static const uint8_t DELTA_SPAWNS = 0x20; //Items spawned, their count follows and then the cell and type of each
+    static const uint8_t DELTA_SCORE = 0x40; //The points scored follow
+    static const uint8_t DELTA_SPEED = 0x80; //The new speed follows
+
+    //Where a keyframe starts in the ring, positions count every byte ever written and are masked into the ring
+    struct Keyframe
+    {
+      uint64_t tick;
+      uint64_t game_time;
+      uint64_t offset;
+    };
+
+    vector<uint8_t> ring;
+    size_t mask;
+    uint64_t window_ms;
+    uint64_t write_pos = 0;
+    deque<Keyframe> keyframes; //Oldest first, the history starts at the first one
+    ByteWriter scratch; //The record being encoded
+
+    int board_columns = 0;
+    //The game as of the newest record
+    uint64_t last_tick = 0;
+    ipair last_head = {0, 0};
+    int last_score = 0;
+    int last_speed = 0;
+
+    static uint8_t directionIndex(char direction) {return string("wasd").find(direction) & 3;}
+    uint64_t cellIndex(ipair cell) const {return uint64_t(cell.first) * board_columns + cell.second;}
+    ipair cellOf(uint64_t index) const {return {int(index / board_columns), int(index % board_columns)};}
+
+    void remember(const GameState &game)
+    {
+      last_tick = game.getTick();
+      last_head = game.getBody().front();
+      last_score = game.getScore();
+      last_speed = game.getSpeed();
+      return;
+    }
+
+    //Drops the oldest segments until a record of the given size fits, a keyframe may drop every segment
+    bool makeRoom(size_t bytes, bool keyframe)
+    {
+      if (bytes > ring.size()) return false;
+      while (!keyframes.empty() && write_pos + bytes - keyframes.front().offset > ring.size())
+      {
+        if (keyframes.size() == 1 && !keyframe) return false;
+        keyframes.pop_front();
+      }
+      return true;
+    }
+
+    void append(const vector<uint8_t> &bytes)
+    {
+      for (uint8_t byte:bytes) ring[(write_pos++) & mask] = byte;
+      return;
+    }
+
+    //Writes the whole board as a keyframe starting a new segment
+    void writeKeyframe(const GameState &game)
+    {
+      scratch.bytes.clear();
+      scratch.putVar(game.getTick());
+      scratch.putVar(game.getGameTime());
+      scratch.putVar(game.getScore());
+      scratch.putVar(game.getSpeed());
+      scratch.put8(directionIndex(game.getDirection()));
+
+      //The body as runs of adjacent segments, a run breaks where the body goes through a portal
+      const SnakeBody &body = game.getBody();
+      vector<size_t> run_starts;
+      for (size_t i = 0; i < body.size(); i++)
+      {
+        if (i == 0 || stepDirection(body[i - 1], body[i]) < 0) run_starts.push_back(i);
+      }
+      scratch.putVar(body.size());
+      scratch.putVar(run_starts.size());
+      for (size_t run = 0; run < run_starts.size(); run++)
+      {
+        size_t first = run_starts[run], end = run + 1 < run_starts.size() ? run_starts[run + 1] : body.size();
+        scratch.putVar(cellIndex(body[first]));
+        scratch.putVar(end - first);
+        //4 steps per byte
+        uint8_t packed = 0;
+        for (size_t i = first + 1; i < end; i++)
+        {
+          packed |= stepDirection(body[i - 1], body[i]) << (2 * ((i - first - 1) & 3));
+          if (((i - first - 1) & 3) == 3 || i + 1 == end)
+          {
+            scratch.put8(packed);
+            packed = 0;
+          }
+        }
+      }
+
+      scratch.putVar(game.getItems().size());
+      for (const Item &item:game.getItems())
+      {
+        scratch.putVar(cellIndex(item.cell));
+        scratch.put8(item.type);
+      }
+
+      if (!makeRoom(scratch.bytes.size(), true))
+      {
+        //Not even the keyframe fits, there is no history until one does
+        keyframes.clear();
+        remember(game);
+        return;
+      }
+      keyframes.push_back({game.getTick(), game.getGameTime(), write_pos});
+      append(scratch.bytes);
+      remember(game);
+
+      //Segments entirely older than the window are no longer needed
+      while (keyframes.size() > 1 && keyframes[1].game_time + window_ms <= game.getGameTime()) keyframes.pop_front();
+      return;
+    }
+
+    //Index into "wasd" of the step from one segment to the next, -1 if they are not next to each other
+    static int stepDirection(ipair from, ipair to)
+    {
+      for (int d = 0; d < 4; d++) if (stepCell(from, "wasd"[d]) == to) return d;
+      return -1;
+    }
+
+    //Reads back the values written to the ring
+    struct RingReader
+    {
+      const vector<uint8_t> &ring;
+      size_t mask;
+      uint64_t pos;
+
+      uint8_t get8() {return ring[(pos++) & mask];}
+      uint64_t getVar()
+      {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+          uint8_t b = get8();
+          v |= uint64_t(b & 0x7F) << shift;
+          if (!(b & 0x80)) break;
+        }
+        return v;
+      }
+    };
+
+    void readKeyframe(uint64_t offset, RewindFrame &frame) const
+    {
+      RingReader in = {ring, mask, offset};
+      frame.tick = in.getVar();
+      frame.game_time = in.getVar();
+      frame.score = in.getVar();
+      frame.speed = in.getVar();
+      frame.direction = "wasd"[in.get8() & 3];
+
+      frame.body.clear();
+      in.getVar(); //Body length, the runs add up to it
+      size_t runs = in.getVar();
+      for (size_t run = 0; run < runs; run++)
+      {
+        ipair cell = cellOf(in.getVar());
+        size_t length = in.getVar();
+        frame.body.pushBack(cell);
+        uint8_t packed = 0;
+        for (size_t i = 1; i < length; i++)
+        {
+          if (((i - 1) & 3) == 0) packed = in.get8();
+          cell = stepCell(cell, "wasd"[(packed >> (2 * ((i - 1) & 3))) & 3]);
+          frame.body.pushBack(cell);
+        }
+      }
+
+      frame.items.clear();
+      size_t items = in.getVar();
+      for (size_t i = 0; i < items; i++)
+      {
+        ipair cell = cellOf(in.getVar());
+        frame.items.push_back({cell, in.get8()});
+      }
+      frame.next_record = in.pos;
+      return;
+    }
+
+    void readDelta(RewindFrame &frame) const
+    {
+      RingReader in = {ring, mask, frame.next_record};
+      uint8_t flags = in.get8();
+      frame.direction = "wasd"[flags & 3];
+      ipair head = (flags & DELTA_JUMP) ? cellOf(in.getVar()) : stepCell(frame.body.front(), frame.direction);
+      frame.body.pushFront(head);
+      size_t pops = (flags & DELTA_POP) ? 1 : (flags & DELTA_POPS) ? in.getVar() : 0;
+      for (size_t i = 0; i < pops && frame.body.size() > 1; i++) frame.body.popBack();
+
+      //Whatever lay under the new head was eaten
+      for (size_t i = 0; i < frame.items.size(); i++)
+      {
+        if (frame.items[i].cell != head) continue;
+        frame.items[i] = frame.items.back();
+        frame.items.pop_back();
+        break;
+      }
+      if (flags & DELTA_SPAWNS)
+      {
+        size_t spawned = in.getVar();
+        for (size_t i = 0; i < spawned; i++)
+        {
+          ipair cell = cellOf(in.getVar());
+          frame.items.push_back({cell, in.get8()});
+        }
+      }
+      if (flags & DELTA_SCORE) frame.score += in.getVar();
+      if (flags & DELTA_SPEED) frame.speed = in.getVar();
+      frame.game_time += frame.speed;
+      frame.tick++;
+      frame.next_record = in.pos;
+      return;
+    }
+};
+
+#endif
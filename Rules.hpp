@@ -0,0 +1,112 @@
+/*
+* File: Rules.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the encoding of directions as small numbers
+* with lookup tables for their steps, so moving and turning never switch
+* on the direction keys, and the rule policies (wall and collision modes)
+* that code templated on them specializes its per-tick loops for, so a
+* rule variant costs no branch inside the loop.
+*/
+
+//Redundancy safety check
+#ifndef RULES_H
+#define RULES_H
+
+#include <cstdint>
+
+/*
+Directions, in the order of their keys in DIRECTION_KEYS ("wasd", the order replays, the rewind history and the network
+inputs store them in). Opposite directions differ only in bit 1, so checking for a reversal is a single XOR.
+*/
+enum Direction : uint8_t
+{
+  DIRECTION_UP = 0,
+  DIRECTION_LEFT = 1,
+  DIRECTION_DOWN = 2,
+  DIRECTION_RIGHT = 3,
+  NO_DIRECTION = 4 //Any key that isn't a direction, it steps nowhere
+};
+
+//Key of every direction, indexed by Direction
+constexpr char DIRECTION_KEYS[] = "wasd";
+//Step of the head along each axis for every direction, indexed by Direction
+const int DIRECTION_ROW_STEP[5] = {-1, 0, 1, 0, 0};
+const int DIRECTION_COLUMN_STEP[5] = {0, -1, 0, 1, 0};
+
+//Direction of a char (0 to 255), a single return statement so it stays a C++11 constexpr function
+constexpr uint8_t keyDirection(int key, int direction=0)
+{
+  return direction == 4 ? uint8_t(NO_DIRECTION) : key == DIRECTION_KEYS[direction] ? uint8_t(direction) : keyDirection(key, direction + 1);
+}
+
+/*
+The DirectionTable struct maps every char to its Direction in a 256 entry table, filled in at compile time. The entries
+are spelled out 16 at a time by DIRECTION_TABLE_ROW since a C++11 constexpr constructor can't loop.
+*/
+struct DirectionTable
+{
+  uint8_t of[256];
+};
+
+#define DIRECTION_TABLE_ROW(r) \
+  keyDirection(r*16+0), keyDirection(r*16+1), keyDirection(r*16+2), keyDirection(r*16+3), \
+  keyDirection(r*16+4), keyDirection(r*16+5), keyDirection(r*16+6), keyDirection(r*16+7), \
+  keyDirection(r*16+8), keyDirection(r*16+9), keyDirection(r*16+10), keyDirection(r*16+11), \
+  keyDirection(r*16+12), keyDirection(r*16+13), keyDirection(r*16+14), keyDirection(r*16+15)
+constexpr DirectionTable DIRECTION_TABLE = {{
+  DIRECTION_TABLE_ROW(0), DIRECTION_TABLE_ROW(1), DIRECTION_TABLE_ROW(2), DIRECTION_TABLE_ROW(3),
+  DIRECTION_TABLE_ROW(4), DIRECTION_TABLE_ROW(5), DIRECTION_TABLE_ROW(6), DIRECTION_TABLE_ROW(7),
+  DIRECTION_TABLE_ROW(8), DIRECTION_TABLE_ROW(9), DIRECTION_TABLE_ROW(10), DIRECTION_TABLE_ROW(11),
+  DIRECTION_TABLE_ROW(12), DIRECTION_TABLE_ROW(13), DIRECTION_TABLE_ROW(14), DIRECTION_TABLE_ROW(15)
+}};
+#undef DIRECTION_TABLE_ROW
+static_assert(DIRECTION_TABLE.of['w'] == DIRECTION_UP && DIRECTION_TABLE.of['d'] == DIRECTION_RIGHT && DIRECTION_TABLE.of[0] == NO_DIRECTION,
+              "DIRECTION_TABLE follows DIRECTION_KEYS");
+
+//Returns the Direction of a key ('w', 'a', 's' or 'd'), NO_DIRECTION for any other char
+inline Direction directionOf(char key) {return Direction(DIRECTION_TABLE.of[uint8_t(key)]);}
+
+//Returns true if the two directions are opposite, never for NO_DIRECTION
+inline bool isReverse(Direction a, Direction b) {return (a ^ b) == 2;}
+
+/*
+Wall policies, a compile-time choice of what the border does to a head crossing it:
+  SolidWalls: the head crashes into the border (the normal rules)
+  WrapWalls: the head comes back in on the opposite side of the board, the border never kills
+wrap() takes a coordinate after the step and the index of the far border row or column, and returns where the head
+really is, written as selects so it compiles without a branch.
+*/
+struct SolidWalls
+{
+  static const bool WRAPS = false;
+  static int32_t wrap(int32_t value, int32_t) {return value;}
+};
+
+struct WrapWalls
+{
+  static const bool WRAPS = true;
+  static int32_t wrap(int32_t value, int32_t last)
+  {
+    value = value < 1 ? last - 1 : value;
+    return value >= last ? 1 : value;
+  }
+};
+
+/*
+Collision policies, a compile-time choice of what the head does on a cell the body covers:
+  SelfCollision: the snake dies (the normal rules)
+  NoSelfCollision: the head passes over the body, which may then cover a cell more than once
+*/
+struct SelfCollision
+{
+  static const bool ENABLED = true;
+};
+
+struct NoSelfCollision
+{
+  static const bool ENABLED = false;
+};
+
+#endif
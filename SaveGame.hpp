@@ -0,0 +1,94 @@
+/*
+* File: SaveGame.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the saved game file: a game left from the
+* pause menu with SAVE AND QUIT is written here in full and picked up again
+* on a later launch. The state is stored in the layout the engine restores
+* from in place (see SaveHeader), so resuming takes about as long as
+* reading the file, however long the snake got.
+*/
+
+//Redundancy safety check
+#ifndef SAVEGAME_H
+#define SAVEGAME_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <unistd.h>
+#include "BinaryFile.hpp"
+#include "GameConfig.hpp"
+#include "Engine.hpp"
+#include "Level.hpp"
+
+using namespace std;
+
+//Saved game layout constants
+//File layout: framed by writeFramedFile, the payload is the config (see writeConfig), zero padding up to an 8 byte
+//boundary, then the state written by GameState::writeSave
+const string SAVE_MAGIC = "ASNS";
+const uint8_t SAVE_VERSION = 2; //Version 2 keeps item cells out of the saved free cells
+
+/*
+Writes a game to a save file, atomically so a crash never leaves a half written save behind
+
+Params: 1 string, 1 GameState
+string, path: The file to write
+GameState, game: The game to save
+
+Returns: True if the file was written
+*/
+bool saveGame(const string& path, const GameState& game)
+{
+  ByteWriter payload;
+  writeConfig(payload, game.getConfig());
+  payload.bytes.resize(LevelLayout::align(payload.bytes.size()), 0);
+  game.writeSave(payload);
+  return writeFramedFile(path, SAVE_MAGIC, SAVE_VERSION, payload.bytes);
+}
+
+/*
+Reads back a game written by saveGame, on its level if it was played on one
+
+Params: 1 string
+string, path: The file to read
+
+Returns: The game as it was saved, throws runtime_error if the file is missing or damaged, or its level changed
+*/
+GameState loadGame(const string& path)
+{
+  vector<uint8_t> payload;
+  readFramedFile(path, SAVE_MAGIC, SAVE_VERSION, payload);
+  ByteReader in(payload);
+  GameConfig config;
+  try {
+    config = readConfig(in);
+  } catch (const out_of_range&) {
+    throw runtime_error(path + " is truncated");
+  }
+
+  Level level;
+  if (!config.level_path.empty()) {
+    level = openLevel(config.level_path, config.level_index);
+    if (level.getChecksum() != config.level_checksum) throw runtime_error("The level changed since the game was saved");
+  }
+  //The payload vector starts on an 8 byte boundary, so the state does too
+  size_t start = LevelLayout::align(in.pos);
+  if (start > payload.size()) throw runtime_error(path + " is truncated");
+  try {
+    return GameState::restore(config, level, payload.data() + start, payload.size() - start);
+  } catch (const invalid_argument&) {
+    throw runtime_error("The level of " + path + " is not the size of its board");
+  }
+}
+
+//Returns true if there is a saved game at a path
+bool hasSavedGame(const string& path)
+{
+  return access(path.c_str(), F_OK) == 0;
+}
+
+#endif
@@ -0,0 +1,354 @@
+/*
+* File: Settings.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains everything needed to start the game without
+* any prompts: parsing of the command-line options, and loading/saving the
+* settings, style presets and highest score to a small versioned binary file.
+*/
+
+//Redundancy safety check
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include "BinaryFile.hpp"
+#include "GameCode.hpp"
+
+using namespace std;
+
+//Settings file layout constants
+//File layout: "ASNK" | version (1 byte) | payload size (2 bytes) | payload | FNV-1a checksum of the payload (4 bytes)
+//Version 2 appends the settings added with the item system after the version 1 payload, version 1 files still load
+const char SETTINGS_MAGIC[4] = {'A', 'S', 'N', 'K'};
+const uint8_t SETTINGS_VERSION = 2;
+//Path of the settings file, replaced by --settings
+string SETTINGS_PATH = string(getenv("HOME") ? getenv("HOME") : ".") + "/.ascii_snake_settings";
+
+//Every setting stored in the file, in file order
+char* const SETTINGS_CHARS[] = {&CURSOR_UP, &CURSOR_DOWN, &SNAKE_HEAD_UP, &SNAKE_HEAD_DOWN, &SNAKE_HEAD_RIGHT, &SNAKE_HEAD_LEFT, &FOOD_CHAR,
+                                &SNAKE_BODY_CHAR, &GRID_BORDER, &CURSOR_CHAR, &PAUSE_KEY, &POWERUP_1_CHAR, &POWERUP_2_CHAR};
+int* const SETTINGS_INTS[] = {&INITIAL_SPEED, &MAX_SPEED, &SPEED_MULTIPLIER, &HIGHEST_SCORE, &POWERUP_TIME, &POWERUP_SPAWN_TIME, &SLOW_MO_POWERUP_INCREMENT};
+bool* const SETTINGS_BOOLS[] = {&SELF_COLLISION, &ENABLE_POWERUPS};
+CharStyle* const SETTINGS_STYLES[] = {&MENU_TEXT, &MENU_OPTION, &CURSOR, &SCOREBOARD, &SNAKE_BODY, &SNAKE_HEAD, &SNAKE_FOOD, &BARRIER,
+                                      &POWERUP1, &POWERUP2, &BACKGROUND};
+//Settings added in version 2, stored after all of the above in the same order (chars, ints, one byte of bools, styles)
+char* const SETTINGS_CHARS_V2[] = {&POWERUP_3_CHAR, &POWERUP_4_CHAR};
+int* const SETTINGS_INTS_V2[] = {&FOOD_COUNT, &MAX_POWERUPS};
+bool* const SETTINGS_BOOLS_V2[] = {&ENABLE_SHRINK_POWERUP, &ENABLE_DOUBLE_SCORE_POWERUP};
+CharStyle* const SETTINGS_STYLES_V2[] = {&POWERUP3, &POWERUP4};
+
+/*
+Appends one group of settings (chars, ints, booleans packed into a byte, then styles) to a byte buffer
+
+Params: 1 ByteWriter reference, 4 arrays
+ByteWriter, payload: The buffer to write to
+char* const[], chars / int* const[], ints / bool* const[], bools / CharStyle* const[], styles: The settings of the group
+
+Returns: Void
+*/
+template <size_t C, size_t I, size_t B, size_t S>
+void writeSettingsGroup(ByteWriter &payload, char* const (&chars)[C], int* const (&ints)[I], bool* const (&bools)[B], CharStyle* const (&styles)[S])
+{
+  for (char* c:chars) payload.put8(*c);
+  for (int* i:ints) payload.put32(*i);
+
+  //Booleans are packed into a single byte
+  uint8_t flags = 0;
+  for (size_t i = 0; i < B; i++) {
+    if (*bools[i]) flags |= (1 << i);
+  }
+  payload.put8(flags);
+
+  //Styles take 3 bytes each, the four format flags and the two 0-255 colors
+  for (CharStyle* s:styles) {
+    payload.put8(s->bold | (s->italic << 1) | (s->underline << 2) | (s->blinking << 3));
+    payload.put8(s->fg_color);
+    payload.put8(s->bg_color);
+  }
+  return;
+}
+
+/*
+Reads back one group of settings written by writeSettingsGroup, throws out_of_range if the payload is too short
+
+Params: 1 ByteReader reference, 4 arrays
+ByteReader, payload: The buffer to read from
+char* const[], chars / int* const[], ints / bool* const[], bools / CharStyle* const[], styles: The settings of the group
+
+Returns: Void
+*/
+template <size_t C, size_t I, size_t B, size_t S>
+void readSettingsGroup(ByteReader &payload, char* const (&chars)[C], int* const (&ints)[I], bool* const (&bools)[B], CharStyle* const (&styles)[S])
+{
+  for (char* c:chars) *c = payload.get8();
+  for (int* i:ints) *i = int32_t(payload.get32());
+  uint8_t flags = payload.get8();
+  for (size_t i = 0; i < B; i++) *bools[i] = flags & (1 << i);
+  for (CharStyle* s:styles) {
+    uint8_t format = payload.get8();
+    s->bold = format & 1;
+    s->italic = format & 2;
+    s->underline = format & 4;
+    s->blinking = format & 8;
+    s->fg_color = payload.get8();
+    s->bg_color = payload.get8();
+  }
+  return;
+}
+
+/*
+Writes every setting, style preset and the highest score to the settings file
+
+Params: None
+
+Returns: True if the file was written
+*/
+bool saveSettings()
+{
+  ByteWriter payload;
+  writeSettingsGroup(payload, SETTINGS_CHARS, SETTINGS_INTS, SETTINGS_BOOLS, SETTINGS_STYLES);
+  writeSettingsGroup(payload, SETTINGS_CHARS_V2, SETTINGS_INTS_V2, SETTINGS_BOOLS_V2, SETTINGS_STYLES_V2);
+
+  ByteWriter file;
+  file.putBytes(SETTINGS_MAGIC, 4);
+  file.put8(SETTINGS_VERSION);
+  file.put16(payload.bytes.size());
+  file.putBytes(payload.bytes.data(), payload.bytes.size());
+  file.put32(checksumBytes(payload.bytes.data(), payload.bytes.size()));
+
+  return atomicWriteFile(SETTINGS_PATH, file.bytes);
+}
+
+/*
+Loads the settings file written by saveSettings, leaving the defaults in place if the file is missing,
+from another version or damaged
+
+Params: None
+
+Returns: True if the settings were loaded
+*/
+bool loadSettings()
+{
+  vector<uint8_t> bytes;
+  if (!readFile(SETTINGS_PATH, bytes)) return false;
+
+  try {
+    ByteReader file(bytes);
+    char magic[4];
+    file.getBytes(magic, 4);
+    for (int i = 0; i < 4; i++) if (magic[i] != SETTINGS_MAGIC[i]) return false;
+    uint8_t version = file.get8();
+    if (version < 1 || version > SETTINGS_VERSION) return false;
+
+    uint16_t payload_size = file.get16();
+    if (bytes.size() != file.pos + payload_size + 4) return false;
+    const uint8_t* payload_start = bytes.data() + file.pos;
+    ByteReader checksum(payload_start + payload_size, 4);
+    if (checksum.get32() != checksumBytes(payload_start, payload_size)) return false;
+
+    ByteReader payload(payload_start, payload_size);
+    readSettingsGroup(payload, SETTINGS_CHARS, SETTINGS_INTS, SETTINGS_BOOLS, SETTINGS_STYLES);
+    //Files from version 1 keep the defaults of the newer settings
+    if (version >= 2) readSettingsGroup(payload, SETTINGS_CHARS_V2, SETTINGS_INTS_V2, SETTINGS_BOOLS_V2, SETTINGS_STYLES_V2);
+  } catch (const out_of_range&) {
+    return false;
+  }
+  return true;
+}
+
+//************************************************************************************//
+
+//Most display rows or columns --rows and --cols take, past any terminal but small enough for a headless game's grids
+const int MAX_DISPLAY_SIDE = 4096;
+
+/*
+The LaunchOptions struct holds everything that can be set from the command line
+*/
+struct LaunchOptions
+{
+  int rows = 0; //Requested display rows (0 asks the user)
+  int columns = 0; //Requested display columns (0 asks the user)
+  string mode = "menu"; //"menu" opens the main menu, "play" starts a game right away, "multi" a multi-snake game, "world" a world mode game, "host" and "join" a networked game, "resume" the saved game, "ghost" a ghost race
+  string replay_path = ""; //Replay file to play back instead of playing
+  string ghost_path = ""; //Replay file to race as a ghost in a ghost race
+  string level_source = ""; //Text form of a level pack to compile into LEVEL_PACK_PATH instead of playing
+  bool headless = false; //Run without drawing or reading input, prints the result and exits
+  bool help = false;
+};
+
+/*
+Prints the command-line usage
+
+Params: 1 string
+string, program: The name the program was started with
+
+Returns: Void
+*/
+void printUsage(const string& program)
+{
+  cout << "Usage: " << program << " [options]" << endl
+       << "  --rows N           Display rows to use instead of asking (16 to " << MAX_DISPLAY_SIDE << ")" << endl
+       << "  --cols N           Display columns to use instead of asking (75 to " << MAX_DISPLAY_SIDE << ")" << endl
+       << "  --seed N           Start every game from this seed so it can be reproduced exactly" << endl
+       << "  --daily            Play today's daily challenge (a seed shared by everyone on the same date)" << endl
+       << "  --mode MODE        menu (default), play to start a game right away, multi to start a multi-snake game" << endl
+       << "                     or world to start a game on a world larger than the screen" << endl
+       << "  --players N        Local players in a multi-snake game, 0 to " << PLAYER_KEYS.size() << " (default 2), player keys:";
+  for (const string& keys:PLAYER_KEYS) cout << " " << keys;
+  cout << endl
+       << "  --bots N           Bot snakes in a multi-snake game, at most " << MAX_NET_BOTS << " (default 4)" << endl
+       << "  --host ADDRESS     Host a networked multi-snake game for players on this machine, ADDRESS is unix:PATH" << endl
+       << "                     (a Unix domain socket) or tcp:PORT (TCP on loopback)" << endl
+       << "  --join ADDRESS     Join a networked game hosted on ADDRESS" << endl
+       << "  --net-players N    Players a hosted game waits for, the host included, 2 to " << MAX_NET_PLAYERS << " (default 2)" << endl
+       << "  --input-delay N    Ticks between a key press and the turn in a hosted game, 0 to " << MAX_INPUT_DELAY << " (default 2)" << endl
+       << "  --world-rows N     Rows of the world in world mode (default 1000, at most " << MAX_WORLD_SIDE << ")" << endl
+       << "  --world-cols N     Columns of the world in world mode (default 3000, at most " << MAX_WORLD_SIDE << ")" << endl
+       << "  --levels PATH      Play on a level of this level pack (the board takes the size of the level)" << endl
+       << "  --level N          Level of the pack to play (default 1)" << endl
+       << "  --build-levels TEXT PACK" << endl
+       << "                     Compile the text form of a level pack into a pack file and exit" << endl
+       << "  --rewind-seconds N Seconds of play kept to rewind (hold r) and to watch again after a crash (default 10, at most " << MAX_REWIND_SECONDS << "," << endl
+       << "                     0 turns it off)" << endl
+       << "  --headless         Play one game without drawing or reading input and print the result" << endl
+       << "  --autopilot        Let the planner steer the snake (a demo mode, also works with --headless)" << endl
+       << "  --bot NAME         Let a bot steer the snake instead:";
+  for (const string& name:BOT_NAMES) cout << " " << name;
+  cout << endl
+       << "  --tick-rate N      Simulate N ticks per second instead of following the game speed (at most 1000000)" << endl
+       << "  --render-rate N    Draw N frames per second (default 60)" << endl
+       << "  --settings PATH    Settings file to load and save (default ~/.ascii_snake_settings)" << endl
+       << "  --save PATH        File SAVE AND QUIT in the pause menu leaves the game in (default ~/.ascii_snake_save)" << endl
+       << "  --resume           Pick up the game left with SAVE AND QUIT right away (with --headless: play it to the end)" << endl
+       << "  --record PATH      Save every game as a replay to PATH" << endl
+       << "  --replay PATH      Play back a replay (with --headless: re-simulate it at full speed and verify the outcome)" << endl
+       << "  --ghost PATH       Race the game recorded in a replay, shown as a ghost snake on the same seed and settings" << endl
+       << "  --profile          Show the frame timing overlay (toggle it with '" << OVERLAY_KEY << "'), time headless games too and print" << endl
+       << "                     the timings of every phase of the ticks and frames on exit" << endl
+       << "  --help             Show this message" << endl;
+}
+
+/*
+Parses the command-line arguments
+
+Params: 1 integer, 1 char* array
+int, argc: The number of arguments
+char*[], argv: The arguments
+
+Returns: The parsed LaunchOptions, throws invalid_argument on an unknown or malformed option
+*/
+LaunchOptions parseArguments(int argc, char* argv[])
+{
+  LaunchOptions options;
+
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+
+    //Every option except the flags takes a value
+    auto value = [&]() -> string {
+      if (i+1 >= argc) throw invalid_argument("Missing value for " + arg);
+      return argv[++i];
+    };
+    auto number = [&]() -> long long {
+      string v = value();
+      size_t used = 0;
+      long long n = -1;
+      try { n = stoll(v, &used); } catch (const exception&) {}
+      if (used != v.size() || n < 0) throw invalid_argument("Expected a non-negative number for " + arg + ", got: " + v);
+      return n;
+    };
+    //A number with an upper bound, checked before it is narrowed into a setting so a huge value can't wrap into range
+    auto boundedNumber = [&](long long most, const string &error) -> long long {
+      long long n = number();
+      if (n > most) throw invalid_argument(error);
+      return n;
+    };
+
+    if (arg == "--rows" || arg == "--cols") {
+      (arg == "--rows" ? options.rows : options.columns) = boundedNumber(MAX_DISPLAY_SIDE, "Display size can be at most " + to_string(MAX_DISPLAY_SIDE) + " on each side");
+    }
+    else if (arg == "--seed") {
+      GAME_SEED = number();
+      FIXED_SEED = true;
+    }
+    else if (arg == "--daily") {
+      GAME_SEED = dailyChallengeSeed();
+      FIXED_SEED = true;
+    }
+    else if (arg == "--mode") {
+      options.mode = value();
+      if (options.mode != "menu" && options.mode != "play" && options.mode != "multi" && options.mode != "world") throw invalid_argument("Unknown mode: " + options.mode);
+    }
+    else if (arg == "--players") MULTI_PLAYERS = boundedNumber(PLAYER_KEYS.size(), "At most " + to_string(PLAYER_KEYS.size()) + " players can share the keyboard");
+    //Bots play in local and in hosted games alike, so they share the limit of a hosted game
+    else if (arg == "--bots") MULTI_BOTS = boundedNumber(MAX_NET_BOTS, "A multi-snake game takes at most " + to_string(MAX_NET_BOTS) + " bots");
+    else if (arg == "--host" || arg == "--join") {
+      NET_ADDRESS = value();
+      options.mode = arg.substr(2);
+    }
+    else if (arg == "--net-players") {
+      NET_PLAYERS = boundedNumber(MAX_NET_PLAYERS, "A networked game takes 2 to " + to_string(MAX_NET_PLAYERS) + " players");
+      if (NET_PLAYERS < 2) throw invalid_argument("A networked game takes 2 to " + to_string(MAX_NET_PLAYERS) + " players");
+    }
+    else if (arg == "--input-delay") INPUT_DELAY = boundedNumber(MAX_INPUT_DELAY, "The input delay can be at most " + to_string(MAX_INPUT_DELAY) + " ticks");
+    else if (arg == "--world-rows" || arg == "--world-cols") {
+      long long side = number();
+      if (side > MAX_WORLD_SIDE) throw invalid_argument("A world can be at most " + to_string(MAX_WORLD_SIDE) + " cells on each side");
+      (arg == "--world-rows" ? WORLD_ROWS : WORLD_COLUMNS) = side;
+    }
+    else if (arg == "--levels") LEVEL_PACK_PATH = value();
+    else if (arg == "--level") {
+      LEVEL_NUMBER = boundedNumber(INT_MAX, "Levels are numbered from 1 to " + to_string(INT_MAX)) - 1;
+      if (LEVEL_NUMBER < 0) throw invalid_argument("Levels are numbered from 1");
+    }
+    else if (arg == "--build-levels") {
+      options.level_source = value();
+      LEVEL_PACK_PATH = value();
+    }
+    else if (arg == "--rewind-seconds") REWIND_SECONDS = boundedNumber(MAX_REWIND_SECONDS, "At most " + to_string(MAX_REWIND_SECONDS) + " seconds can be kept to rewind");
+    else if (arg == "--headless") options.headless = true;
+    else if (arg == "--autopilot") AUTOPILOT_BOT = "autopilot";
+    else if (arg == "--bot") {
+      AUTOPILOT_BOT = value();
+      if (find(BOT_NAMES.begin(), BOT_NAMES.end(), AUTOPILOT_BOT) == BOT_NAMES.end()) throw invalid_argument("Unknown bot: " + AUTOPILOT_BOT);
+    }
+    else if (arg == "--tick-rate") {
+      long long rate = number();
+      //Ticks are scheduled in whole microseconds, a faster rate would make the time between them 0
+      if (rate > 1000000) throw invalid_argument("The tick rate can be at most 1000000 ticks per second");
+      TICK_RATE = rate;
+    }
+    else if (arg == "--render-rate") {
+      RENDER_RATE = number();
+      if (RENDER_RATE == 0) throw invalid_argument("The render rate must be at least 1 frame per second");
+    }
+    else if (arg == "--settings") SETTINGS_PATH = value();
+    else if (arg == "--save") SAVE_PATH = value();
+    else if (arg == "--resume") options.mode = "resume";
+    else if (arg == "--record") RECORD_PATH = value();
+    else if (arg == "--replay") options.replay_path = value();
+    else if (arg == "--ghost") {
+      options.ghost_path = value();
+      options.mode = "ghost";
+    }
+    else if (arg == "--profile") PROFILE = PROFILE_OVERLAY = true;
+    else if (arg == "--help" || arg == "-h") options.help = true;
+    else throw invalid_argument("Unknown option: " + arg);
+  }
+
+  if (options.mode == "multi" && MULTI_PLAYERS + MULTI_BOTS == 0) throw invalid_argument("A multi-snake game needs at least one player or bot");
+  if ((options.rows != 0 && options.rows < 16) || (options.columns != 0 && options.columns < 75)) {
+    throw invalid_argument("Display size must be at least 16x75");
+  }
+  return options;
+}
+
+#endif
@@ -81,6 +81,25 @@
     return last_chr;
   }
 
+  /*
+  Returns every (unread) character pressed since the last call, in the order they were pressed,
+  used when several players share the keyboard and one key per poll would drop the others' presses
+
+  Params: None
+
+  Returns: A string of the characters pressed, empty if no character has been pressed
+  */
+  std::string getInputs()
+  {
+    struct pollfd fds[1];
+    fds[0].fd = STDIN_FILENO;
+    fds[0].events = POLLIN;
+
+    std::string pressed;
+    while (poll(fds, 1, 0)) pressed += char(std::cin.get());
+    return pressed;
+  }
+
   /*
   A duplicate of the clear method for the Terminal class, Allows clearing the screen outside of a class instance
 
@@ -137,7 +156,7 @@
     int, r: The amount of rows of the display area
     int, c: The amount of columns in the display area
     */
-    public: Terminal(int r, int c) : rows(r), columns(c), char_grid(r, std::vector<std::string>(c, " ")){};
+    public: Terminal(int r, int c) : rows(r), columns(c), char_grid(r, std::vector<std::string>(c, " ")), drawn_grid(char_grid), dirty_rows(r, true){};
 
     private:
 
@@ -154,6 +173,7 @@
       void setElement(int row, int column, std::string to_set)
       {
          char_grid[row][column] = to_set;
+         dirty_rows[row] = true;
          return;
       }
 
@@ -222,12 +242,20 @@
       //Boolean storing visibility status of cursor
       bool cursor_visibility = true;
 
+      //When false nothing is printed to console, used for running without a display
+      bool output_enabled = true;
+
       
 
       //Display vector
       //Indexed as [row][column] OR [X][Y] (0-indexed)
       std::vector<std::vector<std::string>> char_grid;
 
+      //Copy of the display vector as it was last printed to console, used by drawChanges
+      std::vector<std::vector<std::string>> drawn_grid;
+      //True for each row that has been written to since it was last printed
+      std::vector<bool> dirty_rows;
+
     public:
 
       /*
@@ -249,6 +277,8 @@
       */
       void draw() 
       {
+        if (!output_enabled) return;
+
         //To help prevent flickering the contents of the table are appended to a single continuous string
         std::string pre_print = "";
 
@@ -267,9 +297,120 @@
         clear();
         std::cout << pre_print;
         std::cout.flush();
+
+        //Everything on console now matches the display grid
+        drawn_grid = char_grid;
+        dirty_rows.assign(rows, false);
         return;
       };
 
+      /*
+      Prints only the characters that changed since the display table was last printed. However many times a
+      character was set in between, only its latest value is printed, so all changes are coalesced into one update.
+
+      Params: None
+
+      Returns: The number of bytes written to console
+      */
+      size_t drawChanges()
+      {
+        return writeFrame(encodeChanges());
+      }
+
+      /*
+      The two halves of drawChanges, for callers that time them separately: encodeChanges builds the string of cursor
+      moves and characters that brings the console up to date (and counts it as printed), writeFrame prints it
+
+      Params: None (encodeChanges), 1 string (writeFrame)
+      std::string, frame: The changes returned by encodeChanges
+
+      Returns: The changes (encodeChanges), the number of bytes written to console (writeFrame)
+      */
+      std::string encodeChanges()
+      {
+        std::string pre_print = "";
+        if (!output_enabled) return pre_print;
+
+        for (int r = 0; r < rows; r++) {
+          if (!dirty_rows[r]) continue;
+          dirty_rows[r] = false;
+
+          //Tracks whether the cursor already sits right after the last printed character
+          bool in_run = false;
+          for (int c = 0; c < columns; c++) {
+            if (char_grid[r][c] == drawn_grid[r][c]) {
+              in_run = false;
+              continue;
+            }
+            //Move the cursor only at the start of a run of changed characters (ANSI positions are 1-indexed)
+            if (!in_run) pre_print += ESC + std::to_string(r+1) + ";" + std::to_string(c+1) + "H";
+            pre_print += char_grid[r][c];
+            drawn_grid[r][c] = char_grid[r][c];
+            in_run = true;
+          }
+        }
+        return pre_print;
+      }
+
+      size_t writeFrame(const std::string &frame)
+      {
+        if (!output_enabled || frame.empty()) return 0;
+        std::cout << frame;
+        std::cout.flush();
+        return frame.size();
+      }
+
+      /*
+      Scrolls a band of whole rows on console by a number of lines with a terminal scroll region, so content that only
+      moved up or down doesn't have to be printed again. The copy of what is on console is scrolled along with it, and
+      the lines that scroll in are marked as unknown, so the next drawChanges prints them and anything else that differs.
+      The display grid itself is left alone, the caller sets the new contents as usual.
+
+      Params: 3 integer
+      int, top: The first row of the band (0-indexed)
+      int, bottom: The last row of the band (inclusive)
+      int, lines: How far to scroll, positive moves the contents up (new lines appear at the bottom), negative down
+
+      Returns: Void
+      */
+      void scrollRows(int top, int bottom, int lines)
+      {
+        if (top < 0 || bottom >= rows || top > bottom || lines == 0) return;
+        int height = bottom - top + 1;
+        if (lines >= height || -lines >= height) {
+          //Nothing stays on screen, every row of the band is printed again
+          for (int r = top; r <= bottom; r++) drawn_grid[r].assign(columns, "");
+        } else if (output_enabled) {
+          //Set the scroll region, scroll it up (S) or down (T), then restore the full screen as the region
+          std::cout << ESC + std::to_string(top+1) + ";" + std::to_string(bottom+1) + "r"
+                    << ESC + std::to_string(lines > 0 ? lines : -lines) + (lines > 0 ? "S" : "T")
+                    << ESC + "r";
+          if (lines > 0) {
+            for (int r = top; r <= bottom; r++) {
+              if (r + lines <= bottom) drawn_grid[r].swap(drawn_grid[r + lines]);
+              else drawn_grid[r].assign(columns, "");
+            }
+          } else {
+            for (int r = bottom; r >= top; r--) {
+              if (r + lines >= top) drawn_grid[r].swap(drawn_grid[r + lines]);
+              else drawn_grid[r].assign(columns, "");
+            }
+          }
+        }
+        for (int r = top; r <= bottom; r++) dirty_rows[r] = true;
+        return;
+      }
+
+      /*
+      Enables or disables printing to console, the display grid is still kept up to date while disabled
+
+      Params: 1 bool
+      bool, to_set: True to print to console, False to keep all output off the console
+
+      Returns: Void
+      */
+      void setOutputEnabled(bool to_set) {output_enabled = to_set;}
+
       /*
       Changes the visibility status of the cursor (blinking vs not appearing at all)
 
@@ -280,6 +421,7 @@
       */
       void setCursorVisibility(bool to_set) 
       {
+        if (!output_enabled) return;
         //Checks if cursor_visibility is different from what the user requests
         if (to_set != cursor_visibility){
           //Checks if cursor visibility is true, changes cursor visiblity and sets cursor_visibility to false
@@ -359,6 +501,7 @@
             ch = " ";
           }
         }
+        dirty_rows.assign(rows, true);
 
         return;
       }
@@ -0,0 +1,182 @@
+/*
+* File: ThreadPool.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains a work-stealing thread pool. Every worker owns
+* a queue of tasks, takes new work from the back of its own queue and,
+* once that runs dry, steals from the front of the other workers' queues,
+* so uneven task lengths (a long game next to a short one) still keep
+* every core busy.
+*/
+
+//Redundancy safety check
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+/*
+ThreadPool Class:
+  A fixed set of worker threads, each with its own task queue. Tasks submitted from outside the pool are spread over the
+  queues round robin, tasks submitted by a worker go onto that worker's own queue. Each queue has its own lock, so workers
+  only ever contend when one of them steals.
+*/
+class ThreadPool
+{
+  public:
+    /*
+    Constructor for ThreadPool, starts the workers
+
+    Params: 1 size_t
+    size_t, threads: Number of workers, 0 uses one per hardware thread
+    */
+    ThreadPool(size_t threads=0)
+    {
+      if (threads == 0) threads = std::thread::hardware_concurrency();
+      if (threads == 0) threads = 1;
+      for (size_t i = 0; i < threads; i++) queues.emplace_back(new WorkerQueue);
+      for (size_t i = 0; i < threads; i++) workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+
+    //Destructor, finishes the queued tasks and joins the workers
+    ~ThreadPool()
+    {
+      wait();
+      {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        stopping = true;
+      }
+      wake.notify_all();
+      for (std::thread &worker:workers) worker.join();
+    }
+
+    /*
+    Queues a task to run on one of the workers
+
+    Params: 1 function
+    function, task: The task to run
+
+    Returns: Void
+    */
+    void submit(std::function<void()> task)
+    {
+      pending++;
+      size_t target = current_worker >= 0 && current_pool == this ? size_t(current_worker) : next_queue++ % queues.size();
+      {
+        std::lock_guard<std::mutex> lock(queues[target]->lock);
+        queues[target]->tasks.push_back(std::move(task));
+      }
+      {
+        //Counted under the wake lock so a worker about to sleep can't miss it
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        queued++;
+      }
+      wake.notify_one();
+      return;
+    }
+
+    /*
+    Blocks until every submitted task has finished
+
+    Params: None
+
+    Returns: Void
+    */
+    void wait()
+    {
+      std::unique_lock<std::mutex> lock(wake_mutex);
+      done.wait(lock, [&]{return pending == 0;});
+      return;
+    }
+
+    //Number of workers
+    size_t size() const {return workers.size();}
+
+    //Index of the worker running the calling thread (0 to size()-1), -1 outside the pool
+    static int currentWorker() {return current_worker;}
+
+  private:
+    struct WorkerQueue
+    {
+      std::mutex lock;
+      std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> pending{0}; //Tasks submitted but not finished
+    std::atomic<size_t> next_queue{0}; //Round robin position for tasks submitted from outside the pool
+    size_t queued = 0; //Tasks sitting in a queue, guarded by wake_mutex
+    bool stopping = false;
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    static thread_local int current_worker;
+    static thread_local ThreadPool* current_pool;
+
+    //Takes the newest task from the worker's own queue
+    bool popLocal(size_t index, std::function<void()> &task)
+    {
+      WorkerQueue &queue = *queues[index];
+      std::lock_guard<std::mutex> lock(queue.lock);
+      if (queue.tasks.empty()) return false;
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      return true;
+    }
+
+    //Takes the oldest task from another worker's queue, starting with the next worker along
+    bool steal(size_t index, std::function<void()> &task)
+    {
+      for (size_t offset = 1; offset < queues.size(); offset++) {
+        WorkerQueue &queue = *queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.lock);
+        if (queue.tasks.empty()) continue;
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        return true;
+      }
+      return false;
+    }
+
+    void workerLoop(size_t index)
+    {
+      current_worker = int(index);
+      current_pool = this;
+      std::function<void()> task;
+      while (true) {
+        if (popLocal(index, task) || steal(index, task)) {
+          {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            queued--;
+          }
+          task();
+          task = nullptr;
+          if (--pending == 0) {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            done.notify_all();
+          }
+          continue;
+        }
+
+        //Sleep until a task is queued anywhere
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        wake.wait(lock, [&]{return stopping || queued > 0;});
+        if (stopping && queued == 0) return;
+      }
+    }
+};
+
+thread_local int ThreadPool::current_worker = -1;
+thread_local ThreadPool* ThreadPool::current_pool = nullptr;
+
+#endif
@@ -0,0 +1,269 @@
+/*
+* File: World.hpp
+* Date: 10/19/2026
+*
+* Description:
+* Header file that contains the world mode: WorldState is a game of snake
+* on a board much larger than the screen (up to 65535x65535 cells), stored
+* in a ChunkedGrid so memory follows the cells the snake covers, and
+* Camera picks the part of the world shown on screen, following the head.
+*/
+
+//Redundancy safety check
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include "Board.hpp"
+#include "Random.hpp"
+#include "GameConfig.hpp"
+#include "Engine.hpp"
+#include "Bot.hpp"
+
+using namespace std;
+
+//Largest number of rows or columns of a world
+const int MAX_WORLD_SIDE = 65535;
+
+/*
+WorldState Class:
+  A single snake game with the GameState rules on a world of any size up to MAX_WORLD_SIDE on each side, bordered like the
+  normal board. Powerups are left out. The world never builds a list of its free cells, which would cost as much as a
+  dense board, instead the food is dropped on a random free cell within one screen (the display size of the config) of
+  the head, found by drawing random cells, so it is always close enough to be found on screen.
+*/
+class WorldState
+{
+  public:
+    /*
+    Constructor for WorldState, places the snake in the middle of the world
+
+    Params: 1 GameConfig, 2 integer
+    GameConfig, game_config: The display size, settings and seed of the game
+    int, rows, columns: The size of the world, border included
+
+    Throws invalid_argument if the world is smaller than the board of the display or larger than MAX_WORLD_SIDE
+    */
+    WorldState(const GameConfig& game_config, int rows, int columns) :
+     config(game_config), world_rows(rows), world_columns(columns), occupancy(rows, columns), rng(game_config.seed),
+     game_speed(game_config.initial_speed), self_collision(game_config.self_collision)
+    {
+      if (rows < game_config.rows - BOARD_TOP_ROW || columns < game_config.columns) throw invalid_argument("The world must be at least as large as the screen");
+      if (rows > MAX_WORLD_SIDE || columns > MAX_WORLD_SIDE) throw invalid_argument("The world can be at most " + to_string(MAX_WORLD_SIDE) + " cells on each side");
+      ipair start = {rows / 2, columns / 2};
+      body.pushBack(start);
+      occupancy.set(start);
+    }
+
+    /*
+    Advances the game by one tick: moves the snake, eats and spawns food and checks for collisions.
+    Does nothing once the game is over.
+
+    Params: 1 char
+    char, input: A new direction ('w', 'a', 's', 'd') to turn to before moving, ignored if it would reverse the snake (0 keeps going straight)
+
+    Returns: A StepResult describing what changed
+    */
+    StepResult step(char input=0)
+    {
+      StepResult result;
+      if (!alive) return result;
+      if (input) changeDirection(input);
+
+      ipair head = stepCell(body.front(), direction);
+      if (pending_growth > 0) pending_growth--;
+      else {
+        result.prev_tail = body.popBack();
+        result.tail_moved = true;
+        occupancy.clear(result.prev_tail);
+      }
+      bool head_overlap = occupancy.test(head);
+      body.pushFront(head);
+      occupancy.set(head);
+
+      //Food spawns on the first tick, and retries every tick while it found no room
+      if (food.first == -1) result.food_spawned = spawnFood();
+
+      if (head == food)
+      {
+        result.ate_food = true;
+        score++;
+        pending_growth++;
+        result.food_spawned = spawnFood();
+        if (game_speed > config.max_speed) game_speed = int(game_speed*(float(config.speed_multiplier)/100.0));
+        else game_speed = config.max_speed;
+        result.speed_changed = true;
+      }
+
+      if ((head_overlap && self_collision) || isWall(head))
+      {
+        alive = false;
+        died = true;
+        result.died = true;
+      }
+
+      tick++;
+      return result;
+    }
+
+    /*
+    Changes the direction of the snake, unless the new direction is opposite to the current one
+
+    Params: 1 char
+    char, new_direction: 'w', 'a', 's' or 'd'
+
+    Returns: Void
+    */
+    void changeDirection(char new_direction)
+    {
+      if (new_direction != 'w' && new_direction != 'a' && new_direction != 's' && new_direction != 'd') return;
+      if (isReverseDirection(new_direction, direction)) return;
+      direction = new_direction;
+      return;
+    }
+
+    //Ends the game early (e.g. quit from the pause menu)
+    void end() {alive = false;}
+
+    //Returns true if the cell is on the border of the world
+    bool isWall(ipair cell) const
+    {
+      return cell.first <= 0 || cell.second <= 0 || cell.first >= world_rows - 1 || cell.second >= world_columns - 1;
+    }
+
+    /*
+    Get respective private values (in function name)
+
+    Params: None
+
+    Returns: The respective value
+    */
+    const GameConfig& getConfig() const {return config;}
+    int getRows() const {return world_rows;}
+    int getColumns() const {return world_columns;}
+    const SnakeBody& getBody() const {return body;}
+    char getDirection() const {return direction;}
+    ipair getFood() const {return food;}
+    int getScore() const {return score;}
+    int getSpeed() const {return game_speed;}
+    uint64_t getTick() const {return tick;}
+    bool isAlive() const {return alive;}
+    bool hasDied() const {return died;}
+    const ChunkedGrid& getOccupancy() const {return occupancy;}
+
+    //Returns true if any segment of the snake is on the given cell
+    bool occupies(ipair cell) const {return occupancy.test(cell);}
+
+  private:
+    GameConfig config;
+    int world_rows;
+    int world_columns;
+
+    SnakeBody body; //Front is the head
+    char direction = 'd';
+    int pending_growth = 0;
+    ChunkedGrid occupancy;
+
+    Random rng;
+    ipair food = {-1, -1};
+    int game_speed;
+    bool self_collision;
+    int score = 0;
+    uint64_t tick = 0;
+    bool alive = true;
+    bool died = false;
+
+    //Places the food on a random free cell within one screen of the head, returns false if none was found
+    bool spawnFood()
+    {
+      const ipair head = body.front();
+      //The window is the size of the board on screen, moved inside the world's border
+      int rows = config.rows - BOARD_TOP_ROW - 2, columns = config.columns - 2;
+      int top = min(max(1, head.first - rows / 2), world_rows - 1 - rows);
+      int left = min(max(1, head.second - columns / 2), world_columns - 1 - columns);
+      for (int attempt = 0; attempt < 256; attempt++) {
+        ipair cell = {top + int(rng.range(rows)), left + int(rng.range(columns))};
+        if (occupancy.test(cell) || cell == head) continue;
+        food = cell;
+        return true;
+      }
+      //A window this full gets another try on the next tick
+      food = {-1, -1};
+      return false;
+    }
+};
+
+/*
+Camera Class:
+  Picks the rectangle of the world shown on screen. The head may move freely inside the middle of the view, once it gets
+  closer than a quarter of the view to an edge the camera moves along with it, so the view scrolls by a line at a time
+  while the snake keeps heading for the edge. The view never leaves the world.
+*/
+class Camera
+{
+  public:
+    /*
+    Constructor for Camera
+
+    Params: 2 integer
+    int, rows, columns: The size of the view
+    */
+    Camera(int rows, int columns) : view_rows(rows), view_columns(columns) {};
+
+    /*
+    Moves the view to keep the head away from its edges
+
+    Params: 1 WorldState
+    WorldState, world: The game to follow
+
+    Returns: True if the view moved
+    */
+    bool follow(const WorldState &world)
+    {
+      const ipair head = world.getBody().front();
+      int row_margin = view_rows / 4, column_margin = view_columns / 4;
+      int new_top = top, new_left = left;
+      if (head.first < top + row_margin) new_top = head.first - row_margin;
+      if (head.first > top + view_rows - 1 - row_margin) new_top = head.first - (view_rows - 1 - row_margin);
+      if (head.second < left + column_margin) new_left = head.second - column_margin;
+      if (head.second > left + view_columns - 1 - column_margin) new_left = head.second - (view_columns - 1 - column_margin);
+      new_top = min(max(0, new_top), world.getRows() - view_rows);
+      new_left = min(max(0, new_left), world.getColumns() - view_columns);
+
+      bool moved = new_top != top || new_left != left;
+      top = new_top;
+      left = new_left;
+      return moved;
+    }
+
+    //Centers the view on the head
+    void center(const WorldState &world)
+    {
+      const ipair head = world.getBody().front();
+      top = min(max(0, head.first - view_rows / 2), world.getRows() - view_rows);
+      left = min(max(0, head.second - view_columns / 2), world.getColumns() - view_columns);
+      return;
+    }
+
+    //Returns true if the world cell is inside the view
+    bool contains(ipair cell) const
+    {
+      return cell.first >= top && cell.first < top + view_rows && cell.second >= left && cell.second < left + view_columns;
+    }
+
+    int getTop() const {return top;}
+    int getLeft() const {return left;}
+    int getRows() const {return view_rows;}
+    int getColumns() const {return view_columns;}
+
+  private:
+    int view_rows;
+    int view_columns;
+    int top = 0;
+    int left = 0;
+};
+
+#endif
@@ -0,0 +1,350 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <stdexcept>
+#include "Engine.hpp"
+#include "Arena.hpp"
+#include "ThreadPool.hpp"
+#include "GameBatch.hpp"
+
+using namespace std;
+
+/*
+The ArenaOptions struct holds the command line options of the arena
+*/
+struct ArenaOptions
+{
+  size_t games = 100; //Games per config
+  size_t threads = 0; //0 uses one per hardware thread
+  int rows = 32;
+  int columns = 101;
+  uint64_t seed = 0;
+  bool fixed_seed = false;
+  string bot = "greedy";
+  uint64_t max_ticks = 1000000;
+  vector<pair<string, vector<int>>> sweeps; //Setting name and the values to try
+  string csv_path;
+  uint64_t batch_ticks = 0; //Step a GameBatch for this many ticks instead of playing bot games (0 plays bot games)
+  string batch_rules = "normal";
+  bool help = false;
+};
+
+//Settings that can be swept, in the order they are printed
+const vector<string> SWEEP_SETTINGS = {"initial-speed", "max-speed", "speed-multiplier", "self-collision", "powerups", "powerup-time", "powerup-spawn-time", "slow-mo-increment",
+                                   "food-count", "max-powerups", "powerup-types"};
+
+/*
+Prints the command line options
+
+Params: 1 string
+string, program: The name the program was started with
+
+Returns: Void
+*/
+void printUsage(const string& program)
+{
+  cout << "Usage: " << program << " [options]" << endl;
+  cout << "Plays many headless games at once with a bot and prints score, length and survival statistics." << endl;
+  cout << "  --games N             games per config (default 100)" << endl;
+  cout << "  --threads N           worker threads (default: one per hardware thread)" << endl;
+  cout << "  --rows N --cols N     display size of every game (default 32x101)" << endl;
+  cout << "  --seed N              seed of the first game, game i uses N+i (default: random)" << endl;
+  cout << "  --bot NAME            bot to play with:";
+  for (const string& name:BOT_NAMES) cout << " " << name;
+  cout << " (default greedy)" << endl;
+  cout << "  --max-ticks N         stop a game after N ticks, 0 for no limit (default 1000000)" << endl;
+  cout << "  --sweep SETTING=A,B,.. play every game once per value, repeat to sweep several settings together" << endl;
+  cout << "                        settings:";
+  for (const string& name:SWEEP_SETTINGS) cout << " " << name;
+  cout << endl;
+  cout << "  --csv PATH            write one line per game to PATH" << endl;
+  cout << "  --batch TICKS         instead of bot games, step --games games in one GameBatch for TICKS ticks with random" << endl;
+  cout << "                        turns and print its throughput" << endl;
+  cout << "  --batch-rules RULES   rules of the batch: normal, wrap (walls wrap around) or overlap (no self collision)" << endl;
+  cout << "  --help                show this message" << endl;
+  return;
+}
+
+/*
+Reads the arena's command line options
+
+Params: 1 integer, 1 char* array
+int, argc: Number of arguments
+char*[], argv: The arguments
+
+Returns: The options, throws invalid_argument for unknown options or bad values
+*/
+ArenaOptions parseArenaArguments(int argc, char* argv[])
+{
+  ArenaOptions options;
+
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+
+    //Every option except --help takes a value
+    auto value = [&]() -> string {
+      if (i+1 >= argc) throw invalid_argument("Missing value for " + arg);
+      return argv[++i];
+    };
+    auto toNumber = [&](const string& v) -> long long {
+      size_t used = 0;
+      long long n = -1;
+      try { n = stoll(v, &used); } catch (const exception&) {}
+      if (used != v.size() || n < 0) throw invalid_argument("Expected a non-negative number for " + arg + ", got: " + v);
+      return n;
+    };
+    auto number = [&]() -> long long {return toNumber(value());};
+
+    if (arg == "--games") options.games = number();
+    else if (arg == "--threads") options.threads = number();
+    else if (arg == "--rows") options.rows = number();
+    else if (arg == "--cols") options.columns = number();
+    else if (arg == "--seed") {
+      options.seed = number();
+      options.fixed_seed = true;
+    }
+    else if (arg == "--bot") {
+      options.bot = value();
+      if (find(BOT_NAMES.begin(), BOT_NAMES.end(), options.bot) == BOT_NAMES.end()) throw invalid_argument("Unknown bot: " + options.bot);
+    }
+    else if (arg == "--max-ticks") options.max_ticks = number();
+    else if (arg == "--sweep") {
+      string sweep = value();
+      size_t equals = sweep.find('=');
+      if (equals == string::npos) throw invalid_argument("Expected SETTING=A,B,... for --sweep, got: " + sweep);
+      string setting = sweep.substr(0, equals);
+      if (find(SWEEP_SETTINGS.begin(), SWEEP_SETTINGS.end(), setting) == SWEEP_SETTINGS.end()) throw invalid_argument("Unknown setting: " + setting);
+
+      vector<int> values;
+      size_t start = equals + 1;
+      while (start <= sweep.size()) {
+        size_t comma = sweep.find(',', start);
+        if (comma == string::npos) comma = sweep.size();
+        values.push_back(toNumber(sweep.substr(start, comma - start)));
+        start = comma + 1;
+      }
+      options.sweeps.push_back({setting, values});
+    }
+    else if (arg == "--csv") options.csv_path = value();
+    else if (arg == "--batch") options.batch_ticks = number();
+    else if (arg == "--batch-rules") {
+      options.batch_rules = value();
+      if (options.batch_rules != "normal" && options.batch_rules != "wrap" && options.batch_rules != "overlap") throw invalid_argument("Unknown batch rules: " + options.batch_rules);
+    }
+    else if (arg == "--help" || arg == "-h") options.help = true;
+    else throw invalid_argument("Unknown option: " + arg);
+  }
+
+  //Same minimum as the game itself, so the starting position always fits
+  if (options.rows < 16 || options.columns < 16) throw invalid_argument("Display size must be at least 16x16");
+  if (options.games == 0) throw invalid_argument("--games must be at least 1");
+  return options;
+}
+
+/*
+Applies one setting of a sweep to a config
+
+Params: 1 GameConfig reference, 1 string, 1 integer
+GameConfig, config: The config to change
+string, setting: One of SWEEP_SETTINGS
+int, value: The value to set
+
+Returns: Void
+*/
+void applySetting(GameConfig &config, const string &setting, int value)
+{
+  if (setting == "initial-speed") config.initial_speed = value;
+  else if (setting == "max-speed") config.max_speed = value;
+  else if (setting == "speed-multiplier") config.speed_multiplier = value;
+  else if (setting == "self-collision") config.self_collision = value;
+  else if (setting == "powerups") config.enable_powerups = value;
+  else if (setting == "powerup-time") config.powerup_time = value;
+  else if (setting == "powerup-spawn-time") config.powerup_spawn_time = value;
+  else if (setting == "slow-mo-increment") config.slow_mo_increment = value;
+  else if (setting == "food-count") config.food_count = value > 0 ? value : 1;
+  else if (setting == "max-powerups") config.max_powerups = value;
+  else if (setting == "powerup-types") config.powerup_types = value;
+  return;
+}
+
+/*
+Builds every combination of the swept settings
+
+Params: 1 ArenaOptions
+ArenaOptions, options: The options holding the base display size and the sweeps
+
+Returns: One config per combination, and a label describing it (empty when nothing is swept)
+*/
+vector<pair<GameConfig, string>> buildConfigs(const ArenaOptions &options)
+{
+  GameConfig base;
+  base.rows = options.rows;
+  base.columns = options.columns;
+  vector<pair<GameConfig, string>> configs = {{base, ""}};
+
+  for (const auto &sweep:options.sweeps) {
+    vector<pair<GameConfig, string>> expanded;
+    for (const auto &config:configs) {
+      for (int value:sweep.second) {
+        pair<GameConfig, string> next = config;
+        applySetting(next.first, sweep.first, value);
+        next.second += (next.second.empty() ? "" : " ") + sweep.first + "=" + to_string(value);
+        expanded.push_back(next);
+      }
+    }
+    configs.swap(expanded);
+  }
+  return configs;
+}
+
+//Prints one line of a distribution
+void printDistribution(const string &name, vector<double> samples)
+{
+  Distribution d = summarize(samples);
+  cout << "  " << left << setw(16) << name << right << fixed << setprecision(1)
+       << " mean " << setw(10) << d.mean << "  min " << setw(9) << d.min << "  p10 " << setw(9) << d.p10
+       << "  median " << setw(9) << d.median << "  p90 " << setw(9) << d.p90 << "  max " << setw(9) << d.max << endl;
+  return;
+}
+
+/*
+Steps a batch of games in lockstep with random turns and prints how fast it went, which measures the training
+environment rather than a bot
+
+Params: 1 ArenaOptions, 1 uint64_t
+ArenaOptions, options: The display size, the number of games and the number of ticks to step
+uint64_t, seed: Seed of the first game and of the turns
+
+Returns: Void, throws invalid_argument if the board doesn't suit a GameBatch
+*/
+template <class Walls, class Collision>
+void runBatch(const ArenaOptions &options, uint64_t seed)
+{
+  GameConfig config;
+  config.rows = options.rows;
+  config.columns = options.columns;
+  config.seed = seed;
+  BasicGameBatch<Walls, Collision> batch(config, options.games);
+
+  vector<char> actions(batch.size());
+  vector<float> rewards(batch.size());
+  vector<uint8_t> done(batch.size());
+  Random rng(seed);
+  uint64_t ended = 0;
+  double total_reward = 0;
+
+  auto start = chrono::steady_clock::now();
+  for (uint64_t tick = 0; tick < options.batch_ticks; tick++) {
+    //Every game turns a random way about one tick in four
+    for (char &action:actions) action = rng.range(4) == 0 ? DIRECTION_KEYS[rng.range(4)] : 0;
+    batch.step(actions.data(), rewards.data(), done.data());
+    for (size_t i = 0; i < batch.size(); i++) {
+      ended += done[i];
+      total_reward += rewards[i];
+    }
+  }
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  uint64_t game_ticks = options.batch_ticks * batch.size();
+  cout << batch.size() << " games (" << options.batch_rules << " rules), " << game_ticks << " ticks in " << setprecision(3) << seconds << "s ("
+       << uint64_t(seconds > 0 ? game_ticks / seconds : 0) << " ticks/s), " << ended << " games ended, total reward " << int64_t(total_reward)
+       << ", first seed " << seed << endl;
+  return;
+}
+
+int main(int argc, char* argv[])
+{
+  ArenaOptions options;
+  try {
+    options = parseArenaArguments(argc, argv);
+  } catch (const invalid_argument &e) {
+    cerr << e.what() << endl;
+    printUsage(argv[0]);
+    return 1;
+  }
+  if (options.help) {
+    printUsage(argv[0]);
+    return 0;
+  }
+
+  //Every config plays the same seeds, so differences between configs aren't down to luck of the draw
+  uint64_t base_seed = options.fixed_seed ? options.seed : randomSeed();
+
+  if (options.batch_ticks > 0) {
+    try {
+      if (options.batch_rules == "wrap") runBatch<WrapWalls, SelfCollision>(options, base_seed);
+      else if (options.batch_rules == "overlap") runBatch<SolidWalls, NoSelfCollision>(options, base_seed);
+      else runBatch<SolidWalls, SelfCollision>(options, base_seed);
+    } catch (const invalid_argument &e) {
+      cerr << e.what() << endl;
+      return 1;
+    }
+    return 0;
+  }
+  vector<pair<GameConfig, string>> configs = buildConfigs(options);
+  vector<ArenaResult> results(configs.size() * options.games);
+
+  ThreadPool pool(options.threads);
+  //One bot per worker, so bots can keep their buffers without locking
+  vector<unique_ptr<Bot>> bots;
+  for (size_t i = 0; i < pool.size(); i++) bots.push_back(makeBot(options.bot));
+
+  auto start = chrono::steady_clock::now();
+  for (size_t c = 0; c < configs.size(); c++) {
+    for (size_t g = 0; g < options.games; g++) {
+      //Every task writes only its own slot of results, nothing is shared between games
+      pool.submit([&, c, g]() {
+        GameConfig config = configs[c].first;
+        config.seed = base_seed + g;
+        ArenaResult &result = results[c * options.games + g];
+        result = runArenaGame(config, *bots[ThreadPool::currentWorker()], options.max_ticks);
+        result.config_index = c;
+      });
+    }
+  }
+  pool.wait();
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  uint64_t total_ticks = 0;
+  for (size_t c = 0; c < configs.size(); c++) {
+    vector<double> scores, lengths, ticks, game_seconds;
+    size_t won = 0, timed_out = 0;
+    for (size_t g = 0; g < options.games; g++) {
+      const ArenaResult &result = results[c * options.games + g];
+      scores.push_back(result.score);
+      lengths.push_back(result.length);
+      ticks.push_back(result.ticks);
+      game_seconds.push_back(result.game_time / 1000.0);
+      won += result.won;
+      timed_out += result.timed_out;
+      total_ticks += result.ticks;
+    }
+
+    cout << "config " << c+1 << "/" << configs.size() << (configs[c].second.empty() ? "" : ": " + configs[c].second) << endl;
+    cout << "  games " << options.games << "  won " << won << "  timed out " << timed_out << endl;
+    printDistribution("score", scores);
+    printDistribution("length", lengths);
+    printDistribution("survival ticks", ticks);
+    printDistribution("survival secs", game_seconds);
+  }
+
+  cout << defaultfloat << results.size() << " games, " << total_ticks << " ticks in " << setprecision(3) << seconds << "s ("
+       << uint64_t(total_ticks / seconds) << " ticks/s) on " << pool.size() << " threads, first seed " << base_seed << endl;
+
+  if (!options.csv_path.empty()) {
+    ofstream csv(options.csv_path);
+    if (!csv) {
+      cerr << "Could not write " << options.csv_path << endl;
+      return 1;
+    }
+    csv << "config,settings,seed,score,length,ticks,game_ms,won,timed_out" << endl;
+    for (const ArenaResult &result:results) {
+      csv << result.config_index+1 << "," << configs[result.config_index].second << "," << result.seed << "," << result.score << ","
+          << result.length << "," << result.ticks << "," << result.game_time << "," << result.won << "," << result.timed_out << endl;
+    }
+  }
+  return 0;
+}
@@ -4,73 +4,557 @@
 #include <stdlib.h>
 #include "TControl.hpp"
 #include "GameCode.hpp"
+#include "Settings.hpp"
 
 using namespace std;
 using ipair = pair<int, int>; //Type alias for integer pairs
 using pvector = vector<pair<int, int>>; //Type alias for vectors containing integer pairs
 
-int main()
+/*
+Trims a terminal size down to the usable display size
+
+Params: 1 pair
+ipair, term_size: The size of the terminal (rows, columns)
+
+Returns: The display size
+*/
+ipair fitScreenSize(ipair term_size)
+{
+  //Trim off the unusable but represented top row of the screen space
+  term_size.first--;
+
+  //Gets the closest screensize to the selected that is odd
+  //Used because only odd screen dimensions have a true "center character"
+  if (term_size.first%2 == 0) term_size.first--;
+  if (term_size.second%2 == 0) term_size.second--;
+  return term_size;
+}
+
+/*
+Plays a single game that is ready to start (or to carry on from where it was saved), then records its outcome and
+shows how it ended
+
+Params: 1 Terminal reference, 1 GameState, 2 ReplayLog pointers, 1 GhostSnake pointer
+Terminal, t: The active terminal
+GameState, game: The game to play
+ReplayLog*, recording: Receives the inputs of the game (may be null)
+const ReplayLog*, playback: A replay to play back instead of reading the keyboard (optional)
+GhostSnake*, ghost: A recorded game to race alongside (optional)
+
+Returns: True if the game was won by filling the whole board
+*/
+bool finishGame(Terminal &t, GameState &game, ReplayLog *recording, const ReplayLog *playback, GhostSnake *ghost=nullptr)
+{
+  //Replays, games a bot steered and headless runs aren't the player's own play, they don't count towards the highest score
+  //(the scoreboard gets a copy of it to raise instead) and never rewrite the settings file
+  const bool counts = !playback && !HEADLESS && AUTOPILOT_BOT.empty();
+  int session_high_score = HIGHEST_SCORE;
+  ScoreBoard sb(t, counts ? HIGHEST_SCORE : session_high_score);
+
+  //The last seconds are kept to rewind during the game and to watch again once it is over
+  unique_ptr<RewindBuffer> rewind;
+  if (!HEADLESS && REWIND_SECONDS > 0) rewind.reset(new RewindBuffer(REWIND_BUFFER_BYTES, uint64_t(REWIND_SECONDS) * 1000));
+
+  if (!HEADLESS) t.clearGrid();
+  bool won = playGame(game, t, sb, recording, playback, rewind.get(), ghost);
+
+  //Keep the highest score across launches
+  if (counts)
+  {
+    if (game.getScore() > HIGHEST_SCORE) HIGHEST_SCORE = game.getScore();
+    saveSettings();
+  }
+  //Replays don't get recorded again
+  if (!playback)
+  {
+    if (recording && !RECORD_PATH.empty() && !saveReplay(RECORD_PATH, *recording)) cerr << "Could not write replay to " << RECORD_PATH << endl;
+  }
+  if (won && !HEADLESS) winMenu(t, game.getScore());
+  if (game.hasDied() && !HEADLESS) {
+    //How much room the snake had left when it crashed
+    FloodFill flood;
+    size_t space = flood.spaceRemaining(game);
+    while (gameOverMenu(t, game.getScore(), space, game.getFreeCells().size() + game.getItems().size(), rewind && !rewind->empty())) playPostMortem(game, *rewind, t, sb);
+  }
+  return won;
+}
+
+/*
+Sets up a new game and scoreboard and plays a single game, on the level of LEVEL_PACK_PATH (or the replay's level) if there is one
+
+Params: 1 Terminal reference, 1 pair, 1 bool reference, 2 ReplayLog pointers
+Terminal, t: The active terminal
+ipair, screen_size: The display size
+bool, won: Set to true if the game was won by filling the whole board
+const ReplayLog*, playback: A replay to play back instead of reading the keyboard (optional)
+ReplayLog*, result: Receives the log of the game that was played (optional)
+
+Returns: The final score of the game, -1 if its level could not be loaded
+*/
+int runGame(Terminal &t, ipair screen_size, bool &won, const ReplayLog *playback=nullptr, ReplayLog *result=nullptr)
+{
+  //Replays run with the recorded settings, new games with the current settings and a seed from the command line or a fresh one
+  ReplayLog recording;
+  if (playback) recording.config = playback->config;
+  else recording.config = captureConfig(screen_size, FIXED_SEED ? GAME_SEED : randomSeed());
+
+  //The board of a level is the size of the level
+  Level level;
+  if (!recording.config.level_path.empty()) {
+    try {
+      level = openLevel(recording.config.level_path, recording.config.level_index);
+      if (playback && level.getChecksum() != recording.config.level_checksum) throw runtime_error("The level changed since the replay was recorded");
+      recording.config.rows = level.getRows() + BOARD_TOP_ROW;
+      recording.config.columns = level.getColumns();
+      recording.config.level_checksum = level.getChecksum();
+      if (recording.config.rows > screen_size.first || recording.config.columns > screen_size.second) {
+        throw runtime_error("The level needs a " + to_string(recording.config.rows) + "x" + to_string(recording.config.columns) + " display");
+      }
+    } catch (const runtime_error &e) {
+      if (HEADLESS) cerr << e.what() << endl;
+      else messageMenu(t, {"COULD NOT LOAD THE LEVEL", e.what()});
+      return -1;
+    }
+  }
+
+  GameState game(recording.config, level);
+  won = finishGame(t, game, &recording, playback);
+  if (result) *result = recording;
+  return game.getScore();
+}
+
+/*
+Picks up the game left in SAVE_PATH with SAVE AND QUIT and plays it to the end. The save is used up once the game is
+running again, a game that is saved again on the way writes a fresh one.
+
+Params: 1 Terminal reference, 1 pair, 1 bool reference
+Terminal, t: The active terminal
+ipair, screen_size: The display size
+bool, won: Set to true if the game was won by filling the whole board
+
+Returns: The final score of the game, -1 if there was no saved game to resume
+*/
+int runSavedGame(Terminal &t, ipair screen_size, bool &won)
+{
+  unique_ptr<GameState> game;
+  try {
+    game.reset(new GameState(loadGame(SAVE_PATH)));
+    const GameConfig &config = game->getConfig();
+    if (!HEADLESS && (config.rows > screen_size.first || config.columns > screen_size.second)) {
+      throw runtime_error("The saved game needs a " + to_string(config.rows) + "x" + to_string(config.columns) + " display");
+    }
+  } catch (const runtime_error &e) {
+    if (HEADLESS) cerr << e.what() << endl;
+    else messageMenu(t, {"COULD NOT RESUME THE SAVED GAME", e.what()});
+    return -1;
+  }
+  unlink(SAVE_PATH.c_str());
+
+  //The replay of a resumed game would have to start where the saved game started, so it isn't recorded
+  won = finishGame(t, *game, nullptr, nullptr);
+  return game->getScore();
+}
+
+/*
+Plays a ghost race: a game on the seed, settings and level of a replay, with the recorded game racing alongside as a
+ghost, then shows who finished ahead. The race is recorded like any other game, so a better run can be raced next.
+
+Params: 1 Terminal reference, 1 pair, 1 bool reference, 1 string
+Terminal, t: The active terminal
+ipair, screen_size: The display size
+bool, won: Set to true if the game was won by filling the whole board
+string, path: The replay to race
+
+Returns: The final score of the game, -1 if the race couldn't start
+*/
+int runGhostRace(Terminal &t, ipair screen_size, bool &won, const string &path)
+{
+  unique_ptr<ReplayStream> stream;
+  Level level;
+  try {
+    stream.reset(new ReplayStream(path));
+    const GameConfig &config = stream->getConfig();
+    if (!config.level_path.empty()) {
+      level = openLevel(config.level_path, config.level_index);
+      if (level.getChecksum() != config.level_checksum) throw runtime_error("The level changed since the replay was recorded");
+    }
+    if (!HEADLESS && (config.rows > screen_size.first || config.columns > screen_size.second)) {
+      throw runtime_error("The replay needs a " + to_string(config.rows) + "x" + to_string(config.columns) + " display");
+    }
+  } catch (const runtime_error &e) {
+    if (HEADLESS) cerr << e.what() << endl;
+    else messageMenu(t, {"COULD NOT START THE GHOST RACE", e.what()});
+    return -1;
+  }
+
+  ReplayLog recording;
+  recording.config = stream->getConfig();
+  GameState game(recording.config, level);
+  GhostSnake ghost(t, *stream, level);
+  won = finishGame(t, game, &recording, nullptr, &ghost);
+
+  //The ghost's score is the one its game ended with, however far the race got
+  const int ghost_score = stream->getScore();
+  if (HEADLESS) cout << "score " << game.getScore() << (won ? " won" : "") << " ghost " << ghost_score << endl;
+  else {
+    string outcome = game.getScore() > ghost_score ? "YOU BEAT THE GHOST" : game.getScore() == ghost_score ? "YOU TIED WITH THE GHOST" : "THE GHOST WINS";
+    messageMenu(t, {outcome, "YOUR SCORE: " + to_string(game.getScore()), "GHOST SCORE: " + to_string(ghost_score)});
+  }
+  return game.getScore();
+}
+
+/*
+Sets up and plays a single multi-snake game with MULTI_PLAYERS players and MULTI_BOTS bots, then shows who won
+
+Params: 1 Terminal reference, 1 pair
+Terminal, t: The active terminal
+ipair, screen_size: The display size
+
+Returns: Void
+*/
+void runMultiGame(Terminal &t, ipair screen_size)
+{
+  GameConfig config = captureConfig(screen_size, FIXED_SEED ? GAME_SEED : randomSeed());
+  unique_ptr<MultiGameState> game;
+  try {
+    game.reset(new MultiGameState(config, MULTI_PLAYERS + MULTI_BOTS));
+  } catch (const invalid_argument &e) {
+    if (HEADLESS) cerr << e.what() << endl;
+    else messageMenu(t, {"COULD NOT START THE GAME", e.what()});
+    return;
+  }
+
+  if (!HEADLESS) t.clearGrid();
+  playMultiGame(*game, t, MULTI_PLAYERS);
+
+  //The last snake standing wins
+  int winner = -1;
+  if (game->getAliveCount() == 1) {
+    for (size_t i = 0; i < game->getSnakeCount(); i++) if (game->isAlive(i)) winner = i;
+  }
+  if (HEADLESS) {
+    cout << "ticks " << game->getTick() << " snakes left " << game->getAliveCount();
+    if (winner >= 0) cout << " winner " << winner << " score " << game->getScore(winner);
+    cout << endl;
+    return;
+  }
+
+  vector<string> text = {"GAME OVER"};
+  if (winner >= 0 && winner < MULTI_PLAYERS) text[0] = "PLAYER " + to_string(winner + 1) + " WINS!";
+  else if (winner >= 0) text[0] = "A BOT WINS";
+  else if (game->getAliveCount() == 0) text[0] = "NO SNAKE SURVIVED";
+  for (int i = 0; i < MULTI_PLAYERS; i++) text.push_back("PLAYER " + to_string(i + 1) + " SCORE: " + to_string(game->getScore(i)));
+  messageMenu(t, text);
+  return;
+}
+
+/*
+Hosts or joins a networked multi-snake game on NET_ADDRESS, plays it, then shows who won. The host plays with NET_PLAYERS
+players, MULTI_BOTS bots, INPUT_DELAY ticks of input delay and its own settings, players who join take the host's.
+
+Params: 1 Terminal reference, 1 pair, 1 bool
+Terminal, t: The active terminal
+ipair, screen_size: The display size
+bool, hosting: Host the game instead of joining it
+
+Returns: Void
+*/
+void runNetGame(Terminal &t, ipair screen_size, bool hosting)
 {
+  //Waiting for the others can be given up with the pause key
+  auto cancelled = [&]() {
+    if (HEADLESS) return false;
+    string keys = getInputs();
+    return keys.find(PAUSE_KEY) != string::npos;
+  };
+
+  unique_ptr<LockstepSession> session;
+  try {
+    if (!HEADLESS) {
+      Menu m({hosting ? "WAITING FOR " + to_string(NET_PLAYERS - 1) + " MORE PLAYER" + (NET_PLAYERS > 2 ? "S" : "") : "WAITING FOR THE HOST", NET_ADDRESS},
+             {"PRESS '" + string(1, PAUSE_KEY) + "' TO GIVE UP"}, t);
+      t.clearGrid();
+      m.updateTerminal();
+      t.draw();
+    }
+    if (hosting) {
+      GameConfig config = captureConfig(screen_size, FIXED_SEED ? GAME_SEED : randomSeed());
+      session = LockstepSession::host(NET_ADDRESS, config, NET_PLAYERS, MULTI_BOTS, INPUT_DELAY, cancelled);
+    } else {
+      session = LockstepSession::join(NET_ADDRESS, cancelled);
+      const GameConfig &config = session->getConfig();
+      if (config.rows > screen_size.first || config.columns > screen_size.second) {
+        session->leave();
+        throw runtime_error("The game needs a " + to_string(config.rows) + "x" + to_string(config.columns) + " display");
+      }
+    }
+  } catch (const exception &e) {
+    if (HEADLESS) cerr << e.what() << endl;
+    else messageMenu(t, {"COULD NOT START THE GAME", e.what()});
+    return;
+  }
+  if (!session) return;
+
+  if (!HEADLESS) t.clearGrid();
+  playNetGame(*session, t);
+  bool lost_connection = !session->isFinished() && session->hasLostHost();
+  uint64_t desync_tick = session->getDesyncTick();
+  session->leave();
+
+  //Every player ends on the same confirmed tick, so they all see the same result
+  const MultiGameState &game = session->getConfirmedState();
+  int winner = -1;
+  if (game.getAliveCount() == 1) {
+    for (size_t i = 0; i < game.getSnakeCount(); i++) if (game.isAlive(i)) winner = i;
+  }
+  if (HEADLESS) {
+    cout << "ticks " << game.getTick() << " snakes left " << game.getAliveCount() << " scores";
+    for (size_t i = 0; i < game.getSnakeCount(); i++) cout << " " << game.getScore(i);
+    if (winner >= 0) cout << " winner " << winner;
+    cout << " rollbacks " << session->getRollbacks() << " bytes per tick " << (session->getBytesSent() + session->getBytesReceived()) / max<uint64_t>(session->getTick(), 1);
+    if (desync_tick) cout << " DESYNC at tick " << desync_tick;
+    cout << (lost_connection ? " DISCONNECTED" : "") << endl;
+    return;
+  }
+
+  vector<string> text = {"GAME OVER"};
+  if (desync_tick) text[0] = "THE GAMES WENT OUT OF STEP AT TICK " + to_string(desync_tick);
+  else if (lost_connection) text[0] = "LOST THE CONNECTION TO THE HOST";
+  else if (winner >= 0 && size_t(winner) == session->getLocalPlayer()) text[0] = "YOU WIN!";
+  else if (winner >= 0 && size_t(winner) < session->getPlayerCount()) text[0] = "PLAYER " + to_string(winner + 1) + " WINS!";
+  else if (winner >= 0) text[0] = "A BOT WINS";
+  else if (game.getAliveCount() == 0) text[0] = "NO SNAKE SURVIVED";
+  for (size_t i = 0; i < session->getPlayerCount(); i++) {
+    text.push_back("PLAYER " + to_string(i + 1) + (i == session->getLocalPlayer() ? " (YOU)" : "") + " SCORE: " + to_string(game.getScore(i)));
+  }
+  messageMenu(t, text);
+  return;
+}
+
+/*
+Sets up and plays a single game in world mode on a WORLD_ROWS x WORLD_COLUMNS world (grown to the board size if smaller)
+
+Params: 1 Terminal reference, 1 pair
+Terminal, t: The active terminal
+ipair, screen_size: The display size
+
+Returns: The final score of the game
+*/
+int runWorldGame(Terminal &t, ipair screen_size)
+{
+  GameConfig config = captureConfig(screen_size, FIXED_SEED ? GAME_SEED : randomSeed());
+  WorldState world(config, max(WORLD_ROWS, config.rows - BOARD_TOP_ROW), max(WORLD_COLUMNS, config.columns));
+  int high_score = 0; //World games keep their own scoreboard, they don't count towards the highest score
+  ScoreBoard sb(t, high_score);
+
+  if (!HEADLESS) t.clearGrid();
+  playWorldGame(world, t, sb);
+
+  if (HEADLESS) {
+    cout << "score " << world.getScore() << " ticks " << world.getTick() << " chunks " << world.getOccupancy().getChunkCount() << endl;
+  } else if (world.hasDied()) {
+    messageMenu(t, {"GAME OVER", "FINAL SCORE: " + to_string(world.getScore()),
+                    "WORLD SIZE: " + to_string(world.getRows()) + "x" + to_string(world.getColumns())});
+  }
+  return world.getScore();
+}
+
+//Prints the frame timings of the session to stderr, registered with atexit so it runs however the program ends
+void printFrameProfile()
+{
+  FRAME_PROFILE.printSummary(cerr);
+  return;
+}
+
+int main(int argc, char* argv[])
+{
+  LaunchOptions options;
+  try {
+    options = parseArguments(argc, argv);
+  } catch (const invalid_argument &e) {
+    cerr << e.what() << endl;
+    printUsage(argv[0]);
+    return 1;
+  }
+  if (options.help) {
+    printUsage(argv[0]);
+    return 0;
+  }
+  if (PROFILE) atexit(printFrameProfile);
+
+  //Compiling a level pack only writes the pack, then exits
+  if (!options.level_source.empty()) {
+    vector<uint8_t> text, pack;
+    if (!readFile(options.level_source, text)) {
+      cerr << "Could not read " << options.level_source << endl;
+      return 1;
+    }
+    try {
+      pack = compileLevelPack(string(text.begin(), text.end()));
+    } catch (const invalid_argument &e) {
+      cerr << options.level_source << ": " << e.what() << endl;
+      return 1;
+    }
+    if (!atomicWriteFile(LEVEL_PACK_PATH, pack)) {
+      cerr << "Could not write " << LEVEL_PACK_PATH << endl;
+      return 1;
+    }
+    cout << "Level pack written to " << LEVEL_PACK_PATH << " (" << pack.size() << " bytes)" << endl;
+    return 0;
+  }
+
+  //Restore the settings, style presets and highest score from the last launch
+  loadSettings();
+  HEADLESS = options.headless;
+
+  //Playing back a replay runs the recorded game with the recorded settings, then exits
+  if (!options.replay_path.empty()) {
+    ReplayLog replay;
+    try {
+      replay = loadReplay(options.replay_path);
+    } catch (const runtime_error &e) {
+      cerr << e.what() << endl;
+      return 1;
+    }
+    ipair screen_size = {replay.config.rows, replay.config.columns};
+    Terminal t(screen_size.first, screen_size.second);
+
+    if (HEADLESS) {
+      //Re-simulate as fast as possible and check the outcome matches the recording
+      t.setOutputEnabled(false);
+      bool won = false;
+      ReplayLog result;
+      int score = runGame(t, screen_size, won, &replay, &result);
+      if (score < 0) return 1;
+      bool verified = result.sameOutcome(replay);
+      cout << "score " << score << " ticks " << result.ticks;
+      if (verified) cout << " verified" << endl;
+      else if (result.firstDivergence(replay)) cout << " DIVERGED at tick " << result.firstDivergence(replay) << endl;
+      else cout << " DIVERGED" << endl;
+      return verified ? 0 : 2;
+    }
+
+    enableRawMode();
+    clear();
+    t.setCursorVisibility(false);
+    bool won = false;
+    runGame(t, screen_size, won, &replay);
+    t.setCursorVisibility(true);
+    return 0;
+  }
+
+  //Headless runs never touch the console, they play a single game and print the result
+  if (HEADLESS) {
+    ipair screen_size = fitScreenSize({options.rows ? options.rows : 32, options.columns ? options.columns : 101});
+    //Nothing is shown, so a level gets a display of its own size (a pack that can't be loaded is reported by runGame)
+    if (!LEVEL_PACK_PATH.empty() && (options.mode == "menu" || options.mode == "play")) {
+      try {
+        Level level = openLevel(LEVEL_PACK_PATH, LEVEL_NUMBER);
+        screen_size = {level.getRows() + BOARD_TOP_ROW, level.getColumns()};
+      } catch (const runtime_error &e) {}
+    }
+    Terminal t(screen_size.first, screen_size.second);
+    t.setOutputEnabled(false);
+    if (options.mode == "multi") {
+      runMultiGame(t, screen_size);
+      return 0;
+    }
+    if (options.mode == "world") {
+      runWorldGame(t, screen_size);
+      return 0;
+    }
+    if (options.mode == "host" || options.mode == "join") {
+      runNetGame(t, screen_size, options.mode == "host");
+      return 0;
+    }
+    bool won = false;
+    if (options.mode == "ghost") return runGhostRace(t, screen_size, won, options.ghost_path) < 0;
+    if (options.mode == "resume") {
+      int score = runSavedGame(t, screen_size, won);
+      if (score < 0) return 1;
+      cout << "score " << score << (won ? " won" : "") << endl;
+      return 0;
+    }
+    int score = runGame(t, screen_size, won);
+    if (score < 0) return 1;
+    cout << "score " << score << (won ? " won" : "") << endl;
+    return 0;
+  }
+
   //Enable raw mode & clear
   enableRawMode();
   clear();
 
-  //Input loop for confirming what display size the user wants
-  //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
   ipair screen_size;
-  while(true) {
-    clear();
-    static char input;
-
-    //Simple printout instructing user
-    cout << "Adjust window to desired size and press any key to continue (Minimum 16x75)" << endl;
-    //A "press any key to continue" break
-    cin.ignore();
-
-    //Reassign screen_size to current screen size
-    screen_size = getTermSize();
-    while(screen_size.first < 16 || screen_size.second < 75){
+  //A display size from the command line (or play mode) skips the size confirmation
+  if ((options.rows && options.columns) || options.mode != "menu") {
+    ipair term_size = getTermSize();
+    if (options.rows) term_size.first = options.rows;
+    if (options.columns) term_size.second = options.columns;
+    screen_size = fitScreenSize(term_size);
+  } else {
+    //Input loop for confirming what display size the user wants
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+    while(true) {
       clear();
-      cout << "Please readjust your screen size to be at least 16x75 (currently is: " << screen_size.first << "x" << screen_size.second << ")" << endl;
+      static char input;
+
+      //Simple printout instructing user
       cout << "Adjust window to desired size and press any key to continue (Minimum 16x75)" << endl;
       //A "press any key to continue" break
       cin.ignore();
-      screen_size = getTermSize();
-    }
-    /*
-    while(screen_size.first < 24 || screen_size.second < 80){
-      cout << "Please make sure your screen dimensions are at least 24x80. (Current screen size: " << screen_size.first << "x" << screen_size.second << ")" << endl;
-      cout << "Adjust window to desired size and press any key to continue (Minumum 24x80)" << endl;
-      cin.ignore();
-      screen_size = getTermSize();
-    }
-    */
 
-    //Trim off the unusable but represented top row of the screen space
-    screen_size.first--;
+      //Reassign screen_size to current screen size
+      screen_size = getTermSize();
+      while(screen_size.first < 16 || screen_size.second < 75){
+        clear();
+        cout << "Please readjust your screen size to be at least 16x75 (currently is: " << screen_size.first << "x" << screen_size.second << ")" << endl;
+        cout << "Adjust window to desired size and press any key to continue (Minimum 16x75)" << endl;
+        //A "press any key to continue" break
+        cin.ignore();
+        screen_size = getTermSize();
+      }
+      /*
+      while(screen_size.first < 24 || screen_size.second < 80){
+        cout << "Please make sure your screen dimensions are at least 24x80. (Current screen size: " << screen_size.first << "x" << screen_size.second << ")" << endl;
+        cout << "Adjust window to desired size and press any key to continue (Minumum 24x80)" << endl;
+        cin.ignore();
+        screen_size = getTermSize();
+      }
+      */
 
-    //Gets the closest screensize to the selected that is odd
-    //Used because only odd screen dimensions have a true "center character"
-    if (screen_size.first%2 == 0) screen_size.first--;
-    if (screen_size.second%2 == 0) screen_size.second--;
+      screen_size = fitScreenSize(screen_size);
 
-    //Prompts the user to confirm the current display dimensions
-    cout << "Enter y/Y to confirm display size: " << screen_size.first << "x" << screen_size.second << endl;
-    cin >> input;
-    //Break user-dimension input loop with current screen dimensions set
-    if (input=='y'||input=='Y') break;
+      //Prompts the user to confirm the current display dimensions
+      cout << "Enter y/Y to confirm display size: " << screen_size.first << "x" << screen_size.second << endl;
+      cin >> input;
+      //Break user-dimension input loop with current screen dimensions set
+      if (input=='y'||input=='Y') break;
+    }
+    //End of window size confirmation loop
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
   }
-  //End of window size confirmation loop
-  //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
 
   Terminal t(screen_size.first, screen_size.second); //Initalize a terminal instance
   t.setCursorVisibility(false); //Disable cursor visibility
 
+  //Play, multi, world, networked and resumed games launch straight into a game, the main menu shows once it is over
+  bool won = false;
+  if (options.mode == "play") runGame(t, screen_size, won);
+  else if (options.mode == "resume") runSavedGame(t, screen_size, won);
+  else if (options.mode == "ghost") runGhostRace(t, screen_size, won, options.ghost_path);
+  else if (options.mode == "multi") runMultiGame(t, screen_size);
+  else if (options.mode == "world") runWorldGame(t, screen_size);
+  else if (options.mode == "host" || options.mode == "join") runNetGame(t, screen_size, options.mode == "host");
+
   vector<string> menu_text = {"", "NAVIGATE UP & DOWN WITH 'w' & 's'", "PRESS ENTER TO SELECT AN OPTION"}; //Main menu header
-  vector<string> menu_options = {"PLAY", "SETTINGS", "EXIT"}; //Main menu options
 
   while(true){
     if (HIGHEST_SCORE>0) menu_text[0]= ("HIGHEST SCORE: "+to_string(HIGHEST_SCORE)); //Show highscore banner if there is a highscore
+    vector<string> menu_options = {"PLAY", "MULTIPLAYER", "WORLD", "SETTINGS", "EXIT"}; //Main menu options
+    //A game left with SAVE AND QUIT can be picked up again from the top of the menu, the other options move down one
+    const bool saved_game = hasSavedGame(SAVE_PATH);
+    if (saved_game) menu_options.insert(menu_options.begin(), "RESUME SAVED GAME");
     Menu m(menu_text, menu_options, t); //Initialize main menu
 
     bool force_run = true; //forces the menu to render once
@@ -85,7 +569,7 @@ int main()
         t.draw();
         force_run=false;
       }
-  
+
     //Cursor navigation
     switch (getInput()) {
       case 'w': //cursor up
@@ -99,33 +583,35 @@ int main()
         t.draw();
         break;
       case '\n': //chosen option
-        user_decision = m.getSelection(); //Assigned with users chosen option here
+        user_decision = m.getSelection() - saved_game; //Assigned with users chosen option here, 0 resumes the saved game
         menu_active = false; //Exits the main menu loop
         break;
       }
     }
 
-    //Snake initial setup 
-    ipair boundary = setBoundary(screen_size);
-    int startX = rand() % (boundary.first - 8) + 5;
-    int startY = rand() % (boundary.second - 8) + 5;
-    char startDirection = 'd';
-    Snake snake(t, boundary, startX, startY, startDirection);
-    ScoreBoard sb(t, HIGHEST_SCORE);
-
     //Menu user_decision outcome switch
     switch (user_decision)
     {
+    case 0: //Resume the saved game
+      runSavedGame(t, screen_size, won);
+      break;
     case 1: //Start game loop
-      t.clearGrid();
-      playGame(snake, t, screen_size, sb);
+      runGame(t, screen_size, won);
+      break;
+    case 2: //Start a multi-snake game
+      runMultiGame(t, screen_size);
+      break;
+    case 3: //Start a game in world mode
+      runWorldGame(t, screen_size);
       break;
-    case 2: //Open settings menu
+    case 4: //Open settings menu
       settingsEditorMenu(t);
+      //Persist whatever was changed in the settings menu
+      saveSettings();
       break;
-    case 3: //Exit the game
+    case 5: //Exit the game
       exit(0);
       break;
     }
   }
-}
\ No newline at end of file
+}